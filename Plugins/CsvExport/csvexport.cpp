@@ -76,6 +76,11 @@ bool CsvExport::exportQueryResultsRow(SqlResultsRowPtr row)
     return true;
 }
 
+bool CsvExport::exportQueryResultsRows(const SqlResultsRowBlock& rows)
+{
+    return exportTableRows(rows);
+}
+
 bool CsvExport::exportTable(const QString& database, const QString& table, const QStringList& columnNames, const QString& ddl, SqliteCreateTablePtr createTable, const QHash<ExportManager::ExportProviderFlag, QVariant> providedData)
 {
     UNUSED(database);
@@ -109,14 +114,30 @@ bool CsvExport::exportTable(const QStringList& columnNames)
 }
 
 bool CsvExport::exportTableRow(SqlResultsRowPtr data)
+{
+    writeln(serializeRow(data));
+    return true;
+}
+
+bool CsvExport::exportTableRows(const SqlResultsRowBlock& rows)
+{
+    // Whole block is written at once, so the output is not encoded and written row by row.
+    QString block;
+    for (const SqlResultsRowPtr& row : rows)
+        block += serializeRow(row) + "\n";
+
+    write(block);
+    return true;
+}
+
+QString CsvExport::serializeRow(SqlResultsRowPtr data)
 {
     QStringList valList;
     QString nl = cfg.CsvExport.NullValueString.get();
-    for (const QVariant& val : data->valueList())
+    for (const QVariant& val : data->valueVector())
         valList << (val.isNull() ? nl : val.toString());
 
-    writeln(CsvSerializer::serialize(valList, format));
-    return true;
+    return CsvSerializer::serialize(valList, format);
 }
 
 bool CsvExport::beforeExportDatabase(const QString& database)
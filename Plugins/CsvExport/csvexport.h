@@ -33,11 +33,13 @@ class CSVEXPORTSHARED_EXPORT CsvExport : public GenericExportPlugin
         bool beforeExportQueryResults(const QString& query, QList<QueryExecutor::ResultColumnPtr>& columns,
                                       const QHash<ExportManager::ExportProviderFlag,QVariant> providedData);
         bool exportQueryResultsRow(SqlResultsRowPtr row);
+        bool exportQueryResultsRows(const SqlResultsRowBlock& rows);
         bool exportTable(const QString& database, const QString& table, const QStringList& columnNames, const QString& ddl, SqliteCreateTablePtr createTable,
                          const QHash<ExportManager::ExportProviderFlag,QVariant> providedData);
         bool exportVirtualTable(const QString& database, const QString& table, const QStringList& columnNames, const QString& ddl, SqliteCreateVirtualTablePtr createTable,
                                 const QHash<ExportManager::ExportProviderFlag,QVariant> providedData);
         bool exportTableRow(SqlResultsRowPtr data);
+        bool exportTableRows(const SqlResultsRowBlock& rows);
         bool beforeExportDatabase(const QString& database);
         bool exportIndex(const QString& database, const QString& name, const QString& ddl, SqliteCreateIndexPtr createIndex);
         bool exportTrigger(const QString& database, const QString& name, const QString& ddl, SqliteCreateTriggerPtr createTrigger);
@@ -48,6 +50,7 @@ class CSVEXPORTSHARED_EXPORT CsvExport : public GenericExportPlugin
     private:
         bool exportTable(const QStringList& columnNames);
         void defineCsvFormat();
+        QString serializeRow(SqlResultsRowPtr data);
 
         CFG_LOCAL(CsvExportConfig, cfg)
         CsvFormat format;
@@ -3,8 +3,9 @@
 #include "sqlitestudio.h"
 #include "services/notifymanager.h"
 #include <QVariant>
-#include <QFile>
-#include <QTextStream>
+#include <QTextCodec>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
 
 CsvImport::CsvImport()
 {
@@ -24,57 +25,118 @@ bool CsvImport::beforeImport(const ImportManager::StandardImportConfig& config)
 {
     defineCsvFormat();
 
-    file = new QFile(config.inputFileName);
-    if (!file->open(QFile::ReadOnly) || !file->isReadable())
+    if (!input.open(config.inputFileName))
     {
         notifyError(tr("Cannot read file %1").arg(config.inputFileName));
-        safe_delete(file);
         return false;
     }
 
-    stream = new QTextStream(file);
-    stream->setCodec(config.codec.toLatin1().data());
+    codec = QTextCodec::codecForName(config.codec.toLatin1());
+    if (!codec)
+        codec = QTextCodec::codecForLocale();
 
+    nullValues = cfg.CsvImport.NullValues.get();
+    nullValueString = cfg.CsvImport.NullValueString.get();
+
+    reader = new CsvReader(csvFormat);
+    resetInput();
     if (!extractColumns())
     {
-        safe_delete(stream);
-        safe_delete(file);
+        afterImport();
         return false;
     }
 
+    if (directInput)
+        parallelParsing = startParallelParsing();
+
     return true;
 }
 
 void CsvImport::afterImport()
 {
-    safe_delete(stream);
-    safe_delete(file);
+    stopParallelParsing();
+    safe_delete(reader);
+    safe_delete(decoder);
+    input.close();
+    buffer.clear();
+    record.clear();
 }
 
-bool CsvImport::extractColumns()
+void CsvImport::resetInput()
+{
+    static const int utf8Mib = 106;
+
+    input.seek(0);
+    buffer.clear();
+    safe_delete(decoder);
+    directInput = false;
+
+    // Byte order mark overrides the codec, just like it does for QTextStream
+    QTextCodec* inputCodec = input.detectCodec(codec);
+    if (inputCodec->mibEnum() != utf8Mib)
+    {
+        decoder = inputCodec->makeDecoder();
+    }
+    else if (input.isMapped())
+    {
+        // UTF-8 file is parsed straight from mapped pages, without copying anything
+        directInput = true;
+        directInputOffset = input.getPosition();
+        reader->setData(input.getMappedData() + directInputOffset, input.getSize() - directInputOffset, true);
+        return;
+    }
+
+    reader->setData(buffer.constData(), 0, false);
+}
+
+void CsvImport::readChunk()
 {
-    QStringList deserializedEntry = CsvSerializer::deserializeOneEntry(*stream, csvFormat);
-    while (deserializedEntry.isEmpty() && !stream->atEnd())
-        deserializedEntry = CsvSerializer::deserializeOneEntry(*stream, csvFormat);
+    QByteArray chunk = input.readChunk();
+    bool lastChunk = chunk.isEmpty() || input.atEnd();
+
+    // Record that was not complete in the previous chunk is kept at the beginning of the buffer
+    buffer = buffer.mid(reader->getPosition());
+    if (decoder)
+        buffer += decoder->toUnicode(chunk).toUtf8();
+    else
+        buffer += chunk;
+
+    reader->setData(buffer.constData(), buffer.size(), lastChunk);
+}
 
-    if (deserializedEntry.isEmpty())
+bool CsvImport::readRecord()
+{
+    while (!reader->readRecord(record))
     {
-        notifyError(tr("Could not find any data in the file %1.").arg(file->fileName()));
+        if (reader->atEnd())
+            return false;
+
+        readChunk();
+    }
+    return true;
+}
+
+bool CsvImport::extractColumns()
+{
+    if (!readRecord())
+    {
+        notifyError(tr("Could not find any data in the file %1.").arg(input.getFileName()));
         return false;
     }
 
+    columnNames.clear();
     if (cfg.CsvImport.FirstRowAsColumns.get())
     {
-        columnNames = deserializedEntry;
+        for (const CsvReader::Field& field : record)
+            columnNames << field.toString();
     }
     else
     {
         static const QString colTmp = QStringLiteral("column%1");
-        columnNames.clear();
-        for (int i = 1, total = deserializedEntry.size(); i <= total; ++i)
+        for (int i = 1, total = record.size(); i <= total; ++i)
             columnNames << colTmp.arg(i);
 
-        stream->seek(0);
+        resetInput();
     }
 
     return true;
@@ -118,18 +180,29 @@ QList<ImportPlugin::ColumnDefinition> CsvImport::getColumns() const
 
 QList<QVariant> CsvImport::next()
 {
-    QStringList deserializedEntry = CsvSerializer::deserializeOneEntry(*stream, csvFormat);
-
     QList<QVariant> values;
-    if (deserializedEntry.isEmpty())
+    if (parallelParsing)
+    {
+        nextParsedRow(values);
         return values;
+    }
 
-    if (cfg.CsvImport.NullValues.get())
+    if (!readRecord())
+        return values;
+
+    return toValues(record);
+}
+
+QList<QVariant> CsvImport::toValues(const CsvReader::Record& record) const
+{
+    QList<QVariant> values;
+    if (nullValues)
     {
-        QString nullVal = cfg.CsvImport.NullValueString.get();
-        for (const QString& val : deserializedEntry)
+        QString val;
+        for (const CsvReader::Field& field : record)
         {
-            if (val == nullVal)
+            val = field.toString();
+            if (val == nullValueString)
                 values << QVariant(QVariant::String);
             else
                 values << val;
@@ -137,13 +210,138 @@ QList<QVariant> CsvImport::next()
     }
     else
     {
-        for (const QString& val : deserializedEntry)
-            values << val;
+        for (const CsvReader::Field& field : record)
+            values << field.toString();
     }
-
     return values;
 }
 
+static qint64 countQuotes(const char* data, qint64 size)
+{
+    return std::count(data, data + size, '"');
+}
+
+bool CsvImport::startParallelParsing()
+{
+    qint64 start = directInputOffset + reader->getPosition();
+    qint64 end = input.getSize();
+    if (end - start < minParallelInputSize || parserThreadPool.maxThreadCount() < 2)
+        return false;
+
+    // Whether any position is within quotes depends only on parity of quotes before it,
+    // so quotes are counted in parallel for each part of the input, before the input is split.
+    const char* data = input.getMappedData();
+    QList<qint64> boundaries;
+    for (qint64 pos = start; pos < end; pos += parseRangeSize)
+        boundaries << pos;
+
+    boundaries << end;
+
+    QList<QFuture<qint64>> quoteCounts;
+    for (int i = 0, total = boundaries.size() - 1; i < total; i++)
+        quoteCounts << QtConcurrent::run(&parserThreadPool, countQuotes, data + boundaries[i], boundaries[i + 1] - boundaries[i]);
+
+    // Each range ends where the first record after the boundary begins
+    bool inQuotes = false;
+    qint64 rangeStart = start;
+    qint64 recordStart;
+    rangesToParse.clear();
+    for (int i = 1, total = boundaries.size() - 1; i < total; i++)
+    {
+        inQuotes ^= (quoteCounts[i - 1].result() % 2) == 1;
+        if (boundaries[i] <= rangeStart)
+            continue;
+
+        recordStart = directInputOffset + reader->findNextRecord(boundaries[i] - directInputOffset, inQuotes);
+        if (recordStart >= end)
+            break;
+
+        rangesToParse << Range(rangeStart, recordStart);
+        rangeStart = recordStart;
+    }
+    rangesToParse << Range(rangeStart, end);
+
+    parsedPosition = start;
+    currentRows.clear();
+    currentRow = 0;
+    scheduleParsing();
+    return true;
+}
+
+void CsvImport::scheduleParsing()
+{
+    // Only few ranges are parsed ahead, so parsed rows don't take more memory than necessary
+    int maxParsedRanges = parserThreadPool.maxThreadCount() * 2;
+    ParsedRange parsedRange;
+    while (parsedRanges.size() < maxParsedRanges && !rangesToParse.isEmpty())
+    {
+        Range range = rangesToParse.takeFirst();
+        parsedRange.end = range.second;
+        parsedRange.rows = QtConcurrent::run(&parserThreadPool, this, &CsvImport::parseRange, range.first, range.second);
+        parsedRanges.enqueue(parsedRange);
+    }
+}
+
+void CsvImport::stopParallelParsing()
+{
+    // Ranges being parsed refer to the mapped file, so they need to finish before the file is closed
+    rangesToParse.clear();
+    for (ParsedRange& parsedRange : parsedRanges)
+        parsedRange.rows.waitForFinished();
+
+    parsedRanges.clear();
+    currentRows.clear();
+    currentRow = 0;
+    parallelParsing = false;
+}
+
+bool CsvImport::nextParsedRow(QList<QVariant>& values)
+{
+    while (currentRow >= currentRows.size())
+    {
+        if (parsedRanges.isEmpty())
+            return false;
+
+        ParsedRange parsedRange = parsedRanges.dequeue();
+        currentRows = parsedRange.rows.result();
+        currentRow = 0;
+        parsedPosition = parsedRange.end;
+        scheduleParsing();
+    }
+
+    values = currentRows[currentRow++];
+    return true;
+}
+
+QList<QList<QVariant>> CsvImport::parseRange(qint64 start, qint64 end) const
+{
+    CsvReader rangeReader(csvFormat);
+    rangeReader.setData(input.getMappedData() + start, end - start, true);
+
+    QList<QList<QVariant>> rows;
+    CsvReader::Record rangeRecord;
+    while (rangeReader.readRecord(rangeRecord))
+        rows << toValues(rangeRecord);
+
+    return rows;
+}
+
+qint64 CsvImport::getInputSize() const
+{
+    return input.getSize();
+}
+
+qint64 CsvImport::getInputPosition() const
+{
+    if (parallelParsing)
+        return parsedPosition;
+
+    if (directInput && reader)
+        return directInputOffset + reader->getPosition();
+
+    return input.getPosition();
+}
+
 CfgMain* CsvImport::getConfig()
 {
     return &cfg;
@@ -5,7 +5,11 @@
 #include "plugins/importplugin.h"
 #include "plugins/genericplugin.h"
 #include "config_builder.h"
-#include "csvserializer.h"
+#include "csvreader.h"
+#include "common/chunkedfilereader.h"
+#include <QThreadPool>
+#include <QFuture>
+#include <QQueue>
 
 CFG_CATEGORIES(CsvImportConfig,
      CFG_CATEGORY(CsvImport,
@@ -17,8 +21,8 @@ CFG_CATEGORIES(CsvImportConfig,
      )
 )
 
-class QFile;
-class QTextStream;
+class QTextCodec;
+class QTextDecoder;
 
 class CSVIMPORTSHARED_EXPORT CsvImport : public GenericPlugin, public ImportPlugin
 {
@@ -34,6 +38,8 @@ class CSVIMPORTSHARED_EXPORT CsvImport : public GenericPlugin, public ImportPlug
         void afterImport();
         QList<ColumnDefinition> getColumns() const;
         QList<QVariant> next();
+        qint64 getInputSize() const;
+        qint64 getInputPosition() const;
         CfgMain* getConfig();
         QString getImportConfigFormName() const;
         bool validateOptions();
@@ -44,12 +50,69 @@ class CSVIMPORTSHARED_EXPORT CsvImport : public GenericPlugin, public ImportPlug
     private:
         bool extractColumns();
         void defineCsvFormat();
+        void resetInput();
+        void readChunk();
+        bool readRecord();
+        QList<QVariant> toValues(const CsvReader::Record& record) const;
+        bool startParallelParsing();
+        void scheduleParsing();
+        void stopParallelParsing();
+        bool nextParsedRow(QList<QVariant>& values);
+        QList<QList<QVariant>> parseRange(qint64 start, qint64 end) const;
 
-        QFile* file = nullptr;
-        QTextStream* stream = nullptr;
+        typedef QPair<qint64,qint64> Range;
+
+        /**
+         * @brief Part of the input parsed in the parser thread pool.
+         */
+        struct ParsedRange
+        {
+            QFuture<QList<QList<QVariant>>> rows;
+            qint64 end = 0;
+        };
+
+        ChunkedFileReader input;
+        QTextCodec* codec = nullptr;
+
+        /**
+         * @brief Decoder converting input to UTF-8 for the reader. It's null if the input is in UTF-8 already.
+         */
+        QTextDecoder* decoder = nullptr;
+        CsvReader* reader = nullptr;
+        QByteArray buffer;
+        CsvReader::Record record;
+
+        /**
+         * @brief True if the reader works directly on the mapped file, without the buffer.
+         */
+        bool directInput = false;
+
+        /**
+         * @brief Position in the file, where the direct input starts.
+         */
+        qint64 directInputOffset = 0;
+
+        /**
+         * @brief True if the input was split into ranges of records, that are parsed in parallel.
+         */
+        bool parallelParsing = false;
+        QThreadPool parserThreadPool;
+        QList<Range> rangesToParse;
+        QQueue<ParsedRange> parsedRanges;
+        QList<QList<QVariant>> currentRows;
+        int currentRow = 0;
+        qint64 parsedPosition = 0;
+        bool nullValues = false;
+        QString nullValueString;
         QStringList columnNames;
         CsvFormat csvFormat;
         CFG_LOCAL(CsvImportConfig, cfg)
+
+        /**
+         * @brief Size of the input, from which it's worth to parse it in parallel.
+         */
+        static const qint64 minParallelInputSize = 16 * 1024 * 1024;
+        static const qint64 parseRangeSize = 4 * 1024 * 1024;
 };
 
 #endif // CSVIMPORT_H
@@ -49,7 +49,7 @@ SqlResultsRowPtr SqlQueryAndroid::nextInternal()
         return SqlResultsRowPtr();
 
     currentRow++;
-    SqlResultRowAndroid* resultRow = new SqlResultRowAndroid(resultDataMap[currentRow], resultDataList[currentRow]);
+    SqlResultRowAndroid* resultRow = new SqlResultRowAndroid(resultColumnIndex, resultDataList[currentRow]);
     return SqlResultsRowPtr(resultRow);
 }
 
@@ -144,7 +144,7 @@ bool SqlQueryAndroid::executeAndHandleResponse(const QString& query)
     }
 
     resultColumns = results.resultColumns;
-    resultDataMap = results.resultDataMap;
+    resultColumnIndex = SqlResultsRow::createColumnIndex(resultColumns);
     resultDataList = results.resultDataList;
     return true;
 }
@@ -152,7 +152,7 @@ bool SqlQueryAndroid::executeAndHandleResponse(const QString& query)
 void SqlQueryAndroid::resetResponse()
 {
     resultColumns.clear();
-    resultDataMap.clear();
+    resultColumnIndex.clear();
     resultDataList.clear();
     currentRow = -1;
     errorCode = 0;
@@ -39,7 +39,7 @@ class SqlQueryAndroid : public SqlQuery
         int errorCode = 0;
         QString errorText;
         QStringList resultColumns;
-        QList<QVariantHash> resultDataMap;
+        SqlResultsRow::ColumnIndex resultColumnIndex;
         QList<QVariantList> resultDataList;
         int currentRow = -1;
 };
@@ -1,9 +1,9 @@
 #include "sqlresultrowandroid.h"
 
-SqlResultRowAndroid::SqlResultRowAndroid(const QVariantHash& resultMap, const QVariantList& resultList)
+SqlResultRowAndroid::SqlResultRowAndroid(const ColumnIndex& columns, const QVariantList& resultList)
 {
-    valuesMap = resultMap;
-    values = resultList;
+    columnIndex = columns;
+    values = resultList.toVector();
 }
 
 SqlResultRowAndroid::~SqlResultRowAndroid()
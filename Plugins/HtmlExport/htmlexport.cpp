@@ -194,7 +194,7 @@ bool HtmlExport::exportDataRow(SqlResultsRowPtr data)
     QString cellValue;
     QString cellStyle;
     int i = 0;
-    for (const QVariant& value : data->valueList())
+    for (const QVariant& value : data->valueVector())
     {
         if (columnTypes[i].isNumeric())
             align = "right";
@@ -72,7 +72,7 @@ bool JsonExport::beforeExportQueryResults(const QString& query, QList<QueryExecu
 bool JsonExport::exportQueryResultsRow(SqlResultsRowPtr row)
 {
     beginArray();
-    for (const QVariant& value : row->valueList())
+    for (const QVariant& value : row->valueVector())
         writeValue(value);
 
     endArray();
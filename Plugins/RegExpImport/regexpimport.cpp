@@ -4,8 +4,7 @@
 #include "services/importmanager.h"
 #include "sqlitestudio.h"
 #include <QRegularExpression>
-#include <QFile>
-#include <QTextStream>
+#include <QTextCodec>
 
 RegExpImport::RegExpImport()
 {
@@ -40,24 +39,25 @@ QString RegExpImport::getFileFilter() const
 bool RegExpImport::beforeImport(const ImportManager::StandardImportConfig& config)
 {
     safe_delete(re);
-    safe_delete(file);
-    safe_delete(stream);
+    safe_delete(decoder);
     groups.clear();
     buffer.clear();
+    text.clear();
+    textPosition = 0;
     columns.clear();
 
-
-    file = new QFile(config.inputFileName);
-    if (!file->open(QFile::ReadOnly) || !file->isReadable())
+    if (!input.open(config.inputFileName))
     {
         notifyError(tr("Cannot read file %1").arg(config.inputFileName));
-        safe_delete(file);
         return false;
     }
 
-    stream = new QTextStream(file);
-    stream->setCodec(config.codec.toLatin1().data());
+    QTextCodec* codec = QTextCodec::codecForName(config.codec.toLatin1());
+    if (!codec)
+        codec = QTextCodec::codecForLocale();
 
+    // Byte order mark overrides the codec, just like it does for QTextStream
+    decoder = input.detectCodec(codec)->makeDecoder();
 
     static const QString intColTemplate = QStringLiteral("column%1");
     re = new QRegularExpression(cfg.RegExpImport.Pattern.get());
@@ -98,9 +98,11 @@ bool RegExpImport::beforeImport(const ImportManager::StandardImportConfig& confi
 void RegExpImport::afterImport()
 {
     safe_delete(re);
-    safe_delete(file);
-    safe_delete(stream);
+    safe_delete(decoder);
+    input.close();
     buffer.clear();
+    text.clear();
+    textPosition = 0;
     groups.clear();
 }
 
@@ -117,7 +119,7 @@ QList<QVariant> RegExpImport::next()
 {
     QRegularExpressionMatch match = re->match(buffer);
     QString line;
-    while (!match.hasMatch() && !(line = stream->readLine()).isNull())
+    while (!match.hasMatch() && readLine(line))
     {
         buffer += line;
         match = re->match(buffer);
@@ -140,6 +142,46 @@ QList<QVariant> RegExpImport::next()
     return values;
 }
 
+qint64 RegExpImport::getInputSize() const
+{
+    return input.getSize();
+}
+
+qint64 RegExpImport::getInputPosition() const
+{
+    return input.getPosition();
+}
+
+bool RegExpImport::readLine(QString& line)
+{
+    // Input is decoded in large chunks, but the pattern is still matched line by line, as lines are appended to the buffer
+    int lineEnd = text.indexOf('\n', textPosition);
+    while (lineEnd < 0 && !input.atEnd())
+    {
+        text = text.mid(textPosition) + decoder->toUnicode(input.readChunk());
+        textPosition = 0;
+        lineEnd = text.indexOf('\n');
+    }
+
+    if (lineEnd < 0)
+    {
+        if (textPosition >= text.size())
+            return false;
+
+        line = text.mid(textPosition);
+        textPosition = text.size();
+        return true;
+    }
+
+    int nextLine = lineEnd + 1;
+    if (lineEnd > textPosition && text[lineEnd - 1] == '\r')
+        lineEnd--;
+
+    line = text.mid(textPosition, lineEnd - textPosition);
+    textPosition = nextLine;
+    return true;
+}
+
 CfgMain* RegExpImport::getConfig()
 {
     return &cfg;
@@ -5,10 +5,10 @@
 #include "plugins/genericplugin.h"
 #include "plugins/importplugin.h"
 #include "config_builder.h"
+#include "common/chunkedfilereader.h"
 
 class QRegularExpression;
-class QFile;
-class QTextStream;
+class QTextDecoder;
 
 CFG_CATEGORIES(RegExpImportConfig,
      CFG_CATEGORY(RegExpImport,
@@ -35,17 +35,27 @@ class REGEXPIMPORTSHARED_EXPORT RegExpImport : public GenericPlugin, public Impo
         void afterImport();
         QList<ColumnDefinition> getColumns() const;
         QList<QVariant> next();
+        qint64 getInputSize() const;
+        qint64 getInputPosition() const;
         CfgMain* getConfig();
         QString getImportConfigFormName() const;
         bool validateOptions();
 
     private:
+        bool readLine(QString& line);
+
         CFG_LOCAL(RegExpImportConfig, cfg)
         QRegularExpression* re = nullptr;
         QList<QVariant> groups;
         QStringList columns;
-        QFile* file = nullptr;
-        QTextStream* stream = nullptr;
+        ChunkedFileReader input;
+        QTextDecoder* decoder = nullptr;
+
+        /**
+         * @brief Chunk of the input decoded at once, from which lines are taken.
+         */
+        QString text;
+        int textPosition = 0;
         QString buffer;
 };
 
@@ -97,7 +97,7 @@ bool XmlExport::exportQueryResultsRow(SqlResultsRowPtr row)
     incrIndent();
 
     int i = 0;
-    for (const QVariant& value : row->valueList())
+    for (const QVariant& value : row->valueVector())
     {
         if (value.isNull())
             writeln(nullTpl.arg(i));
@@ -4,6 +4,7 @@
 #include <QtTest>
 #include "tsvserializer.h"
 #include "csvserializer.h"
+#include "csvreader.h"
 
 // TODO Add tests for CsvSerializer
 
@@ -16,10 +17,13 @@ class DsvFormatsTestTest : public QObject
 
     private:
         QString toString(const QList<QStringList>& input);
+        QList<QStringList> readCsvInChunks(const QByteArray& input, const CsvFormat& format, int chunkSize);
 
         QList<QStringList> sampleData;
         QList<QStringList> sampleDeserializedData;
         QString sampleTsv;
+        CsvFormat csvImportFormat;
+        QList<QPair<QByteArray,QList<QStringList>>> csvSamples;
 
     private Q_SLOTS:
         void initTestCase();
@@ -27,12 +31,46 @@ class DsvFormatsTestTest : public QObject
         void testTsv1();
         void testTsv2();
         void testCsv1();
+        void testCsvReader1();
+        void testCsvReader2();
+        void testCsvReaderChunks();
+        void testCsvReaderSplit();
+        void testCsvReaderThroughput();
 };
 
 DsvFormatsTestTest::DsvFormatsTestTest()
 {
 }
 
+QList<QStringList> DsvFormatsTestTest::readCsvInChunks(const QByteArray& input, const CsvFormat& format, int chunkSize)
+{
+    QList<QStringList> rows;
+    QStringList values;
+    CsvReader reader(format);
+    CsvReader::Record record;
+    QByteArray buffer;
+    int offset = 0;
+    bool lastChunk = false;
+    while (!lastChunk)
+    {
+        buffer += input.mid(offset, chunkSize);
+        offset += chunkSize;
+        lastChunk = offset >= input.size();
+
+        reader.setData(buffer.constData(), buffer.size(), lastChunk);
+        while (reader.readRecord(record))
+        {
+            values.clear();
+            for (const CsvReader::Field& field : record)
+                values << field.toString();
+
+            rows << values;
+        }
+        buffer = buffer.mid(reader.getPosition());
+    }
+    return rows;
+}
+
 QString DsvFormatsTestTest::toString(const QList<QStringList>& input)
 {
     QStringList outputLines;
@@ -68,6 +106,25 @@ void DsvFormatsTestTest::initTestCase()
     sampleDeserializedData << QStringList{"a\"a\"", "\"b\"c\"", "d\"\"e"};
     sampleDeserializedData << QStringList{"a\na", "\"b", "c\"", "\"d", "\"\"e\""};
     sampleDeserializedData << QStringList{"a", "", "b", ""};
+
+    csvImportFormat = CsvFormat();
+    csvImportFormat.columnSeparator = ",";
+    csvImportFormat.rowSeparators = QStringList({"\r\n", "\n", "\r"});
+    csvImportFormat.multipleRowSeparators = true;
+    csvImportFormat.strictRowSeparator = true;
+
+    csvSamples << qMakePair(QByteArray("a,b\nc,d\n"), QList<QStringList>({{"a", "b"}, {"c", "d"}}));
+    csvSamples << qMakePair(QByteArray("a,b\r\nc,d"), QList<QStringList>({{"a", "b"}, {"c", "d"}}));
+    csvSamples << qMakePair(QByteArray("a\rb\r\n\nc"), QList<QStringList>({{"a"}, {"b"}, {""}, {"c"}}));
+    csvSamples << qMakePair(QByteArray("a,"), QList<QStringList>({{"a", ""}}));
+    csvSamples << qMakePair(QByteArray(",,\n"), QList<QStringList>({{"", "", ""}}));
+    csvSamples << qMakePair(QByteArray("\"x,y\",\"q\"\"z\"\n\"\"\"\""), QList<QStringList>({{"x,y", "q\"z"}, {"\""}}));
+    csvSamples << qMakePair(QByteArray("\"multi\r\nline\",x"), QList<QStringList>({{"multi\r\nline", "x"}}));
+    csvSamples << qMakePair(QByteArray("a\"b,c\"d,e"), QList<QStringList>({{"ab,cd", "e"}}));
+    csvSamples << qMakePair(QByteArray("\xC5\xBC\xC3\xB3\xC5\x82w,\"\xE2\x82\xAC\""), QList<QStringList>({{QString::fromUtf8("\xC5\xBC\xC3\xB3\xC5\x82w"), QString::fromUtf8("\xE2\x82\xAC")}}));
+    csvSamples << qMakePair(QByteArray("0123456789012345678901234567890123456789,\"long quoted field with \"\" inside of it\"\n"),
+                            QList<QStringList>({{"0123456789012345678901234567890123456789", "long quoted field with \" inside of it"}}));
+    csvSamples << qMakePair(QByteArray(), QList<QStringList>());
 }
 
 void DsvFormatsTestTest::cleanupTestCase()
@@ -105,6 +162,89 @@ void DsvFormatsTestTest::testCsv1()
     QVERIFY(result.first().size() == 2);
 }
 
+void DsvFormatsTestTest::testCsvReader1()
+{
+    for (const QPair<QByteArray,QList<QStringList>>& sample : csvSamples)
+    {
+        QList<QStringList> result = CsvReader::readAll(sample.first, csvImportFormat);
+        QVERIFY2(result == sample.second, QString("Input: %1\nSample: %2\nGot: %3").arg(QString::fromUtf8(sample.first), toString(sample.second), toString(result)).toLocal8Bit().data());
+    }
+}
+
+void DsvFormatsTestTest::testCsvReader2()
+{
+    QString input = "a,\"b\"\"c\",\"d\ne\"\nf,,g";
+    QList<QStringList> expected = CsvSerializer::deserialize(input, csvImportFormat);
+    QList<QStringList> result = CsvReader::readAll(input.toUtf8(), csvImportFormat);
+    QVERIFY2(result == expected, QString("Serializer: %1\nReader: %2").arg(toString(expected), toString(result)).toLocal8Bit().data());
+
+    CsvFormat format;
+    format.columnSeparator = "::";
+    format.strictColumnSeparator = true;
+    format.rowSeparator = "\n";
+    result = CsvReader::readAll("a::b:c\n::", format);
+    expected = QList<QStringList>({{"a", "b:c"}, {"", ""}});
+    QVERIFY2(result == expected, QString("Sample: %1\nGot: %2").arg(toString(expected), toString(result)).toLocal8Bit().data());
+}
+
+void DsvFormatsTestTest::testCsvReaderChunks()
+{
+    for (const QPair<QByteArray,QList<QStringList>>& sample : csvSamples)
+    {
+        for (int chunkSize = 1; chunkSize <= 5; chunkSize++)
+        {
+            QList<QStringList> result = readCsvInChunks(sample.first, csvImportFormat, chunkSize);
+            QVERIFY2(result == sample.second, QString("Chunk: %1\nSample: %2\nGot: %3").arg(chunkSize).arg(toString(sample.second), toString(result)).toLocal8Bit().data());
+        }
+    }
+}
+
+void DsvFormatsTestTest::testCsvReaderSplit()
+{
+    QByteArray input = "a,\"b\nc\",d\r\n\"x\"\"\ny\",z\n\n\"\"\"\",q\rlast,\"\"\r\n1,2";
+    QList<QStringList> expected = CsvReader::readAll(input, csvImportFormat);
+
+    CsvReader reader(csvImportFormat);
+    reader.setData(input.constData(), input.size());
+    for (int splitPos = 1; splitPos < input.size(); splitPos++)
+    {
+        bool inQuotes = (input.left(splitPos).count('"') % 2) == 1;
+        int recordStart = static_cast<int>(reader.findNextRecord(splitPos, inQuotes));
+
+        QList<QStringList> result = CsvReader::readAll(input.left(recordStart), csvImportFormat);
+        result += CsvReader::readAll(input.mid(recordStart), csvImportFormat);
+        QVERIFY2(result == expected, QString("Split: %1\nSample: %2\nGot: %3").arg(splitPos).arg(toString(expected), toString(result)).toLocal8Bit().data());
+    }
+}
+
+void DsvFormatsTestTest::testCsvReaderThroughput()
+{
+    static const int rows = 20000;
+    QByteArray input;
+    for (int i = 0; i < rows; i++)
+        input += "12345,some text value,\"quoted, with a comma\",3.14159,\"escaped \"\"quote\"\"\",last field of the row\r\n";
+
+    CsvReader reader(csvImportFormat);
+    CsvReader::Record record;
+    QString value;
+    int fields = 0;
+    QBENCHMARK
+    {
+        fields = 0;
+        reader.setData(input.constData(), input.size());
+        while (reader.readRecord(record))
+        {
+            for (const CsvReader::Field& field : record)
+            {
+                value = field.toString();
+                fields++;
+            }
+        }
+    }
+
+    QVERIFY(fields == rows * 6);
+}
+
 QTEST_APPLESS_MAIN(DsvFormatsTestTest)
 
 #include "tst_dsvformatstesttest.moc"
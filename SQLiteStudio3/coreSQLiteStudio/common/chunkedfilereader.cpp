@@ -0,0 +1,143 @@
+#include "chunkedfilereader.h"
+#include "common/global.h"
+#include <QFile>
+#include <QTextCodec>
+
+ChunkedFileReader::ChunkedFileReader()
+{
+}
+
+ChunkedFileReader::~ChunkedFileReader()
+{
+    close();
+}
+
+bool ChunkedFileReader::open(const QString& fileName)
+{
+    close();
+
+    file = new QFile(fileName);
+    if (!file->open(QFile::ReadOnly) || !file->isReadable())
+    {
+        safe_delete(file);
+        return false;
+    }
+
+    size = file->size();
+    mappedPosition = 0;
+    if (size > 0 && !file->isSequential())
+        mappedData = file->map(0, size);
+
+    return true;
+}
+
+void ChunkedFileReader::close()
+{
+    if (!file)
+        return;
+
+    if (mappedData)
+    {
+        file->unmap(mappedData);
+        mappedData = nullptr;
+    }
+
+    safe_delete(file);
+    size = 0;
+    mappedPosition = 0;
+}
+
+QTextCodec* ChunkedFileReader::detectCodec(QTextCodec* defaultCodec)
+{
+    static const int utf8Mib = 106;
+    static const QByteArray utf8Bom = QByteArrayLiteral("\xEF\xBB\xBF");
+
+    QByteArray head;
+    if (mappedData)
+        head = QByteArray::fromRawData(getMappedData() + mappedPosition, static_cast<int>(qMin(size - mappedPosition, qint64(4))));
+    else
+        head = file->peek(4);
+
+    QTextCodec* codec = QTextCodec::codecForUtfText(head, defaultCodec);
+    if (codec && codec->mibEnum() == utf8Mib && head.startsWith(utf8Bom))
+        seek(getPosition() + utf8Bom.size());
+
+    return codec;
+}
+
+QByteArray ChunkedFileReader::readChunk(int maxSize)
+{
+    if (!file)
+        return QByteArray();
+
+    if (!mappedData)
+        return file->read(maxSize);
+
+    int chunkSize = static_cast<int>(qMin(size - mappedPosition, qint64(maxSize)));
+    if (chunkSize <= 0)
+        return QByteArray();
+
+    QByteArray chunk = QByteArray::fromRawData(getMappedData() + mappedPosition, chunkSize);
+    mappedPosition += chunkSize;
+    return chunk;
+}
+
+const char* ChunkedFileReader::getMappedData() const
+{
+    return reinterpret_cast<const char*>(mappedData);
+}
+
+bool ChunkedFileReader::isMapped() const
+{
+    return mappedData != nullptr;
+}
+
+bool ChunkedFileReader::seek(qint64 pos)
+{
+    if (!file)
+        return false;
+
+    if (!mappedData)
+        return file->seek(pos);
+
+    if (pos < 0 || pos > size)
+        return false;
+
+    mappedPosition = pos;
+    return true;
+}
+
+qint64 ChunkedFileReader::getPosition() const
+{
+    if (!file)
+        return 0;
+
+    if (mappedData)
+        return mappedPosition;
+
+    return file->pos();
+}
+
+qint64 ChunkedFileReader::getSize() const
+{
+    return size;
+}
+
+bool ChunkedFileReader::atEnd() const
+{
+    if (!file)
+        return true;
+
+    if (mappedData)
+        return mappedPosition >= size;
+
+    return file->atEnd();
+}
+
+QString ChunkedFileReader::getFileName() const
+{
+    if (!file)
+        return QString();
+
+    return file->fileName();
+}
@@ -0,0 +1,76 @@
+#ifndef CHUNKEDFILEREADER_H
+#define CHUNKEDFILEREADER_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QByteArray>
+#include <QString>
+
+class QFile;
+class QTextCodec;
+
+/**
+ * @brief Reads a file in large chunks, directly from memory mapped pages whenever possible.
+ *
+ * If the file cannot be mapped into memory (it's not a regular file, or it doesn't fit into the address space),
+ * it's read with usual reads. In both cases chunks are provided the same way, so the caller doesn't need to care.
+ *
+ * Chunks of a mapped file don't copy the data. They are valid until the reader is closed.
+ */
+class API_EXPORT ChunkedFileReader
+{
+    public:
+        ChunkedFileReader();
+        ~ChunkedFileReader();
+
+        /**
+         * @brief Opens the file for reading and maps it into memory if possible.
+         * @param fileName File to open.
+         * @return true on success, or false if the file could not be opened.
+         */
+        bool open(const QString& fileName);
+        void close();
+
+        /**
+         * @brief Detects codec of the file from the byte order mark.
+         * @param defaultCodec Codec to use if there's no byte order mark.
+         * @return Detected codec.
+         *
+         * It should be called right after opening the file. UTF-8 byte order mark is skipped,
+         * so the data can be passed to UTF-8 consumers as it is. Other byte order marks are handled by decoders of their codecs.
+         */
+        QTextCodec* detectCodec(QTextCodec* defaultCodec);
+
+        /**
+         * @brief Reads next chunk of the file.
+         * @param maxSize Maximum size of the chunk.
+         * @return Chunk of data, or empty array at the end of the file.
+         */
+        QByteArray readChunk(int maxSize = defaultChunkSize);
+
+        /**
+         * @brief Provides whole contents of the mapped file.
+         * @return Pointer to the first byte of the file, or null if the file is not mapped.
+         */
+        const char* getMappedData() const;
+
+        bool isMapped() const;
+        bool seek(qint64 pos);
+        qint64 getPosition() const;
+        qint64 getSize() const;
+        bool atEnd() const;
+        QString getFileName() const;
+
+        static const int defaultChunkSize = 4 * 1024 * 1024;
+
+    private:
+        QFile* file = nullptr;
+        uchar* mappedData = nullptr;
+        qint64 size = 0;
+
+        /**
+         * @brief Read position in the mapped file. Not used if the file is not mapped.
+         */
+        qint64 mappedPosition = 0;
+};
+
+#endif // CHUNKEDFILEREADER_H
@@ -52,8 +52,15 @@ ReadWriteLocker::Mode ReadWriteLocker::getMode(const QString &query, Dialect dia
     if (noLock)
         return ReadWriteLocker::NONE;
 
-    QueryAccessMode queryMode = getQueryAccessMode(query, dialect);
-    switch (queryMode)
+    return getMode(getQueryAccessMode(query, dialect), false);
+}
+
+ReadWriteLocker::Mode ReadWriteLocker::getMode(QueryAccessMode accessMode, bool noLock)
+{
+    if (noLock)
+        return ReadWriteLocker::NONE;
+
+    switch (accessMode)
     {
         case QueryAccessMode::READ:
             return ReadWriteLocker::READ;
@@ -61,6 +68,6 @@ ReadWriteLocker::Mode ReadWriteLocker::getMode(const QString &query, Dialect dia
             return ReadWriteLocker::WRITE;
     }
 
-    qCritical() << "Unhandled query access mode:" << static_cast<int>(queryMode);
+    qCritical() << "Unhandled query access mode:" << static_cast<int>(accessMode);
     return ReadWriteLocker::NONE;
 }
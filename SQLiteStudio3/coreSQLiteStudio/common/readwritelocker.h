@@ -3,6 +3,7 @@
 
 #include "coreSQLiteStudio_global.h"
 #include "dialect.h"
+#include "common/utils_sql.h"
 
 class QReadLocker;
 class QWriteLocker;
@@ -55,6 +56,17 @@ class API_EXPORT ReadWriteLocker
          */
         static ReadWriteLocker::Mode getMode(const QString& query, Dialect dialect, bool noLock);
 
+        /**
+         * @brief Provides required locking mode for already known query access mode.
+         * @param accessMode Query access mode, as provided by getQueryAccessMode() or QueryMetadata.
+         * @param noLock If true, then the NONE mode is returned regardless of the access mode.
+         * @return Locking mode: READ, WRITE or NONE.
+         *
+         * This is a variant of getMode() that doesn't tokenize the query, so it should be used
+         * whenever access mode is already known.
+         */
+        static ReadWriteLocker::Mode getMode(QueryAccessMode accessMode, bool noLock);
+
     private:
         void init(QReadWriteLock* lock, Mode mode);
 
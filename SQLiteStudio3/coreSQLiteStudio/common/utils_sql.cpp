@@ -697,13 +697,17 @@ QString getBindTokenName(const TokenPtr& token)
 }
 
 QueryAccessMode getQueryAccessMode(const QString& query, Dialect dialect, bool* isSelect)
+{
+    return getQueryAccessMode(Lexer::tokenize(query, dialect), isSelect);
+}
+
+QueryAccessMode getQueryAccessMode(const TokenList& tokens, bool* isSelect)
 {
     static QStringList readOnlyCommands = {"ANALYZE", "EXPLAIN", "PRAGMA", "SELECT"};
 
     if (isSelect)
         *isSelect = false;
 
-    TokenList tokens = Lexer::tokenize(query, dialect);
     int keywordIdx = tokens.indexOf(Token::KEYWORD);
     if (keywordIdx < 0)
         return QueryAccessMode::WRITE;
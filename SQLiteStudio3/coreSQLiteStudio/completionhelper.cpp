@@ -29,6 +29,7 @@ CompletionHelper::CompletionHelper(const QString &sql, quint32 cursorPos, Db* db
     : db(db), cursorPosition(cursorPos), fullSql(sql)
 {
     schemaResolver = new SchemaResolver(db);
+    schemaResolver->setUseReader(true);
     selectResolver = new SelectResolver(db, fullSql);
     selectResolver->ignoreInvalidNames = true;
     dbAttacher = SQLITESTUDIO->createDbAttacher(db);
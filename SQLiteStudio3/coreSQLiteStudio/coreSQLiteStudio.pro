@@ -65,6 +65,7 @@ SOURCES += sqlitestudio.cpp \
     returncode.cpp \
     services/config.cpp \
     common/nulldevice.cpp \
+    common/chunkedfilereader.cpp \
     parser/lexer_low_lev.cpp \
     common/utils.cpp \
     parser/keywords.cpp \
@@ -128,6 +129,7 @@ SOURCES += sqlitestudio.cpp \
     qio.cpp \
     plugins/pluginsymbolresolver.cpp \
     db/sqlerrorresults.cpp \
+    db/sqlspooledresults.cpp \
     db/queryexecutorsteps/queryexecutorstep.cpp \
     db/queryexecutorsteps/queryexecutorcountresults.cpp \
     db/queryexecutorsteps/queryexecutorparsequery.cpp \
@@ -143,6 +145,7 @@ SOURCES += sqlitestudio.cpp \
     db/queryexecutorsteps/queryexecutorwrapdistinctresults.cpp \
     csvformat.cpp \
     csvserializer.cpp \
+    csvreader.cpp \
     db/queryexecutorsteps/queryexecutordatasources.cpp \
     expectedtoken.cpp \
     sqlhistorymodel.cpp \
@@ -223,13 +226,15 @@ SOURCES += sqlitestudio.cpp \
     common/threadwitheventloop.cpp \
     common/private/blockingsocketprivate.cpp \
     querygenerator.cpp \
-    common/bistrhash.cpp
+    common/bistrhash.cpp \
+    db/querymetadata.cpp
 
 HEADERS += sqlitestudio.h\
         coreSQLiteStudio_global.h \
     returncode.h \
     services/config.h \
     common/nulldevice.h \
+    common/chunkedfilereader.h \
     parser/lexer_low_lev.h \
     common/utils.h \
     parser/keywords.h \
@@ -302,6 +307,7 @@ HEADERS += sqlitestudio.h\
     parser/ast/sqlitetablerelatedddl.h \
     plugins/pluginsymbolresolver.h \
     db/sqlerrorresults.h \
+    db/sqlspooledresults.h \
     db/sqlerrorcodes.h \
     db/queryexecutorsteps/queryexecutorstep.h \
     db/queryexecutorsteps/queryexecutorcountresults.h \
@@ -318,6 +324,7 @@ HEADERS += sqlitestudio.h\
     db/queryexecutorsteps/queryexecutorwrapdistinctresults.h \
     csvformat.h \
     csvserializer.h \
+    csvreader.h \
     db/queryexecutorsteps/queryexecutordatasources.h \
     sqlhistorymodel.h \
     db/queryexecutorsteps/queryexecutorexplainmode.h \
@@ -419,7 +426,8 @@ HEADERS += sqlitestudio.h\
     parser/ast/sqliteddlwithdbcontext.h \
     parser/ast/sqliteextendedindexedcolumn.h \
     querygenerator.h \
-    common/sortedset.h
+    common/sortedset.h \
+    db/querymetadata.h
 
 unix: {
     target.path = $$LIBDIR
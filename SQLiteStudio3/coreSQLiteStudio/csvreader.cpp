@@ -0,0 +1,420 @@
+#include "csvreader.h"
+#include <cstring>
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#   define CSVREADER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define CSVREADER_SSE2
+#endif
+
+#if defined(Q_CC_MSVC) && (defined(CSVREADER_AVX2) || defined(CSVREADER_SSE2))
+#   include <intrin.h>
+#endif
+
+#if defined(CSVREADER_AVX2) || defined(CSVREADER_SSE2)
+/**
+ * @brief Maximum number of special bytes looked for with vector instructions.
+ *
+ * Each special byte costs one comparison per vector. With more of them (which happens only with unusual separators)
+ * the byte map lookup is used.
+ */
+static const int maxVectorSpecialBytes = 8;
+
+static inline int firstSetBit(quint32 mask)
+{
+#ifdef Q_CC_MSVC
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+CsvReader::CsvReader(const CsvFormat& format)
+{
+    columnSeparators = toSeparatorBytes(format.columnSeparator, format.columnSeparators, format.strictColumnSeparator,
+                                        format.multipleColumnSeparators);
+    rowSeparators = toSeparatorBytes(format.rowSeparator, format.rowSeparators, format.strictRowSeparator,
+                                     format.multipleRowSeparators);
+
+    specialBytes.append('"');
+    for (const QByteArray& sep : columnSeparators + rowSeparators)
+    {
+        if (!specialBytes.contains(sep[0]))
+            specialBytes.append(sep[0]);
+    }
+
+    memset(specialByteMap, 0, sizeof(specialByteMap));
+    for (char c : specialBytes)
+        specialByteMap[static_cast<uchar>(c)] = true;
+}
+
+void CsvReader::setData(const char* data, qint64 size, bool lastChunk)
+{
+    this->data = data;
+    this->size = size;
+    this->lastChunk = lastChunk;
+    position = 0;
+}
+
+bool CsvReader::readRecord(CsvReader::Record& record)
+{
+    record.clear();
+
+    const char* end = data + size;
+    const char* ptr = data + position;
+    if (ptr >= end)
+        return false;
+
+    const char* fieldStart = ptr;
+    const char* quote = nullptr;
+    int quoteCount = 0;
+    int sepLength = 0;
+    bool quotes = false;
+    bool incomplete = false;
+    while (ptr < end)
+    {
+        if (quotes)
+        {
+            // Only the quote character matters within quotes
+            quote = static_cast<const char*>(memchr(ptr, '"', end - ptr));
+            if (!quote)
+            {
+                ptr = end;
+                break;
+            }
+
+            if (quote + 1 == end)
+            {
+                // It's not known yet if the quote is escaped by another one
+                if (!lastChunk)
+                    break;
+
+                quoteCount++;
+                ptr = end;
+                break;
+            }
+
+            if (quote[1] == '"')
+            {
+                quoteCount += 2;
+                ptr = quote + 2;
+                continue;
+            }
+
+            quoteCount++;
+            quotes = false;
+            ptr = quote + 1;
+            continue;
+        }
+
+        ptr = findSpecialByte(ptr, end);
+        if (ptr == end)
+            break;
+
+        if (*ptr == '"')
+        {
+            quotes = true;
+            quoteCount++;
+            ptr++;
+            continue;
+        }
+
+        sepLength = matchSeparator(columnSeparators, ptr, end, incomplete);
+        if (sepLength > 0)
+        {
+            addField(record, fieldStart, ptr, quoteCount);
+            ptr += sepLength;
+            fieldStart = ptr;
+            quoteCount = 0;
+            continue;
+        }
+
+        if (incomplete)
+            break;
+
+        sepLength = matchSeparator(rowSeparators, ptr, end, incomplete);
+        if (sepLength > 0)
+        {
+            addField(record, fieldStart, ptr, quoteCount);
+            position = ptr + sepLength - data;
+            return true;
+        }
+
+        if (incomplete)
+            break;
+
+        ptr++;
+    }
+
+    // The record continues in the next chunk
+    if (!lastChunk)
+    {
+        record.clear();
+        return false;
+    }
+
+    // Last record without a row separator. The field is added also if it's empty, but follows a column separator.
+    if (end > fieldStart || !record.isEmpty())
+        addField(record, fieldStart, end, quoteCount);
+
+    position = size;
+    return !record.isEmpty();
+}
+
+qint64 CsvReader::getPosition() const
+{
+    return position;
+}
+
+bool CsvReader::atEnd() const
+{
+    return lastChunk && position >= size;
+}
+
+qint64 CsvReader::findNextRecord(qint64 from, bool inQuotes) const
+{
+    const char* end = data + size;
+    const char* ptr = data + from;
+    const char* quote = nullptr;
+    int sepLength = 0;
+    bool incomplete = false;
+    while (ptr < end)
+    {
+        if (inQuotes)
+        {
+            quote = static_cast<const char*>(memchr(ptr, '"', end - ptr));
+            if (!quote)
+                return size;
+
+            inQuotes = false;
+            ptr = quote + 1;
+            continue;
+        }
+
+        ptr = findSpecialByte(ptr, end);
+        if (ptr == end)
+            break;
+
+        if (*ptr == '"')
+        {
+            inQuotes = true;
+            ptr++;
+            continue;
+        }
+
+        sepLength = matchSeparator(columnSeparators, ptr, end, incomplete);
+        if (sepLength > 0)
+        {
+            ptr += sepLength;
+            continue;
+        }
+
+        sepLength = matchSeparator(rowSeparators, ptr, end, incomplete);
+        if (sepLength > 0)
+            return ptr + sepLength - data;
+
+        ptr++;
+    }
+    return size;
+}
+
+QList<QStringList> CsvReader::readAll(const QByteArray& data, const CsvFormat& format)
+{
+    CsvReader reader(format);
+    reader.setData(data.constData(), data.size());
+
+    QList<QStringList> rows;
+    QStringList values;
+    Record record;
+    while (reader.readRecord(record))
+    {
+        values.clear();
+        for (const Field& field : record)
+            values << field.toString();
+
+        rows << values;
+    }
+    return rows;
+}
+
+const char* CsvReader::findSpecialByte(const char* ptr, const char* end) const
+{
+#if defined(CSVREADER_AVX2) || defined(CSVREADER_SSE2)
+    int specialCount = specialBytes.size();
+    if (specialCount <= maxVectorSpecialBytes)
+    {
+#ifdef CSVREADER_AVX2
+        __m256i needles[maxVectorSpecialBytes];
+        for (int i = 0; i < specialCount; i++)
+            needles[i] = _mm256_set1_epi8(specialBytes[i]);
+
+        __m256i chunk;
+        __m256i hits;
+        quint32 mask;
+        while (end - ptr >= 32)
+        {
+            chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+            hits = _mm256_cmpeq_epi8(chunk, needles[0]);
+            for (int i = 1; i < specialCount; i++)
+                hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, needles[i]));
+
+            mask = static_cast<quint32>(_mm256_movemask_epi8(hits));
+            if (mask)
+                return ptr + firstSetBit(mask);
+
+            ptr += 32;
+        }
+#else
+        __m128i needles[maxVectorSpecialBytes];
+        for (int i = 0; i < specialCount; i++)
+            needles[i] = _mm_set1_epi8(specialBytes[i]);
+
+        __m128i chunk;
+        __m128i hits;
+        quint32 mask;
+        while (end - ptr >= 16)
+        {
+            chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+            hits = _mm_cmpeq_epi8(chunk, needles[0]);
+            for (int i = 1; i < specialCount; i++)
+                hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, needles[i]));
+
+            mask = static_cast<quint32>(_mm_movemask_epi8(hits));
+            if (mask)
+                return ptr + firstSetBit(mask);
+
+            ptr += 16;
+        }
+#endif
+    }
+#endif
+
+    while (ptr < end && !specialByteMap[static_cast<uchar>(*ptr)])
+        ptr++;
+
+    return ptr;
+}
+
+int CsvReader::matchSeparator(const QList<QByteArray>& separators, const char* ptr, const char* end, bool& incomplete) const
+{
+    qint64 available = end - ptr;
+    for (const QByteArray& sep : separators)
+    {
+        if (sep.size() <= available)
+        {
+            if (memcmp(ptr, sep.constData(), sep.size()) == 0)
+                return sep.size();
+
+            continue;
+        }
+
+        // Beginning of the separator is at the end of the buffer, so the rest of it may come with the next chunk
+        if (!lastChunk && memcmp(ptr, sep.constData(), available) == 0)
+        {
+            incomplete = true;
+            return 0;
+        }
+    }
+    return 0;
+}
+
+void CsvReader::addField(CsvReader::Record& record, const char* start, const char* end, int quoteCount) const
+{
+    Field field;
+    field.data = start;
+    field.size = end - start;
+    if (quoteCount == 2 && field.size >= 2 && start[0] == '"' && end[-1] == '"')
+    {
+        // Field enclosed in quotes, without any quotes inside, can be still a view
+        field.data++;
+        field.size -= 2;
+    }
+    else if (quoteCount > 0)
+    {
+        field.quoted = true;
+    }
+
+    record << field;
+}
+
+QList<QByteArray> CsvReader::toSeparatorBytes(const QString& separator, const QStringList& separators, bool strict, bool multiple)
+{
+    QList<QByteArray> results;
+    if (!strict)
+    {
+        // Any character of the separator is a separator on its own
+        for (const QChar& c : separator)
+            results << QString(c).toUtf8();
+
+        return results;
+    }
+
+    QStringList strictSeparators;
+    if (multiple)
+        strictSeparators = separators;
+    else
+        strictSeparators << separator;
+
+    for (const QString& sep : strictSeparators)
+    {
+        if (!sep.isEmpty())
+            results << sep.toUtf8();
+    }
+    return results;
+}
+
+QString CsvReader::Field::toString() const
+{
+    if (quoted)
+        return QString::fromUtf8(toUtf8());
+
+    return QString::fromUtf8(data, size);
+}
+
+QByteArray CsvReader::Field::toUtf8() const
+{
+    if (!quoted)
+        return QByteArray(data, size);
+
+    QByteArray value;
+    value.reserve(size);
+
+    bool quotes = false;
+    for (int i = 0; i < size; i++)
+    {
+        if (data[i] != '"')
+        {
+            value.append(data[i]);
+            continue;
+        }
+
+        if (!quotes)
+        {
+            quotes = true;
+            continue;
+        }
+
+        if (i + 1 < size && data[i + 1] == '"')
+        {
+            value.append('"');
+            i++;
+            continue;
+        }
+
+        quotes = false;
+    }
+    return value;
+}
+
+bool CsvReader::Field::isEmpty() const
+{
+    if (quoted)
+        return toUtf8().isEmpty();
+
+    return size == 0;
+}
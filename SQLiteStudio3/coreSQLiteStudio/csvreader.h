@@ -0,0 +1,136 @@
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include "coreSQLiteStudio_global.h"
+#include "csvformat.h"
+#include <QByteArray>
+#include <QVector>
+#include <QStringList>
+
+/**
+ * @brief Fast reader of CSV data encoded in UTF-8.
+ *
+ * The reader works directly on a buffer of bytes provided with setData(). The buffer is not copied,
+ * so it has to stay valid as long as records are read and their fields are used.
+ * Fields of records are views into the buffer and they are decoded only when asked for (see Field::toString()).
+ * Quotes and separators are located with SSE2 (or AVX2, if the code is compiled with it enabled),
+ * with a scalar fallback for other platforms.
+ *
+ * Data is interpreted the same way as CsvSerializer::deserialize() does. Separators are matched
+ * byte by byte, so they should be given in the same form as they appear in the data.
+ *
+ * Data can be provided in chunks. If a record is not complete in the current buffer, readRecord() returns false
+ * and the caller should call setData() again with a buffer that starts at getPosition() of the previous buffer
+ * and has more data appended. The last chunk is marked with the lastChunk parameter of setData().
+ */
+class API_EXPORT CsvReader
+{
+    public:
+        /**
+         * @brief Single field of a record, as a view into the buffer.
+         */
+        class API_EXPORT Field
+        {
+            friend class CsvReader;
+
+            public:
+                /**
+                 * @brief Decodes the field.
+                 * @return Value of the field, without enclosing quotes and with escaped quotes resolved.
+                 */
+                QString toString() const;
+
+                /**
+                 * @brief Provides value of the field as UTF-8 bytes.
+                 * @return Value of the field, without enclosing quotes and with escaped quotes resolved.
+                 */
+                QByteArray toUtf8() const;
+
+                bool isEmpty() const;
+
+            private:
+                const char* data = nullptr;
+                int size = 0;
+
+                /**
+                 * @brief True if the view contains quotes, that have to be processed when decoding the value.
+                 */
+                bool quoted = false;
+        };
+
+        typedef QVector<Field> Record;
+
+        explicit CsvReader(const CsvFormat& format);
+
+        /**
+         * @brief Sets buffer to read records from.
+         * @param data UTF-8 encoded data.
+         * @param size Number of bytes in the buffer.
+         * @param lastChunk True if there is no more data after this buffer.
+         *
+         * Reading starts from the beginning of the buffer.
+         */
+        void setData(const char* data, qint64 size, bool lastChunk = true);
+
+        /**
+         * @brief Reads next record from the buffer.
+         * @param record Record to fill with fields. Any previous fields are removed from it.
+         * @return true if a record was read, or false if there are no more complete records in the buffer.
+         */
+        bool readRecord(Record& record);
+
+        /**
+         * @brief Provides position of the next record to read.
+         * @return Offset in bytes from the beginning of the buffer.
+         */
+        qint64 getPosition() const;
+
+        /**
+         * @brief Tells if all data was read.
+         * @return true if the last chunk was set and all its records were read.
+         */
+        bool atEnd() const;
+
+        /**
+         * @brief Finds beginning of the first record after given position.
+         * @param from Offset in the buffer to start looking from.
+         * @param inQuotes Tells if the offset is within quotes.
+         * @return Offset of the first byte after the first row separator found outside of quotes, or size of the buffer if there's none.
+         *
+         * Every quote character toggles the quoting (the escaped quote is made of two of them, so it doesn't change anything),
+         * so the caller can tell if any offset is within quotes by the parity of quotes preceding it. This lets large data
+         * to be split into parts made of whole records without parsing it from the very beginning.
+         */
+        qint64 findNextRecord(qint64 from, bool inQuotes) const;
+
+        /**
+         * @brief Reads all records of given data.
+         * @param data UTF-8 encoded data.
+         * @param format CSV format of the data.
+         * @return Decoded records.
+         */
+        static QList<QStringList> readAll(const QByteArray& data, const CsvFormat& format);
+
+    private:
+        const char* findSpecialByte(const char* ptr, const char* end) const;
+        int matchSeparator(const QList<QByteArray>& separators, const char* ptr, const char* end, bool& incomplete) const;
+        void addField(Record& record, const char* start, const char* end, int quoteCount) const;
+
+        static QList<QByteArray> toSeparatorBytes(const QString& separator, const QStringList& separators, bool strict, bool multiple);
+
+        QList<QByteArray> columnSeparators;
+        QList<QByteArray> rowSeparators;
+
+        /**
+         * @brief Bytes that require attention of the reader: the quote and first bytes of all separators.
+         */
+        QByteArray specialBytes;
+
+        bool specialByteMap[256];
+        const char* data = nullptr;
+        qint64 size = 0;
+        qint64 position = 0;
+        bool lastChunk = true;
+};
+
+#endif // CSVREADER_H
@@ -15,6 +15,8 @@
 #include <QWriteLocker>
 #include <QReadLocker>
 #include <QThreadPool>
+#include <QThread>
+#include <QMutexLocker>
 #include <QMetaEnum>
 #include <QtConcurrent/QtConcurrentRun>
 
@@ -360,59 +362,12 @@ void AbstractDb::initAfterOpen()
 {
 }
 
-void AbstractDb::checkForDroppedObject(const QString& query)
+void AbstractDb::checkForDroppedObject(const QueryMetadataPtr& metadata)
 {
-    TokenList tokens = Lexer::tokenize(query, getDialect());
-    tokens.trim(Token::OPERATOR, ";");
-    if (tokens.size() == 0)
+    if (!metadata->drop)
         return;
 
-    if (tokens[0]->type != Token::KEYWORD || tokens.first()->value.toUpper() != "DROP")
-        return;
-
-    tokens.removeFirst(); // remove "DROP" from front
-    tokens.trimLeft(); // remove whitespaces and comments from front
-    if (tokens.size() == 0)
-    {
-        qWarning() << "Successful execution of DROP, but after removing DROP from front of the query, nothing has left. Original query:" << query;
-        return;
-    }
-
-    QString type = tokens.first()->value.toUpper();
-
-    // Now go to the first ID in the tokens
-    while (tokens.size() > 0 && tokens.first()->type != Token::OTHER)
-        tokens.removeFirst();
-
-    if (tokens.size() == 0)
-    {
-        qWarning() << "Successful execution of DROP, but after removing DROP and non-ID tokens from front of the query, nothing has left. Original query:" << query;
-        return;
-    }
-
-    QString database = "main";
-    QString object;
-
-    if (tokens.size() > 1)
-    {
-        database = tokens.first()->value;
-        object = tokens.last()->value;
-    }
-    else
-        object = tokens.first()->value;
-
-    object = stripObjName(object, getDialect());
-
-    if (type == "TABLE")
-        emit dbObjectDeleted(database, object, DbObjectType::TABLE);
-    else if (type == "INDEX")
-        emit dbObjectDeleted(database, object, DbObjectType::INDEX);
-    else if (type == "TRIGGER")
-        emit dbObjectDeleted(database, object, DbObjectType::TRIGGER);
-    else if (type == "VIEW")
-        emit dbObjectDeleted(database, object, DbObjectType::VIEW);
-    else
-        qWarning() << "Unknown object type dropped:" << type;
+    emit dbObjectDeleted(metadata->droppedDatabase, metadata->droppedObject, metadata->droppedType);
 }
 
 bool AbstractDb::registerCollation(const QString& name)
@@ -721,6 +676,56 @@ bool AbstractDb::isValid() const
     return true;
 }
 
+quint64 AbstractDb::getStatementCacheHits() const
+{
+    return stmtCacheHits;
+}
+
+quint64 AbstractDb::getStatementCacheMisses() const
+{
+    return stmtCacheMisses;
+}
+
+quint64 AbstractDb::getBusyWaitCount() const
+{
+    QMutexLocker locker(&busyWaitMutex);
+    return busyWaitCount;
+}
+
+qint64 AbstractDb::getBusyWaitTime() const
+{
+    QMutexLocker locker(&busyWaitMutex);
+    return busyWaitTime;
+}
+
+bool AbstractDb::waitWhileBusy(int retry, qint64 elapsedMsecs)
+{
+    int secs = getTimeout();
+    qint64 remainingUsecs = static_cast<qint64>(secs) * 1000000 - elapsedMsecs * 1000;
+    if (secs >= 0 && remainingUsecs <= 0)
+        return false;
+
+    unsigned long delay = busyWaitMaxDelay;
+    if (retry < 12 && (busyWaitInitialDelay << retry) < busyWaitMaxDelay)
+        delay = busyWaitInitialDelay << retry;
+
+    if (secs >= 0 && remainingUsecs < static_cast<qint64>(delay))
+        delay = static_cast<unsigned long>(remainingUsecs);
+
+    QThread::usleep(delay);
+    return true;
+}
+
+void AbstractDb::registerBusyWait(int retries, qint64 msecs, bool timedOut)
+{
+    {
+        QMutexLocker locker(&busyWaitMutex);
+        busyWaitCount++;
+        busyWaitTime += msecs;
+    }
+    logSqlBusyWait(this, retries, msecs, timedOut);
+}
+
 QString AbstractDb::getAttachSql(Db* otherDb, const QString& generatedAttachName)
 {
     return QString("ATTACH '%1' AS %2;").arg(otherDb->getPath(), generatedAttachName);
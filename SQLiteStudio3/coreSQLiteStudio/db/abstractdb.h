@@ -17,6 +17,7 @@
 #include <QReadWriteLock>
 #include <QRunnable>
 #include <QStringList>
+#include <QMutex>
 
 class AsyncQueryRunner;
 
@@ -87,6 +88,34 @@ class API_EXPORT AbstractDb : public Db
         int getTimeout() const;
         bool isValid() const;
 
+        /**
+         * @brief Provides number of statements taken from the prepared statement cache.
+         * @return Number of cache hits since the database object was created.
+         *
+         * Implementations that don't cache prepared statements always return 0.
+         */
+        quint64 getStatementCacheHits() const;
+
+        /**
+         * @brief Provides number of statements that had to be prepared, because they were not in the prepared statement cache.
+         * @return Number of cache misses since the database object was created.
+         *
+         * Implementations that don't cache prepared statements always return 0.
+         */
+        quint64 getStatementCacheMisses() const;
+
+        /**
+         * @brief Provides number of times a query had to wait for the database to be released by another connection.
+         * @return Number of busy waits since the database object was created.
+         */
+        quint64 getBusyWaitCount() const;
+
+        /**
+         * @brief Provides total time spent on waiting for the database to be released by another connection.
+         * @return Number of milliseconds spent on busy waits since the database object was created.
+         */
+        qint64 getBusyWaitTime() const;
+
     protected:
         struct FunctionUserData
         {
@@ -204,7 +233,11 @@ class API_EXPORT AbstractDb : public Db
 
         virtual void initAfterOpen();
 
-        void checkForDroppedObject(const QString& query);
+        /**
+         * @brief Emits dbObjectDeleted() if the query was a DROP statement.
+         * @param metadata Metadata of the successfully executed query.
+         */
+        void checkForDroppedObject(const QueryMetadataPtr& metadata);
         bool registerCollation(const QString& name);
         bool deregisterCollation(const QString& name);
         bool isCollationRegistered(const QString& name);
@@ -319,6 +352,48 @@ class API_EXPORT AbstractDb : public Db
          */
         QReadWriteLock dbOperLock;
 
+        /**
+         * @brief Number of prepared statement cache hits.
+         * @see getStatementCacheHits()
+         */
+        quint64 stmtCacheHits = 0;
+
+        /**
+         * @brief Number of prepared statement cache misses.
+         * @see getStatementCacheMisses()
+         */
+        quint64 stmtCacheMisses = 0;
+
+        /**
+         * @brief Waits before retrying a step of query that failed because the database was busy.
+         * @param retry Number of retries already made for this step (0 for the first one).
+         * @param elapsedMsecs Milliseconds already spent on waiting for this step.
+         * @return true if the step should be retried, or false if the timeout (see Db::setTimeout()) was reached.
+         *
+         * Delay starts with busyWaitInitialDelay and is doubled with each retry, up to busyWaitMaxDelay,
+         * so a short lock held by another process delays the query only as much as needed.
+         * The delay never exceeds time remaining to the timeout.
+         */
+        bool waitWhileBusy(int retry, qint64 elapsedMsecs);
+
+        /**
+         * @brief Records finished busy wait in statistics and in the SQL debug log.
+         * @param retries Number of retries made.
+         * @param msecs Milliseconds spent on waiting.
+         * @param timedOut true if the database was still busy when the timeout was reached.
+         */
+        void registerBusyWait(int retries, qint64 msecs, bool timedOut);
+
+        /**
+         * @brief Delay (in microseconds) before the first retry of a busy query.
+         */
+        static const unsigned long busyWaitInitialDelay = 50;
+
+        /**
+         * @brief Maximum delay (in microseconds) between retries of a busy query.
+         */
+        static const unsigned long busyWaitMaxDelay = 100000;
+
     private:
         /**
          * @brief Represents single function that is registered in the database.
@@ -435,6 +510,23 @@ class API_EXPORT AbstractDb : public Db
          */
         int timeout = 60;
 
+        /**
+         * @brief Number of busy waits.
+         * @see getBusyWaitCount()
+         */
+        quint64 busyWaitCount = 0;
+
+        /**
+         * @brief Total time of busy waits in milliseconds.
+         * @see getBusyWaitTime()
+         */
+        qint64 busyWaitTime = 0;
+
+        /**
+         * @brief Guards busy wait statistics, as queries can be executed from different threads.
+         */
+        mutable QMutex busyWaitMutex;
+
         /**
          * @brief List of all functions currently registered in this database.
          */
@@ -11,6 +11,7 @@
 #include <sqlite.h>
 #include <QThread>
 #include <QPointer>
+#include <QElapsedTimer>
 #include <QDebug>
 
 /**
@@ -69,7 +70,7 @@ class AbstractDb2 : public AbstractDb
                 class Row : public SqlResultsRow
                 {
                     public:
-                        void init(const QStringList& columns, const QList<QVariant>& resultValues);
+                        void init(const ColumnIndex& columns, const QVector<QVariant>& resultValues);
                 };
 
                 Query(AbstractDb2<T>* db, const QString& query);
@@ -108,7 +109,8 @@ class AbstractDb2 : public AbstractDb
                 QString errorMessage;
                 int colCount = -1;
                 QStringList colNames;
-                QList<QVariant> nextRowValues;
+                SqlResultsRow::ColumnIndex colIndex;
+                QVector<QVariant> nextRowValues;
                 bool rowAvailable = false;
         };
 
@@ -576,23 +578,22 @@ bool AbstractDb2<T>::Query::execInternal(const QList<QVariant>& args)
     if (!checkDbState())
         return false;
 
-    ReadWriteLocker locker(&(db->dbOperLock), query, Dialect::Sqlite2, flags.testFlag(Db::Flag::NO_LOCK));
+    ReadWriteLocker locker(&(db->dbOperLock), getLockingMode(Dialect::Sqlite2));
 
     logSql(db.data(), query, args, flags);
 
-    QueryWithParamCount queryWithParams = getQueryWithParamCount(query, Dialect::Sqlite2);
-    QString singleStr = replaceNamedParams(queryWithParams.first);
+    QueryMetadataPtr queryMetadata = getMetadata(Dialect::Sqlite2);
 
     int res;
     if (stmt)
         res = resetStmt();
     else
-        res = prepareStmt(singleStr);
+        res = prepareStmt(replaceNamedParams(query));
 
     if (res != SQLITE_OK)
         return false;
 
-    for (int paramIdx = 1; paramIdx <= queryWithParams.second; paramIdx++)
+    for (int paramIdx = 1; paramIdx <= queryMetadata->paramCount; paramIdx++)
     {
         res = bindParam(paramIdx, args[paramIdx-1]);
         if (res != SQLITE_OK)
@@ -601,7 +602,7 @@ bool AbstractDb2<T>::Query::execInternal(const QList<QVariant>& args)
 
     bool ok = (fetchFirst() == SQLITE_OK);
     if (ok && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
-        db->checkForDroppedObject(query);
+        db->checkForDroppedObject(queryMetadata);
 
     return ok;
 }
@@ -612,24 +613,23 @@ bool AbstractDb2<T>::Query::execInternal(const QHash<QString, QVariant>& args)
     if (!checkDbState())
         return false;
 
-    ReadWriteLocker locker(&(db->dbOperLock), query, Dialect::Sqlite2, flags.testFlag(Db::Flag::NO_LOCK));
+    ReadWriteLocker locker(&(db->dbOperLock), getLockingMode(Dialect::Sqlite2));
 
     logSql(db.data(), query, args, flags);
 
-    QueryWithParamNames queryWithParams = getQueryWithParamNames(query, Dialect::Sqlite2);
-    QString singleStr = replaceNamedParams(queryWithParams.first);
+    QueryMetadataPtr queryMetadata = getMetadata(Dialect::Sqlite2);
 
     int res;
     if (stmt)
         res = resetStmt();
     else
-        res = prepareStmt(singleStr);
+        res = prepareStmt(replaceNamedParams(query));
 
     if (res != SQLITE_OK)
         return false;
 
     int paramIdx = 1;
-    foreach (const QString& paramName, queryWithParams.second)
+    foreach (const QString& paramName, queryMetadata->paramNames)
     {
         if (!args.contains(paramName))
         {
@@ -644,7 +644,7 @@ bool AbstractDb2<T>::Query::execInternal(const QHash<QString, QVariant>& args)
 
     bool ok = (fetchFirst() == SQLITE_OK);
     if (ok && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
-        db->checkForDroppedObject(query);
+        db->checkForDroppedObject(queryMetadata);
 
     return ok;
 }
@@ -724,18 +724,16 @@ SqlResultsRowPtr AbstractDb2<T>::Query::nextInternal()
     if (!rowAvailable || db.isNull())
         return SqlResultsRowPtr();
 
-    ReadWriteLocker locker(&(db->dbOperLock), query, Dialect::Sqlite2, flags.testFlag(Db::Flag::NO_LOCK));
+    ReadWriteLocker locker(&(db->dbOperLock), getLockingMode(Dialect::Sqlite2));
 
-    Row* row = new Row;
-    row->init(colNames, nextRowValues);
+    QSharedPointer<Row> row = QSharedPointer<Row>::create();
+    row->init(colIndex, nextRowValues);
 
     int res = fetchNext();
     if (res != SQLITE_OK)
-    {
-        delete row;
         return SqlResultsRowPtr();
-    }
-    return SqlResultsRowPtr(row);
+
+    return row;
 }
 
 template <class T>
@@ -813,14 +811,22 @@ int AbstractDb2<T>::Query::fetchNext()
     int columnsCount;
 
     int res;
-    int secondsSpent = 0;
-    while ((res = sqlite_step(stmt, &columnsCount, &values, &columns)) == SQLITE_BUSY && secondsSpent < db->getTimeout())
+    int retries = 0;
+    QElapsedTimer busyTimer;
+    while ((res = sqlite_step(stmt, &columnsCount, &values, &columns)) == SQLITE_BUSY)
     {
-        QThread::sleep(1);
-        if (db->getTimeout() >= 0)
-            secondsSpent++;
+        if (!busyTimer.isValid())
+            busyTimer.start();
+
+        if (!db->waitWhileBusy(retries, busyTimer.elapsed()))
+            break;
+
+        retries++;
     }
 
+    if (busyTimer.isValid())
+        db->registerBusyWait(retries, busyTimer.elapsed(), res == SQLITE_BUSY);
+
     switch (res)
     {
         case SQLITE_ROW:
@@ -842,6 +848,7 @@ int AbstractDb2<T>::Query::fetchNext()
     nextRowValues.clear();
     if (rowAvailable)
     {
+        nextRowValues.reserve(colCount);
         for (int i = 0; i < colCount; i++)
         {
             if (isBinaryColumn(i))
@@ -858,6 +865,7 @@ template <class T>
 void AbstractDb2<T>::Query::init(int columnsCount, const char** columns)
 {
     colCount = columnsCount;
+    colNames.clear();
 
     TokenList columnDescription;
     for (int i = 0; i < colCount; i++)
@@ -877,6 +885,7 @@ void AbstractDb2<T>::Query::init(int columnsCount, const char** columns)
         else
             colNames << "";
     }
+    colIndex = SqlResultsRow::createColumnIndex(colNames);
 }
 
 //------------------------------------------------------------------------------------
@@ -884,13 +893,10 @@ void AbstractDb2<T>::Query::init(int columnsCount, const char** columns)
 //------------------------------------------------------------------------------------
 
 template <class T>
-void AbstractDb2<T>::Query::Row::init(const QStringList& columns, const QList<QVariant>& resultValues)
+void AbstractDb2<T>::Query::Row::init(const ColumnIndex& columns, const QVector<QVariant>& resultValues)
 {
-    for (int i = 0; i < columns.size(); i++)
-    {
-        values << resultValues[i];
-        valuesMap[columns[i]] = resultValues[i];
-    }
+    columnIndex = columns;
+    values = resultValues;
 }
 
 #endif // ABSTRACTDB2_H
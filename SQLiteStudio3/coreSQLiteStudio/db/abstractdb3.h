@@ -11,6 +11,10 @@
 #include "log.h"
 #include <QThread>
 #include <QPointer>
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
 #include <QDebug>
 
 /**
@@ -61,6 +65,24 @@ class AbstractDb3 : public AbstractDb
         bool registerCollationInternal(const QString& name);
         bool deregisterCollationInternal(const QString& name);
 
+        /**
+         * @brief Tells whether this database can execute read-only queries on separate reader connections.
+         * @return true if reader connections can be used, or false otherwise.
+         *
+         * Queries executed with Db::Flag::USE_READER can run on one of read-only connections
+         * kept in a pool, instead of the main connection. This way they run in parallel with queries executed
+         * on the main connection (like results counting, or exporting, while the user keeps working with the database).
+         *
+         * Even if this returns true, readers are used only when the database is in WAL mode (where readers
+         * don't block writing to the database) and when the main connection has no temporary objects
+         * and no attached databases, as readers don't see those.
+         *
+         * Reader connections are opened just like the main connection, without any further initialization,
+         * so implementations which need to initialize connection (for example with an encryption key)
+         * should keep the default, which is false.
+         */
+        virtual bool isReaderPoolSupported() const;
+
     private:
         class Query : public SqlQuery
         {
@@ -68,7 +90,7 @@ class AbstractDb3 : public AbstractDb
                 class Row : public SqlResultsRow
                 {
                     public:
-                        int init(const QStringList& columns, typename T::stmt* stmt, Db::Flags flags);
+                        int init(const ColumnIndex& columns, int columnCount, typename T::stmt* stmt, Db::Flags flags);
 
                     private:
                         int getValue(typename T::stmt* stmt, int col, QVariant& value, Db::Flags flags);
@@ -87,6 +109,7 @@ class AbstractDb3 : public AbstractDb
             protected:
                 SqlResultsRowPtr nextInternal();
                 bool hasNextInternal();
+                void nextBatchInternal(SqlResultsRowBlock& block, int maxRows);
                 bool execInternal(const QList<QVariant>& args);
                 bool execInternal(const QHash<QString, QVariant>& args);
 
@@ -97,16 +120,27 @@ class AbstractDb3 : public AbstractDb
                 int fetchFirst();
                 int fetchNext();
                 bool checkDbState();
+                bool prepareOnReader();
+                void releaseReader(bool reusable);
+                typename T::handle* getHandle() const;
+                void copyErrorFromHandle();
                 void copyErrorFromDb();
                 void copyErrorToDb();
                 void setError(int code, const QString& msg);
 
                 QPointer<AbstractDb3<T>> db;
                 typename T::stmt* stmt = nullptr;
+
+                /**
+                 * @brief Reader connection that the statement was prepared on, or null if it's the main connection.
+                 */
+                typename T::handle* reader = nullptr;
+
                 int errorCode = T::OK;
                 QString errorMessage;
                 int colCount = 0;
                 QStringList colNames;
+                SqlResultsRow::ColumnIndex colIndex;
                 bool rowAvailable = false;
         };
 
@@ -116,6 +150,18 @@ class AbstractDb3 : public AbstractDb
             AbstractDb3<T>* db = nullptr;
         };
 
+        /**
+         * @brief Prepared statement waiting in the statement cache.
+         *
+         * The statement is finalized when the entry is evicted from the cache, or when the cache is cleared.
+         */
+        struct CachedStmt
+        {
+            ~CachedStmt();
+
+            typename T::stmt* stmt = nullptr;
+        };
+
         QString extractLastError();
         void cleanUp();
         void resetError();
@@ -284,6 +330,75 @@ class AbstractDb3 : public AbstractDb
          */
         static int evaluateDefaultCollation(void* userData, int length1, const void* value1, int length2, const void* value2);
 
+        /**
+         * @brief Takes prepared statement for given query out of the statement cache.
+         * @param query Query to get statement for.
+         * @return Prepared statement (already reset and with no bindings), or null if there was none cached.
+         *
+         * Returned statement is no longer in the cache, so it's owned exclusively by the caller,
+         * until it's given back with cacheStmt(). Updates cache hit/miss counters.
+         */
+        typename T::stmt* takeCachedStmt(const QString& query);
+
+        /**
+         * @brief Gives prepared statement to the statement cache, instead of finalizing it.
+         * @param query Query of the statement.
+         * @param stmt Statement to cache.
+         *
+         * The statement is reset and its bindings are cleared, so it doesn't hold any locks or values
+         * while it's waiting in the cache. If the database is closed, the statement is finalized.
+         */
+        void cacheStmt(const QString& query, typename T::stmt* stmt);
+
+        /**
+         * @brief Finalizes all cached statements.
+         *
+         * Called when the database is being closed and after the schema was modified.
+         */
+        void clearStmtCache();
+
+        /**
+         * @brief Takes reader connection out of the pool, or opens a new one.
+         * @return Reader connection handle, or null if readers cannot be used at the moment.
+         *
+         * Readers are not used while the main connection is in the middle of a transaction,
+         * because they wouldn't see changes not yet committed by the main connection.
+         * Returned reader has to be given back with releaseReader().
+         */
+        typename T::handle* takeReader();
+
+        /**
+         * @brief Gives reader connection back to the pool.
+         * @param handle Reader connection handle.
+         * @param reusable false if the connection shouldn't be used anymore.
+         *
+         * If the main connection is closed, or the reader is not reusable, then the reader is closed.
+         */
+        void releaseReader(typename T::handle* handle, bool reusable);
+
+        /**
+         * @brief Closes all idle reader connections.
+         */
+        void closeReaders();
+
+        /**
+         * @brief Checks if reader connections can be used with the current state of the main connection.
+         *
+         * It's called after the database was opened, after each statement that modified the schema
+         * (as it could have attached database, or created temporary object) and after each PRAGMA that set the journal mode.
+         */
+        void updateReaderPoolState();
+
+        /**
+         * @brief Maximum number of prepared statements kept in the statement cache.
+         */
+        static const int stmtCacheSize = 50;
+
+        /**
+         * @brief Maximum number of reader connections open at the same time.
+         */
+        static const int readerPoolSize = 4;
+
         typename T::handle* dbHandle = nullptr;
         QString dbErrorMessage;
         int dbErrorCode = T::OK;
@@ -296,6 +411,40 @@ class AbstractDb3 : public AbstractDb
          * and delete it when database is closed.
          */
         CollationUserData* defaultCollationUserData = nullptr;
+
+        /**
+         * @brief LRU cache of prepared statements, keyed by query string.
+         *
+         * Statements are taken out of the cache by Query::prepareStmt() and given back when Query is deleted,
+         * so the same query string executed again doesn't need to be compiled by SQLite again.
+         */
+        QCache<QString,CachedStmt> stmtCache;
+
+        /**
+         * @brief Guards stmtCache, as queries can be created and deleted from different threads.
+         */
+        QMutex stmtCacheMutex;
+
+        /**
+         * @brief Reader connections waiting in the pool to be used.
+         */
+        QList<typename T::handle*> idleReaders;
+
+        /**
+         * @brief Reader connections currently used by queries.
+         */
+        QList<typename T::handle*> busyReaders;
+
+        /**
+         * @brief Tells whether readers can be used with the current state of the main connection.
+         * @see updateReaderPoolState()
+         */
+        bool readersUsable = false;
+
+        /**
+         * @brief Guards reader pool members, as readers are taken and released from different threads.
+         */
+        QMutex readerPoolMutex;
 };
 
 //------------------------------------------------------------------------------------
@@ -304,7 +453,7 @@ class AbstractDb3 : public AbstractDb
 
 template <class T>
 AbstractDb3<T>::AbstractDb3(const QString& name, const QString& path, const QHash<QString, QVariant>& connOptions) :
-    AbstractDb(name, path, connOptions)
+    AbstractDb(name, path, connOptions), stmtCache(stmtCacheSize)
 {
 }
 
@@ -328,6 +477,10 @@ void AbstractDb3<T>::interruptExecution()
         return;
 
     T::interrupt(dbHandle);
+
+    QMutexLocker locker(&readerPoolMutex);
+    for (typename T::handle* reader : busyReaders)
+        T::interrupt(reader);
 }
 
 template <class T>
@@ -396,6 +549,7 @@ void AbstractDb3<T>::initAfterOpen()
     registerDefaultCollationRequestHandler();;
     exec("PRAGMA foreign_keys = 1;", Flag::NO_LOCK);
     exec("PRAGMA recursive_triggers = 1;", Flag::NO_LOCK);
+    updateReaderPoolState();
 }
 
 template <class T>
@@ -485,6 +639,12 @@ bool AbstractDb3<T>::deregisterCollationInternal(const QString& name)
     return true;
 }
 
+template <class T>
+bool AbstractDb3<T>::isReaderPoolSupported() const
+{
+    return false;
+}
+
 template <class T>
 QString AbstractDb3<T>::extractLastError()
 {
@@ -496,12 +656,151 @@ QString AbstractDb3<T>::extractLastError()
 template <class T>
 void AbstractDb3<T>::cleanUp()
 {
+    clearStmtCache();
     for (Query* q : queries)
         q->finalize();
 
+    closeReaders();
     safe_delete(defaultCollationUserData);
 }
 
+template <class T>
+typename T::stmt* AbstractDb3<T>::takeCachedStmt(const QString& query)
+{
+    QMutexLocker locker(&stmtCacheMutex);
+    CachedStmt* cached = stmtCache.take(query);
+    if (!cached)
+    {
+        stmtCacheMisses++;
+        return nullptr;
+    }
+
+    stmtCacheHits++;
+    typename T::stmt* stmt = cached->stmt;
+    cached->stmt = nullptr;
+    delete cached;
+    return stmt;
+}
+
+template <class T>
+void AbstractDb3<T>::cacheStmt(const QString& query, typename T::stmt* stmt)
+{
+    if (!dbHandle)
+    {
+        T::finalize(stmt);
+        return;
+    }
+
+    T::reset(stmt);
+    T::clear_bindings(stmt);
+
+    CachedStmt* cached = new CachedStmt;
+    cached->stmt = stmt;
+
+    QMutexLocker locker(&stmtCacheMutex);
+    stmtCache.insert(query, cached);
+}
+
+template <class T>
+void AbstractDb3<T>::clearStmtCache()
+{
+    QMutexLocker locker(&stmtCacheMutex);
+    stmtCache.clear();
+}
+
+template <class T>
+typename T::handle* AbstractDb3<T>::takeReader()
+{
+    if (!dbHandle || !T::get_autocommit(dbHandle))
+        return nullptr;
+
+    QMutexLocker locker(&readerPoolMutex);
+    if (!readersUsable)
+        return nullptr;
+
+    typename T::handle* handle = nullptr;
+    if (!idleReaders.isEmpty())
+    {
+        handle = idleReaders.takeLast();
+    }
+    else
+    {
+        if (busyReaders.size() >= readerPoolSize)
+            return nullptr;
+
+        int res = T::open_v2(path.toUtf8().constData(), &handle, T::OPEN_READONLY, nullptr);
+        if (res != T::OK)
+        {
+            qWarning() << "Could not open reader connection for database" << name << ":" << (handle ? T::errmsg(handle) : "");
+            if (handle)
+                T::close(handle);
+
+            return nullptr;
+        }
+    }
+
+    busyReaders << handle;
+    return handle;
+}
+
+template <class T>
+void AbstractDb3<T>::releaseReader(typename T::handle* handle, bool reusable)
+{
+    QMutexLocker locker(&readerPoolMutex);
+    busyReaders.removeOne(handle);
+    if (dbHandle && readersUsable && reusable)
+    {
+        idleReaders << handle;
+        return;
+    }
+
+    T::close(handle);
+}
+
+template <class T>
+void AbstractDb3<T>::closeReaders()
+{
+    QMutexLocker locker(&readerPoolMutex);
+    for (typename T::handle* handle : idleReaders)
+        T::close(handle);
+
+    idleReaders.clear();
+}
+
+template <class T>
+void AbstractDb3<T>::updateReaderPoolState()
+{
+    bool usable = false;
+    if (isReaderPoolSupported())
+    {
+        // Readers don't block writers (and the other way around) only in WAL mode.
+        // They also don't see temporary objects and attached databases of the main connection.
+        QString journalMode = exec("PRAGMA journal_mode;", Flag::NO_LOCK)->getSingleCell().toString();
+        if (journalMode.toLower() == "wal" && exec("SELECT count(*) FROM temp.sqlite_master;", Flag::NO_LOCK)->getSingleCell().toInt() == 0)
+        {
+            QStringList dbNames = exec("PRAGMA database_list;", Flag::NO_LOCK)->columnAsList<QString>("name");
+            dbNames.removeAll("main");
+            dbNames.removeAll("temp");
+            usable = dbNames.isEmpty();
+        }
+    }
+
+    {
+        QMutexLocker locker(&readerPoolMutex);
+        readersUsable = usable;
+    }
+
+    if (!usable)
+        closeReaders();
+}
+
+template <class T>
+AbstractDb3<T>::CachedStmt::~CachedStmt()
+{
+    if (stmt)
+        T::finalize(stmt);
+}
+
 template <class T>
 void AbstractDb3<T>::resetError()
 {
@@ -783,10 +1082,36 @@ AbstractDb3<T>::Query::~Query()
     if (db.isNull())
         return;
 
-    finalize();
+    if (stmt && reader)
+    {
+        T::finalize(stmt);
+        stmt = nullptr;
+    }
+
+    if (reader)
+        releaseReader(true);
+
+    if (stmt)
+    {
+        db->cacheStmt(query, stmt);
+        stmt = nullptr;
+    }
     db->queries.removeOne(this);
 }
 
+template <class T>
+void AbstractDb3<T>::Query::copyErrorFromHandle()
+{
+    if (reader)
+    {
+        setError(T::extended_errcode(reader), QString::fromUtf8(T::errmsg(reader)));
+        return;
+    }
+
+    db->extractLastError();
+    copyErrorFromDb();
+}
+
 template <class T>
 void AbstractDb3<T>::Query::copyErrorFromDb()
 {
@@ -819,6 +1144,10 @@ void AbstractDb3<T>::Query::setError(int code, const QString& msg)
 template <class T>
 int AbstractDb3<T>::Query::prepareStmt()
 {
+    stmt = db->takeCachedStmt(query);
+    if (stmt)
+        return T::OK;
+
     const char* tail;
     QByteArray queryBytes = query.toUtf8();
     int res = T::prepare_v2(db->dbHandle, queryBytes.constData(), queryBytes.size(), &stmt, &tail);
@@ -836,6 +1165,46 @@ int AbstractDb3<T>::Query::prepareStmt()
     return T::OK;
 }
 
+template <class T>
+bool AbstractDb3<T>::Query::prepareOnReader()
+{
+    // Journal mode has to be changed on the main connection, even though the PRAGMA is a read query
+    QueryMetadataPtr metadata = getMetadata(Dialect::Sqlite3);
+    if (!flags.testFlag(Db::Flag::USE_READER) || metadata->accessMode != QueryAccessMode::READ || metadata->journalModeChange)
+        return false;
+
+    reader = db->takeReader();
+    if (!reader)
+        return false;
+
+    const char* tail;
+    QByteArray queryBytes = query.toUtf8();
+    int res = T::prepare_v2(reader, queryBytes.constData(), queryBytes.size(), &stmt, &tail);
+    if (res != T::OK)
+    {
+        // Most likely the query uses something that exists only in the main connection, like a custom function.
+        // Nothing wrong with it, the query will be executed on the main connection.
+        stmt = nullptr;
+        releaseReader(true);
+        return false;
+    }
+
+    return true;
+}
+
+template <class T>
+void AbstractDb3<T>::Query::releaseReader(bool reusable)
+{
+    db->releaseReader(reader, reusable);
+    reader = nullptr;
+}
+
+template <class T>
+typename T::handle* AbstractDb3<T>::Query::getHandle() const
+{
+    return reader ? reader : db->dbHandle;
+}
+
 template <class T>
 int AbstractDb3<T>::Query::resetStmt()
 {
@@ -849,7 +1218,7 @@ int AbstractDb3<T>::Query::resetStmt()
     if (res != T::OK)
     {
         stmt = nullptr;
-        setError(res, QString::fromUtf8(T::errmsg(db->dbHandle)));
+        setError(res, QString::fromUtf8(T::errmsg(getHandle())));
         return res;
     }
     return T::OK;
@@ -861,11 +1230,11 @@ bool AbstractDb3<T>::Query::execInternal(const QList<QVariant>& args)
     if (!checkDbState())
         return false;
 
-    ReadWriteLocker locker(&(db->dbOperLock), query, Dialect::Sqlite3, flags.testFlag(Db::Flag::NO_LOCK));
+    // Queries executed on reader connection don't need to lock the main connection.
+    bool onReader = reader || (!stmt && prepareOnReader());
+    ReadWriteLocker locker(&(db->dbOperLock), onReader ? ReadWriteLocker::NONE : getLockingMode(Dialect::Sqlite3));
     logSql(db.data(), query, args, flags);
 
-    QueryWithParamCount queryWithParams = getQueryWithParamCount(query, Dialect::Sqlite3);
-
     int res;
     if (stmt)
         res = resetStmt();
@@ -875,21 +1244,31 @@ bool AbstractDb3<T>::Query::execInternal(const QList<QVariant>& args)
     if (res != T::OK)
         return false;
 
-
-    for (int paramIdx = 1, argCount = args.size(); paramIdx <= queryWithParams.second && paramIdx <= argCount; paramIdx++)
+    // Parameter count is provided by the driver, so there's no need to tokenize the query for it.
+    int paramCount = T::bind_parameter_count(stmt);
+    for (int paramIdx = 1, argCount = args.size(); paramIdx <= paramCount && paramIdx <= argCount; paramIdx++)
     {
         res = bindParam(paramIdx, args[paramIdx-1]);
         if (res != T::OK)
         {
-            db->extractLastError();
-            copyErrorFromDb();
+            copyErrorFromHandle();
             return false;
         }
     }
 
     bool ok = (fetchFirst() == T::OK);
+    if (ok && getMetadata(Dialect::Sqlite3)->schemaChange)
+    {
+        db->clearStmtCache();
+        db->updateReaderPoolState();
+    }
+    else if (ok && getMetadata(Dialect::Sqlite3)->journalModeChange)
+    {
+        db->updateReaderPoolState();
+    }
+
     if (ok && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
-        db->checkForDroppedObject(query);
+        db->checkForDroppedObject(getMetadata(Dialect::Sqlite3));
 
     return ok;
 }
@@ -900,11 +1279,11 @@ bool AbstractDb3<T>::Query::execInternal(const QHash<QString, QVariant>& args)
     if (!checkDbState())
         return false;
 
-    ReadWriteLocker locker(&(db->dbOperLock), query, Dialect::Sqlite3, flags.testFlag(Db::Flag::NO_LOCK));
+    // Queries executed on reader connection don't need to lock the main connection.
+    bool onReader = reader || (!stmt && prepareOnReader());
+    ReadWriteLocker locker(&(db->dbOperLock), onReader ? ReadWriteLocker::NONE : getLockingMode(Dialect::Sqlite3));
     logSql(db.data(), query, args, flags);
 
-    QueryWithParamNames queryWithParams = getQueryWithParamNames(query, Dialect::Sqlite3);
-
     int res;
     if (stmt)
         res = resetStmt();
@@ -914,9 +1293,18 @@ bool AbstractDb3<T>::Query::execInternal(const QHash<QString, QVariant>& args)
     if (res != T::OK)
         return false;
 
-    int paramIdx = -1;
-    for (const QString& paramName : queryWithParams.second)
+    // Parameter names are provided by the driver, so there's no need to tokenize the query for them.
+    // Nameless slots (like the ones skipped by "?3") are reported by the driver as null. They cannot be referenced by name,
+    // so they are left unbound, just like SQLite leaves them when parameters are bound by name.
+    const char* paramNameBytes = nullptr;
+    QString paramName;
+    for (int paramIdx = 1, paramCount = T::bind_parameter_count(stmt); paramIdx <= paramCount; paramIdx++)
     {
+        paramNameBytes = T::bind_parameter_name(stmt, paramIdx);
+        if (!paramNameBytes)
+            continue;
+
+        paramName = QString::fromUtf8(paramNameBytes);
         if (!args.contains(paramName))
         {
             qWarning() << "Could not bind parameter" << paramName << "because it was not found in passed arguments.";
@@ -924,26 +1312,27 @@ bool AbstractDb3<T>::Query::execInternal(const QHash<QString, QVariant>& args)
             return false;
         }
 
-        paramIdx = T::bind_parameter_index(stmt, paramName.toUtf8().constData());
-        if (paramIdx <= 0)
-        {
-            qWarning() << "Could not bind parameter" << paramName << "because it was not found in prepared statement.";
-            setError(SqlErrorCode::OTHER_EXECUTION_ERROR, "Error while preparing statement: could not bind parameter " + paramName);
-            return false;
-        }
-
         res = bindParam(paramIdx, args[paramName]);
         if (res != T::OK)
         {
-            db->extractLastError();
-            copyErrorFromDb();
+            copyErrorFromHandle();
             return false;
         }
     }
 
     bool ok = (fetchFirst() == T::OK);
+    if (ok && getMetadata(Dialect::Sqlite3)->schemaChange)
+    {
+        db->clearStmtCache();
+        db->updateReaderPoolState();
+    }
+    else if (ok && getMetadata(Dialect::Sqlite3)->journalModeChange)
+    {
+        db->updateReaderPoolState();
+    }
+
     if (ok && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
-        db->checkForDroppedObject(query);
+        db->checkForDroppedObject(getMetadata(Dialect::Sqlite3));
 
     return ok;
 }
@@ -1008,6 +1397,9 @@ void AbstractDb3<T>::Query::finalize()
         T::finalize(stmt);
         stmt = nullptr;
     }
+
+    if (reader)
+        releaseReader(true);
 }
 
 template <class T>
@@ -1043,23 +1435,20 @@ qint64 AbstractDb3<T>::Query::rowsAffected()
 template <class T>
 SqlResultsRowPtr AbstractDb3<T>::Query::nextInternal()
 {
-    Row* row = new Row;
-    int res = row->init(colNames, stmt, flags);
+    // Single allocation for both the row and the reference counter.
+    QSharedPointer<Row> row = QSharedPointer<Row>::create();
+    int res = row->init(colIndex, colCount, stmt, flags);
     if (res != T::OK)
     {
-        delete row;
-        setError(res, QString::fromUtf8(T::errmsg(db->dbHandle)));
+        setError(res, QString::fromUtf8(T::errmsg(getHandle())));
         return SqlResultsRowPtr();
     }
 
     res = fetchNext();
     if (res != T::OK)
-    {
-        delete row;
         return SqlResultsRowPtr();
-    }
 
-    return SqlResultsRowPtr(row);
+    return row;
 }
 
 template <class T>
@@ -1068,22 +1457,43 @@ bool AbstractDb3<T>::Query::hasNextInternal()
     return rowAvailable && stmt && checkDbState();
 }
 
+template <class T>
+void AbstractDb3<T>::Query::nextBatchInternal(SqlResultsRowBlock& block, int maxRows)
+{
+    // Not going through hasNextInternal() for every row, as fetchNext() already checks database state with each step.
+    if (!checkDbState())
+        return;
+
+    SqlResultsRowPtr row;
+    while (block.size() < maxRows && rowAvailable && stmt)
+    {
+        row = nextInternal();
+        if (row.isNull())
+            break;
+
+        block << row;
+    }
+}
+
 template <class T>
 int AbstractDb3<T>::Query::fetchFirst()
 {
     colCount = T::column_count(stmt);
+    colNames.clear();
     for (int i = 0; i < colCount; i++)
         colNames << QString::fromUtf8(T::column_name(stmt, i));
 
-    int changesBefore =  T::total_changes(db->dbHandle);
+    colIndex = SqlResultsRow::createColumnIndex(colNames);
+
+    int changesBefore =  T::total_changes(getHandle());
     rowAvailable = true;
     int res = fetchNext();
 
     affected = 0;
     if (res == T::OK)
     {
-        affected =  T::total_changes(db->dbHandle) - changesBefore;
-        insertRowId["ROWID"] = T::last_insert_rowid(db->dbHandle);
+        affected =  T::total_changes(getHandle()) - changesBefore;
+        insertRowId["ROWID"] = T::last_insert_rowid(getHandle());
     }
 
     return res;
@@ -1103,14 +1513,22 @@ int AbstractDb3<T>::Query::fetchNext()
 
     rowAvailable = false;
     int res;
-    int secondsSpent = 0;
-    while ((res = T::step(stmt)) == T::BUSY && secondsSpent < db->getTimeout())
+    int retries = 0;
+    QElapsedTimer busyTimer;
+    while ((res = T::step(stmt)) == T::BUSY)
     {
-        QThread::sleep(1);
-        if (db->getTimeout() >= 0)
-            secondsSpent++;
+        if (!busyTimer.isValid())
+            busyTimer.start();
+
+        if (!db->waitWhileBusy(retries, busyTimer.elapsed()))
+            break;
+
+        retries++;
     }
 
+    if (busyTimer.isValid())
+        db->registerBusyWait(retries, busyTimer.elapsed(), res == T::BUSY);
+
     switch (res)
     {
         case T::ROW:
@@ -1120,7 +1538,7 @@ int AbstractDb3<T>::Query::fetchNext()
             // Empty pointer as no more results are available.
             break;
         default:
-            setError(res, QString::fromUtf8(T::errmsg(db->dbHandle)));
+            setError(res, QString::fromUtf8(T::errmsg(getHandle())));
             return T::ERROR;
     }
     return T::OK;
@@ -1131,18 +1549,17 @@ int AbstractDb3<T>::Query::fetchNext()
 //------------------------------------------------------------------------------------
 
 template <class T>
-int AbstractDb3<T>::Query::Row::init(const QStringList& columns, typename T::stmt* stmt, Db::Flags flags)
+int AbstractDb3<T>::Query::Row::init(const ColumnIndex& columns, int columnCount, typename T::stmt* stmt, Db::Flags flags)
 {
+    columnIndex = columns;
+    values.resize(columnCount);
+
     int res = T::OK;
-    QVariant value;
-    for (int i = 0; i < columns.size(); i++)
+    for (int i = 0; i < columnCount; i++)
     {
-        res = getValue(stmt, i, value, flags);
+        res = getValue(stmt, i, values[i], flags);
         if (res != T::OK)
             return res;
-
-        values << value;
-        valuesMap[columns[i]] = value;
     }
     return res;
 }
@@ -149,6 +149,12 @@ class API_EXPORT Db : public QObject, public Interruptable
                                         * or when you implement SqlFunctionPlugin. Don't use it for the usual cases.
                                         */
             SKIP_DROP_DETECTION = 0x4, /**< Query execution will not notify about any detected objects dropped by the query. */
+            USE_READER          = 0x8, /**<
+                                        * Allows read-only query to be executed on a separate, read-only connection to the database,
+                                        * so it doesn't wait for (and doesn't block) other queries executed on this database.
+                                        * It's just a hint. If the database doesn't provide such connections at the moment
+                                        * (see AbstractDb3::isReaderPoolSupported()), the query is executed as usual.
+                                        */
         };
         Q_DECLARE_FLAGS(Flags, Flag)
 
@@ -268,6 +274,7 @@ class API_EXPORT Db : public QObject, public Interruptable
          *
          * When the database is locked by another application, then the SQLiteStudio will wait given number
          * of seconds for the database to be released, before the execution error is reported.
+         * Query is retried with increasing delays (starting with microseconds), so short locks don't delay it much.
          *
          * Set it to negative value to set infinite timeout.
          *
@@ -9,3 +9,8 @@ DbSqlite3::DbSqlite3(const QString& name, const QString& path) :
     DbSqlite3(name, path, QHash<QString,QVariant>())
 {
 }
+
+bool DbSqlite3::isReaderPoolSupported() const
+{
+    return true;
+}
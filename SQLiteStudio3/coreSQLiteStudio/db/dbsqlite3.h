@@ -28,6 +28,9 @@ class API_EXPORT DbSqlite3 : public AbstractDb3<Sqlite3>
          * @overload
          */
         DbSqlite3(const QString& name, const QString& path);
+
+    protected:
+        bool isReaderPoolSupported() const;
 };
 
 #endif // DBSQLITE3_H
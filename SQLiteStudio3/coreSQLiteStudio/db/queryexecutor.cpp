@@ -1,6 +1,7 @@
 #include "queryexecutor.h"
 #include "sqlerrorresults.h"
 #include "sqlerrorcodes.h"
+#include "querymetadata.h"
 #include "services/dbmanager.h"
 #include "db/sqlerrorcodes.h"
 #include "services/notifymanager.h"
@@ -24,6 +25,7 @@
 #include "log.h"
 #include <QMutexLocker>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QThreadPool>
 #include <QDebug>
 #include <schemaresolver.h>
@@ -34,7 +36,7 @@
 // TODO modify all executor steps to use rebuildTokensFromContents() method, instead of replacing tokens manually.
 
 QueryExecutor::QueryExecutor(Db* db, const QString& query, QObject *parent) :
-    QObject(parent)
+    QObject(parent), rowCountCache(rowCountCacheSize), executionPlanCache(executionPlanCacheSize)
 {
     context = new Context();
     simpleExecutor = new ChainExecutor(this);
@@ -58,21 +60,28 @@ QueryExecutor::~QueryExecutor()
 
 void QueryExecutor::setupExecutionChain()
 {
-    executionChain << new QueryExecutorParseQuery("initial")
-                   << new QueryExecutorDetectSchemaAlter()
-                   << new QueryExecutorExplainMode()
-                   << new QueryExecutorValuesMode()
-                   << new QueryExecutorAttaches() // needs to be at the begining, because columns needs to know real databases
-                   << new QueryExecutorParseQuery("after Attaches")
-                   << new QueryExecutorDataSources()
-                   << new QueryExecutorReplaceViews()
-                   << new QueryExecutorParseQuery("after ReplaceViews")
-                   << new QueryExecutorAddRowIds()
-                   << new QueryExecutorParseQuery("after AddRowIds")
-                   << new QueryExecutorColumns()
-                   << new QueryExecutorParseQuery("after Columns")
-                   //<< new QueryExecutorColumnAliases()
-                   << new QueryExecutorOrder()
+    executionPlanStep = nullptr;
+    if (!restoreExecutionPlan())
+    {
+        executionPlanStep = new QueryExecutorParseQuery("after Columns");
+        executionChain << new QueryExecutorParseQuery("initial")
+                       << new QueryExecutorDetectSchemaAlter()
+                       << new QueryExecutorExplainMode()
+                       << new QueryExecutorValuesMode()
+                       << new QueryExecutorAttaches() // needs to be at the begining, because columns needs to know real databases
+                       << new QueryExecutorParseQuery("after Attaches")
+                       << new QueryExecutorDataSources()
+                       << new QueryExecutorReplaceViews()
+                       << new QueryExecutorParseQuery("after ReplaceViews")
+                       << new QueryExecutorAddRowIds()
+                       << new QueryExecutorParseQuery("after AddRowIds")
+                       << new QueryExecutorColumns()
+                       << executionPlanStep;
+    }
+
+    // Steps below depend on sorting, paging, etc, so they are never cached
+    //executionChain << new QueryExecutorColumnAliases();
+    executionChain << new QueryExecutorOrder()
                    << new QueryExecutorWrapDistinctResults()
                    << new QueryExecutorParseQuery("after WrapDistinctResults")
                    << new QueryExecutorCellSize()
@@ -92,12 +101,16 @@ void QueryExecutor::clearChain()
         delete step;
 
     executionChain.clear();
+    executionPlanStep = nullptr;
 }
 
 void QueryExecutor::executeChain()
 {
     // Go through all remaining steps
     bool result;
+    QElapsedTimer chainTimer;
+    QElapsedTimer stepTimer;
+    chainTimer.start();
     foreach (QueryExecutorStep* currentStep, executionChain)
     {
         if (isInterrupted())
@@ -107,7 +120,9 @@ void QueryExecutor::executeChain()
         }
 
         logExecutorStep(currentStep);
+        stepTimer.start();
         result = currentStep->exec();
+        logExecutorStepTime(currentStep, stepTimer.nsecsElapsed());
         logExecutorAfterStep(context->processedQuery);
 
         if (!result)
@@ -115,7 +130,11 @@ void QueryExecutor::executeChain()
             stepFailed(currentStep);
             return;
         }
+
+        if (currentStep == executionPlanStep)
+            storeExecutionPlan();
     }
+    logExecutorChainTime(executionChain.size(), chainTimer.nsecsElapsed());
 
     requiredDbAttaches = context->dbNameToAttach.leftValues();
 
@@ -143,6 +162,10 @@ void QueryExecutor::stepFailed(QueryExecutorStep* currentStep)
         return;
     }
 
+    // The cached plan might be outdated in a way that the schema version doesn't tell, so it's not used anymore
+    if (context->executionPlanFromCache)
+        executionPlanCache.remove(getExecutionPlanCacheKey());
+
     // Clear anything meaningful set up for smart execution - it's not valid anymore and misleads results for simple method
     context->rowIdColumns.clear();
 
@@ -167,6 +190,9 @@ void QueryExecutor::cleanupBeforeDbDestroy(Db* dbToBeUnloaded)
 
 void QueryExecutor::setQuery(const QString& query)
 {
+    if (query != originalQuery)
+        clearPageKeys();
+
     originalQuery = query;
 }
 
@@ -233,12 +259,11 @@ void QueryExecutor::execInternal()
     simpleExecution = false;
     interrupted = false;
 
-    if (resultsCountingAsyncId != 0)
-    {
-        resultsCountingAsyncId = 0;
-        db->interrupt();
-        releaseResultsAndCleanup();
-    }
+    cancelResultsCounting();
+
+    // Fresh results counting means that the data could have changed, so keys of pages are no longer valid
+    if (!skipRowCounting)
+        clearPageKeys();
 
     // Reset context
     delete context;
@@ -270,35 +295,76 @@ void QueryExecutor::interrupt()
 
 bool QueryExecutor::countResults()
 {
+    static_qstring(partialCountingTpl, "SELECT count(*) AS cnt FROM (SELECT 1 FROM (%1) LIMIT %2);");
+
     if (context->skipRowCounting)
         return false;
 
     if (context->countingQuery.isEmpty()) // simple method doesn't provide that
         return false;
 
+    context->countingDataVersion = getDataVersion();
+    if (!context->countingDataVersion.isNull())
+    {
+        CachedRowCount* cached = rowCountCache.object(getRowCountCacheKey());
+        if (cached && cached->dataVersion == context->countingDataVersion)
+        {
+            setTotalRows(cached->rows, RowCountAccuracy::EXACT);
+            {
+                QMutexLocker locker(&pageKeysMutex);
+                knownTotalRows = cached->rows;
+            }
+            emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages);
+            return !asyncMode;
+        }
+    }
+
+    if (countingMode == CountingMode::LAZY && resultsPerPage > 0 && page >= 0)
+    {
+        // The caller has loaded a full page, so there's at least that many rows. Exact number is counted on demand.
+        setTotalRows(static_cast<qint64>(page + 1) * resultsPerPage, RowCountAccuracy::LOWER_BOUND);
+        emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages);
+        return !asyncMode;
+    }
+
+    QString countingQuery = context->countingQuery;
+    context->partialCounting = (countingMode == CountingMode::ESTIMATED && !context->countedQuery.isEmpty());
+    if (context->partialCounting)
+    {
+        // One row more than the limit, so we know whether the limit was exceeded
+        countingQuery = partialCountingTpl.arg(context->countedQuery, QString::number(countingEstimateLimit + 1));
+    }
+
     if (asyncMode)
     {
         // Start asynchronous results counting query
-        resultsCountingAsyncId = db->asyncExec(context->countingQuery, context->queryParameters, Db::Flag::NO_LOCK);
+        resultsCountingAsyncId = db->asyncExec(countingQuery, context->queryParameters, Db::Flag::NO_LOCK|Db::Flag::USE_READER);
     }
     else
     {
-        SqlQueryPtr results = db->exec(context->countingQuery, context->queryParameters, Db::Flag::NO_LOCK);
-        context->totalRowsReturned = results->getSingleCell().toLongLong();
-        context->totalPages = (int)qCeil(((double)(context->totalRowsReturned)) / ((double)getResultsPerPage()));
-
-        emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages);
-
+        SqlQueryPtr results = db->exec(countingQuery, context->queryParameters, Db::Flag::NO_LOCK|Db::Flag::USE_READER);
+        applyCountingResults(results);
         if (results->isError())
-        {
-            notifyError(tr("An error occured while executing the count(*) query, thus data paging will be disabled. Error details from the database: %1")
-                        .arg(results->getErrorText()));
             return false;
-        }
     }
     return true;
 }
 
+bool QueryExecutor::isResultsCountingInProgress() const
+{
+    return resultsCountingAsyncId != 0;
+}
+
+void QueryExecutor::cancelResultsCounting()
+{
+    if (resultsCountingAsyncId == 0)
+        return;
+
+    resultsCountingAsyncId = 0;
+    db->interrupt();
+    releaseResultsAndCleanup();
+}
+
 void QueryExecutor::dbAsyncExecFinished(quint32 asyncId, SqlQueryPtr results)
 {
     if (handleRowCountingResults(asyncId, results))
@@ -322,6 +388,11 @@ qint64 QueryExecutor::getTotalRowsReturned() const
     return context->totalRowsReturned;
 }
 
+QueryExecutor::RowCountAccuracy QueryExecutor::getTotalRowsAccuracy() const
+{
+    return context->totalRowsAccuracy;
+}
+
 SqliteQueryType QueryExecutor::getExecutedQueryType(int index)
 {
     if (context->parsedQueries.size() == 0)
@@ -448,7 +519,10 @@ void QueryExecutor::simpleExecutionFinished(SqlQueryPtr results)
     context->executionTime = QDateTime::currentMSecsSinceEpoch() - simpleExecutionStartTime;
 
     if (simpleExecIsSelect())
-        context->countingQuery = "SELECT count(*) AS cnt FROM ("+trimQueryEnd(queriesForSimpleExecution.last())+");";
+    {
+        context->countedQuery = trimQueryEnd(queriesForSimpleExecution.last());
+        context->countingQuery = "SELECT count(*) AS cnt FROM ("+context->countedQuery+");";
+    }
     else
         context->rowsCountingRequired = true;
 
@@ -557,9 +631,42 @@ bool QueryExecutor::handleRowCountingResults(quint32 asyncId, SqlQueryPtr result
         return false;
 
     resultsCountingAsyncId = 0;
+    applyCountingResults(results);
+    return true;
+}
 
-    context->totalRowsReturned = results->getSingleCell().toLongLong();
-    context->totalPages = (int)qCeil(((double)(context->totalRowsReturned)) / ((double)getResultsPerPage()));
+void QueryExecutor::applyCountingResults(SqlQueryPtr results)
+{
+    qint64 rows = results->getSingleCell().toLongLong();
+    RowCountAccuracy accuracy = RowCountAccuracy::EXACT;
+    if (!results->isError() && context->partialCounting && rows > countingEstimateLimit)
+    {
+        accuracy = RowCountAccuracy::LOWER_BOUND;
+        qint64 estimated = estimateTotalRows();
+        if (estimated > rows)
+        {
+            rows = estimated;
+            accuracy = RowCountAccuracy::ESTIMATE;
+        }
+    }
+
+    setTotalRows(rows, accuracy);
+
+    if (!results->isError() && accuracy == RowCountAccuracy::EXACT)
+    {
+        {
+            QMutexLocker locker(&pageKeysMutex);
+            knownTotalRows = rows;
+        }
+
+        if (!context->countingDataVersion.isNull())
+        {
+            CachedRowCount* cached = new CachedRowCount();
+            cached->dataVersion = context->countingDataVersion;
+            cached->rows = rows;
+            rowCountCache.insert(getRowCountCacheKey(), cached);
+        }
+    }
 
     emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages);
 
@@ -568,10 +675,180 @@ bool QueryExecutor::handleRowCountingResults(quint32 asyncId, SqlQueryPtr result
         notifyError(tr("An error occured while executing the count(*) query, thus data paging will be disabled. Error details from the database: %1")
                     .arg(results->getErrorText()));
     }
+}
+
+void QueryExecutor::setTotalRows(qint64 rows, RowCountAccuracy accuracy)
+{
+    context->totalRowsReturned = rows;
+    context->totalRowsAccuracy = accuracy;
+    if (accuracy == RowCountAccuracy::LOWER_BOUND && resultsPerPage > 0)
+        context->totalPages = static_cast<int>(rows / resultsPerPage) + 1;
+    else
+        context->totalPages = (int)qCeil(((double)rows) / ((double)getResultsPerPage()));
+}
+
+qint64 QueryExecutor::estimateTotalRows()
+{
+    static_qstring(statTpl, "SELECT max(CAST(stat AS INTEGER)) FROM %1sqlite_stat1 WHERE lower(tbl) = lower(?)");
+
+    SourceTablePtr table = context->wholeTableSource;
+    if (!table)
+        return -1;
+
+    QString dbPrefix;
+    if (!table->database.isEmpty())
+        dbPrefix = wrapObjIfNeeded(table->database, db->getDialect()) + ".";
+
+    // The first number of the stat is number of rows in the index (or in the table, if it has no indexes).
+    // If the table (or the whole database) was never analyzed, there's nothing to estimate from.
+    QList<QVariant> args = {table->table};
+    SqlQueryPtr results = db->exec(statTpl.arg(dbPrefix), args, Db::Flag::NO_LOCK|Db::Flag::USE_READER);
+    if (results->isError())
+        return -1;
 
+    QVariant rows = results->getSingleCell();
+    if (rows.isNull())
+        return -1;
+
+    return rows.toLongLong();
+}
+
+QString QueryExecutor::getDataVersion()
+{
+    static const QStringList versionQueries = {"PRAGMA data_version", "PRAGMA schema_version", "SELECT total_changes()"};
+
+    if (db->getDialect() != Dialect::Sqlite3)
+        return QString::null;
+
+    return queryVersion(versionQueries);
+}
+
+QString QueryExecutor::getSchemaVersion()
+{
+    static_qstring(versionTpl, "PRAGMA %1.schema_version");
+
+    if (db->getDialect() != Dialect::Sqlite3)
+        return QString::null;
+
+    SqlQueryPtr results = db->exec("PRAGMA database_list", Db::Flag::NO_LOCK);
+    if (results->isError())
+        return QString::null;
+
+    QStringList versionQueries;
+    for (const SqlResultsRowPtr& row : results->getAll())
+        versionQueries << versionTpl.arg(wrapObjIfNeeded(row->value("name").toString(), Dialect::Sqlite3));
+
+    return queryVersion(versionQueries);
+}
+
+QString QueryExecutor::queryVersion(const QStringList& queries)
+{
+    QStringList version;
+    QVariant value;
+    for (const QString& query : queries)
+    {
+        SqlQueryPtr results = db->exec(query, Db::Flag::NO_LOCK);
+        value = results->getSingleCell();
+        if (results->isError() || value.isNull())
+            return QString::null;
+
+        version << value.toString();
+    }
+    return version.join(":");
+}
+
+bool QueryExecutor::restoreExecutionPlan()
+{
+    if (context->explainMode)
+        return false;
+
+    QString key = getExecutionPlanCacheKey();
+    ExecutionPlan* plan = executionPlanCache.object(key);
+    if (!plan)
+        return false;
+
+    if (plan->schemaVersion != getSchemaVersion())
+    {
+        executionPlanCache.remove(key);
+        return false;
+    }
+
+    // Further steps modify parsed queries, so they work on copies
+    context->parsedQueries.clear();
+    for (const SqliteQueryPtr& query : plan->parsedQueries)
+        context->parsedQueries << SqliteQueryPtr(dynamic_cast<SqliteQuery*>(query->clone()));
+
+    context->processedQuery = plan->processedQuery;
+    context->lastParsedQuery = plan->processedQuery;
+    context->lastParsedQueryTexts = plan->parsedQueryTexts;
+    context->colNameSeq = plan->colNameSeq;
+    context->editionForbiddenReasons = plan->editionForbiddenReasons;
+    context->rowIdColumns = plan->rowIdColumns;
+    context->keysetColumn = plan->keysetColumn;
+    context->resultColumns = plan->resultColumns;
+    context->sourceTables = plan->sourceTables;
+    context->wholeTableSource = plan->wholeTableSource;
+    context->executionPlanFromCache = true;
     return true;
 }
 
+void QueryExecutor::storeExecutionPlan()
+{
+    // Queries modifying anything could invalidate the plan by their own execution
+    if (context->explainMode || context->schemaModified || context->dataModifyingQuery)
+        return;
+
+    // Attached databases are detached after execution, so the plan would refer to non-existing databases
+    if (!context->dbNameToAttach.isEmpty())
+        return;
+
+    if (context->parsedQueries.size() != 1)
+        return;
+
+    SqliteQueryPtr query = context->parsedQueries.first();
+    if (query->queryType != SqliteQueryType::Select || query->explain)
+        return;
+
+    QString schemaVersion = getSchemaVersion();
+    if (schemaVersion.isNull())
+        return;
+
+    ExecutionPlan* plan = new ExecutionPlan();
+    plan->schemaVersion = schemaVersion;
+    plan->processedQuery = context->processedQuery;
+    plan->parsedQueries << SqliteQueryPtr(dynamic_cast<SqliteQuery*>(query->clone()));
+    plan->parsedQueryTexts = context->lastParsedQueryTexts;
+    plan->colNameSeq = context->colNameSeq;
+    plan->editionForbiddenReasons = context->editionForbiddenReasons;
+    plan->rowIdColumns = context->rowIdColumns;
+    plan->keysetColumn = context->keysetColumn;
+    plan->resultColumns = context->resultColumns;
+    plan->sourceTables = context->sourceTables;
+    plan->wholeTableSource = context->wholeTableSource;
+    executionPlanCache.insert(getExecutionPlanCacheKey(), plan);
+}
+
+QString QueryExecutor::getExecutionPlanCacheKey() const
+{
+    return originalQuery + "\n" + (noMetaColumns ? "1" : "0");
+}
+
+QString QueryExecutor::getRowCountCacheKey() const
+{
+    QStringList key = {context->countingQuery};
+
+    // Only parameters used by the counted query matter. Parameters added by later executor steps (like keyset pagination) are skipped.
+    QStringList paramNames = QueryMetadata::get(context->countedQuery, db->getDialect())->paramNames;
+    paramNames.removeDuplicates();
+    qSort(paramNames);
+    for (const QString& name : paramNames)
+    {
+        if (context->queryParameters.contains(name))
+            key << name + "=" + context->queryParameters[name].toString();
+    }
+    return key.join("\n");
+}
+
 QStringList QueryExecutor::applyLimitForSimpleMethod(const QStringList &queries)
 {
     static_qstring(tpl, "SELECT * FROM (%1) LIMIT %2 OFFSET %3");
@@ -780,6 +1057,8 @@ void QueryExecutor::setDb(Db* value)
         disconnect(db, SIGNAL(asyncExecFinished(quint32,SqlQueryPtr)), this, SLOT(dbAsyncExecFinished(quint32,SqlQueryPtr)));
 
     db = value;
+    rowCountCache.clear();
+    executionPlanCache.clear();
 
     if (db)
         connect(db, SIGNAL(asyncExecFinished(quint32,SqlQueryPtr)), this, SLOT(dbAsyncExecFinished(quint32,SqlQueryPtr)));
@@ -795,6 +1074,26 @@ void QueryExecutor::setSkipRowCounting(bool value)
     skipRowCounting = value;
 }
 
+QueryExecutor::CountingMode QueryExecutor::getCountingMode() const
+{
+    return countingMode;
+}
+
+void QueryExecutor::setCountingMode(QueryExecutor::CountingMode value)
+{
+    countingMode = value;
+}
+
+int QueryExecutor::getCountingEstimateLimit() const
+{
+    return countingEstimateLimit;
+}
+
+void QueryExecutor::setCountingEstimateLimit(int value)
+{
+    countingEstimateLimit = value;
+}
+
 QString QueryExecutor::getOriginalQuery() const
 {
     return originalQuery;
@@ -837,6 +1136,9 @@ int QueryExecutor::getResultsPerPage() const
 
 void QueryExecutor::setResultsPerPage(int value)
 {
+    if (value != resultsPerPage)
+        clearPageKeys();
+
     resultsPerPage = value;
 }
 
@@ -850,6 +1152,31 @@ void QueryExecutor::setPage(int value)
     page = value;
 }
 
+QHash<int, QueryExecutor::PageKeys> QueryExecutor::getPageKeys() const
+{
+    QMutexLocker locker(&pageKeysMutex);
+    return pageKeys;
+}
+
+void QueryExecutor::setPageKeys(int page, const QueryExecutor::PageKeys& keys)
+{
+    QMutexLocker locker(&pageKeysMutex);
+    pageKeys[page] = keys;
+}
+
+qint64 QueryExecutor::getKnownTotalRows() const
+{
+    QMutexLocker locker(&pageKeysMutex);
+    return knownTotalRows;
+}
+
+void QueryExecutor::clearPageKeys()
+{
+    QMutexLocker locker(&pageKeysMutex);
+    pageKeys.clear();
+    knownTotalRows = -1;
+}
+
 bool QueryExecutor::isExecutionInProgress()
 {
     QMutexLocker executionLock(&executionMutex);
@@ -11,6 +11,7 @@
 #include <QHash>
 #include <QMutex>
 #include <QRunnable>
+#include <QCache>
 
 /** @file */
 
@@ -100,6 +101,10 @@ class ChainExecutor;
  * wait for the QueryExecutor::resultsCountingFinished() signal first.
  *
  * Row counting query execution can be disabled with QueryExecutor::setSkipRowCounting(),
+ *
+ * Counting all rows of large views or joins can take as long as the query itself, so it can be limited
+ * with QueryExecutor::setCountingMode(). In modes other than CountingMode::EXACT the total number of rows
+ * may be an estimate, or a lower bound - see QueryExecutor::getTotalRowsAccuracy().
  */
 class API_EXPORT QueryExecutor : public QObject, public QRunnable
 {
@@ -235,6 +240,48 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
 
         typedef QList<Sort> SortList;
 
+        /**
+         * @brief Strategy of counting total number of result rows.
+         *
+         * See "Counting query" section in the class description and countResults() for details.
+         */
+        enum class CountingMode
+        {
+            EXACT,     /**< Counting query counts all rows of the query. This is the default. */
+            ESTIMATED, /**<
+                        * Counting query stops after number of rows defined with setCountingEstimateLimit().
+                        * If there's more rows, then the total is estimated from sqlite_stat1 (for queries reading
+                        * a whole table), or it's reported as a lower bound.
+                        */
+            LAZY       /**<
+                        * No counting query is executed. The total is reported as a lower bound,
+                        * allowing to go one page further. Exact counting is up to the caller
+                        * (for example when the last page is requested).
+                        */
+        };
+
+        /**
+         * @brief Tells how accurate is the total number of rows provided by getTotalRowsReturned().
+         */
+        enum class RowCountAccuracy
+        {
+            EXACT,      /**< The number is exact. */
+            ESTIMATE,   /**< The number is an estimate, real number of rows can be lower or higher. */
+            LOWER_BOUND /**< There's at least that many rows, but there can be more. */
+        };
+
+        /**
+         * @brief Keys of the first and the last row of a results page.
+         *
+         * They are remembered for pages loaded with keyset pagination (see QueryExecutorLimit),
+         * so neighbour pages can be queried by seeking the key, instead of skipping rows with OFFSET.
+         */
+        struct PageKeys
+        {
+            QVariant first;
+            QVariant last;
+        };
+
         /**
          * @brief ResultColumn as represented by QueryExecutor.
          *
@@ -465,6 +512,13 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             qint64 totalRowsReturned = 0;
 
+            /**
+             * @brief Accuracy of totalRowsReturned.
+             *
+             * Anything but EXACT is possible only for counting modes other than CountingMode::EXACT.
+             */
+            RowCountAccuracy totalRowsAccuracy = RowCountAccuracy::EXACT;
+
             /**
              * @brief Total number of pages.
              *
@@ -533,6 +587,20 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             QList<SqliteQueryPtr> parsedQueries;
 
+            /**
+             * @brief Query string as it was when parsedQueries were refreshed by QueryExecutorParseQuery.
+             *
+             * Lets QueryExecutorParseQuery tell whether any step has modified the query since then.
+             */
+            QString lastParsedQuery;
+
+            /**
+             * @brief Detokenized parsedQueries, as they were when refreshed by QueryExecutorParseQuery.
+             *
+             * Lets QueryExecutorParseQuery parse again only those queries, that were modified by steps.
+             */
+            QStringList lastParsedQueryTexts;
+
             /**
              * @brief Results of executed query.
              *
@@ -574,6 +642,22 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             QList<ResultRowIdColumnPtr> rowIdColumns;
 
+            /**
+             * @brief Alias of the result column that the results can be paged by with keyset pagination.
+             *
+             * QueryExecutorAddRowIds sets it when the query reads from a single table and doesn't define its own order,
+             * so the ROWID (or single-column PRIMARY KEY of WITHOUT ROWID table) identifies rows and can define their order.
+             * It's null if keyset pagination cannot be used for the query.
+             */
+            QString keysetColumn;
+
+            /**
+             * @brief Tells if the results page was queried with keyset pagination.
+             *
+             * Set by QueryExecutorLimit, so QueryExecutorExecute knows it should remember keys of the page.
+             */
+            bool keysetPaging = false;
+
             /**
              * @brief Result columns from the query.
              *
@@ -590,6 +674,21 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             QSet<SourceTablePtr> sourceTables;
 
+            /**
+             * @brief The only data source table, if the query reads all of its rows.
+             *
+             * Set by QueryExecutorDataSources when the query selects from a single table, without joins,
+             * WHERE, grouping, DISTINCT or LIMIT, so the number of results is the number of rows in the table.
+             * Table and database names are as they appear in the processed query.
+             * It's used to estimate number of rows from sqlite_stat1 (see CountingMode::ESTIMATED).
+             */
+            SourceTablePtr wholeTableSource;
+
+            /**
+             * @brief Query (without trailing semicolon) that is wrapped by counting queries.
+             */
+            QString countedQuery;
+
             /**
              * @brief Query used for counting results.
              *
@@ -598,6 +697,26 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             QString countingQuery;
 
+            /**
+             * @brief Tells if the counting query in progress counts only up to QueryExecutor::getCountingEstimateLimit() rows.
+             */
+            bool partialCounting = false;
+
+            /**
+             * @brief Data version of the database at the moment of starting the counting query.
+             *
+             * See QueryExecutor::getDataVersion() for details.
+             */
+            QString countingDataVersion;
+
+            /**
+             * @brief Tells if the context was initialized from cached execution plan.
+             *
+             * In that case the steps resolving query metadata were not executed.
+             * See QueryExecutor::restoreExecutionPlan() for details.
+             */
+            bool executionPlanFromCache = false;
+
             /**
              * @brief Flag indicating results preloading.
              *
@@ -695,13 +814,33 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          * signal is emitted.
          *
          * Counting query is made of original query wrapped with "SELECT count(*) FROM (original_query)".
+         * How much of the results is actually counted depends on the counting mode (see setCountingMode()).
          *
          * It is executed after the main query execution has finished.
          *
+         * Exact counts are cached per counting query, its parameters and the database data version
+         * (data_version and schema_version pragmas, together with total_changes() of the connection),
+         * so executing the same query again against unchanged data doesn't count rows again.
+         * In that case the resultsCountingFinished() is emitted before this method returns.
+         *
          * If query is being executed in async mode, the true result (sucess/fail) will be known from later, not from this method.
          */
         bool countResults();
 
+        /**
+         * @brief Tests if asynchronous counting query is being executed.
+         * @return true if counting is in progress, false otherwise.
+         */
+        bool isResultsCountingInProgress() const;
+
+        /**
+         * @brief Cancels asynchronous counting query execution.
+         *
+         * The resultsCountingFinished() will not be emitted for the cancelled counting.
+         * Does nothing if there's no counting in progress.
+         */
+        void cancelResultsCounting();
+
         /**
          * @brief Gets time of how long it took to execute query.
          * @return Execution time in milliseconds.
@@ -729,9 +868,18 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          *
          * Calling this method makes sense only after resultsCountingFinished() was emitted, otherwise the value
          * returned will not be accurate.
+         *
+         * For counting modes other than CountingMode::EXACT the number might not be exact,
+         * see getTotalRowsAccuracy().
          */
         qint64 getTotalRowsReturned() const;
 
+        /**
+         * @brief Tells how accurate is the number returned from getTotalRowsReturned().
+         * @return Accuracy of the most recent results counting.
+         */
+        RowCountAccuracy getTotalRowsAccuracy() const;
+
         /**
          * @brief Gets type of the SQL statement in the defined query.
          * @param index Index of the SQL statement in the query (statements are separated by semicolon character), or -1 to get the last one.
@@ -936,6 +1084,34 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         void setPage(int value);
 
+        /**
+         * @brief Provides keys of pages loaded with keyset pagination.
+         * @return Page index mapped to keys of the first and the last row of that page.
+         *
+         * Keys are forgotten when the query, or the number of rows per page is changed,
+         * or when the query is executed with results counting (see setSkipRowCounting()),
+         * as the data may have changed since.
+         */
+        QHash<int,PageKeys> getPageKeys() const;
+
+        /**
+         * @brief Remembers keys of loaded page.
+         * @param page Index of the page.
+         * @param keys Keys of the first and the last row of the page.
+         *
+         * Called by QueryExecutorExecute for pages loaded with keyset pagination.
+         */
+        void setPageKeys(int page, const PageKeys& keys);
+
+        /**
+         * @brief Provides number of rows returned by the query, as counted by the most recent results counting.
+         * @return Number of rows, or -1 if results weren't counted yet.
+         *
+         * Unlike getTotalRowsReturned(), this is kept for executions with results counting skipped,
+         * which is the case of switching between pages. It's forgotten together with page keys.
+         */
+        qint64 getKnownTotalRows() const;
+
         /**
          * @brief Tests if there's any execution in progress at the moment.
          * @return true if the execution is in progress, or false otherwise.
@@ -975,6 +1151,34 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         void setSkipRowCounting(bool value);
 
+        /**
+         * @brief Provides strategy used by countResults().
+         * @return Counting mode.
+         */
+        CountingMode getCountingMode() const;
+
+        /**
+         * @brief Defines strategy used by countResults().
+         * @param value New counting mode.
+         *
+         * See CountingMode for details.
+         */
+        void setCountingMode(CountingMode value);
+
+        /**
+         * @brief Provides maximum number of rows counted in CountingMode::ESTIMATED.
+         * @return Number of rows.
+         */
+        int getCountingEstimateLimit() const;
+
+        /**
+         * @brief Defines maximum number of rows counted in CountingMode::ESTIMATED.
+         * @param value Number of rows.
+         *
+         * Queries returning up to this number of rows are still counted exactly.
+         */
+        void setCountingEstimateLimit(int value);
+
         /**
          * @brief Asynchronous executor processing in thread.
          *
@@ -1028,6 +1232,12 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         void releaseResultsAndCleanup();
 
+        /**
+         * @brief Forgets all page keys and the known total number of rows.
+         * @see getPageKeys()
+         */
+        void clearPageKeys();
+
         const QStringList& getRequiredDbAttaches() const;
 
         bool getForceSimpleMode() const;
@@ -1081,6 +1291,51 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         void executeChain();
 
+        /**
+         * @brief Initializes context with cached execution plan of the query.
+         * @return true if the plan was found and it's still valid, or false otherwise.
+         *
+         * Execution plan is a state of the context after all steps resolving query metadata
+         * (result columns, ROWID columns, source tables, etc) were executed. If it's restored,
+         * those steps are not added to the execution chain. Only steps depending on sorting,
+         * paging, etc. are executed.
+         *
+         * The plan is valid as long as the schema version (see getSchemaVersion()) doesn't change.
+         */
+        bool restoreExecutionPlan();
+
+        /**
+         * @brief Stores current state of the context as execution plan of the query.
+         *
+         * It's called by executeChain() once the executionPlanStep is finished.
+         * Plans are stored only for a single SELECT query, which doesn't need any database
+         * to be attached (see QueryExecutorAttaches).
+         */
+        void storeExecutionPlan();
+
+        /**
+         * @brief Provides schema version of the database.
+         * @return Version string, or null string if it could not be determinated (like for SQLite 2).
+         *
+         * The version consists of schema_version pragma values of all databases on the connection.
+         */
+        QString getSchemaVersion();
+
+        /**
+         * @brief Executes queries returning single value each and joins the values.
+         * @param queries Queries to execute.
+         * @return Joined values, or null string if any query failed or returned null.
+         *
+         * It's a common routine for getDataVersion() and getSchemaVersion().
+         */
+        QString queryVersion(const QStringList& queries);
+
+        /**
+         * @brief Provides key for the execution plan cache.
+         * @return Original query together with options affecting the plan.
+         */
+        QString getExecutionPlanCacheKey() const;
+
         /**
          * @brief Executes the original, unmodified query.
          *
@@ -1123,6 +1378,48 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         bool handleRowCountingResults(quint32 asyncId, SqlQueryPtr results);
 
+        /**
+         * @brief Stores number of rows from counting query results and emits resultsCountingFinished().
+         * @param results Results from the counting query execution (either synchronous, or asynchronous).
+         *
+         * For partial counting (see CountingMode::ESTIMATED) it decides whether the count is exact,
+         * or whether it needs to be estimated. Exact counts are stored in the cache.
+         */
+        void applyCountingResults(SqlQueryPtr results);
+
+        /**
+         * @brief Stores total number of rows in the context and calculates number of pages.
+         * @param rows Number of rows.
+         * @param accuracy Accuracy of the number.
+         *
+         * In case of RowCountAccuracy::LOWER_BOUND one more page is made available,
+         * as there may be rows after the \p rows.
+         */
+        void setTotalRows(qint64 rows, RowCountAccuracy accuracy);
+
+        /**
+         * @brief Estimates total number of rows from sqlite_stat1.
+         * @return Estimated number of rows, or -1 if it could not be estimated.
+         *
+         * It's possible only if Context::wholeTableSource is defined and the table was analyzed.
+         */
+        qint64 estimateTotalRows();
+
+        /**
+         * @brief Provides data version of the database.
+         * @return Version string, or null string if it could not be determinated (like for SQLite 2).
+         *
+         * The version changes every time the data or the schema is modified, either by other connection
+         * (data_version pragma), or by the main connection itself (total_changes() and schema_version pragma).
+         */
+        QString getDataVersion();
+
+        /**
+         * @brief Provides key for the counted rows cache.
+         * @return Counting query together with its parameters.
+         */
+        QString getRowCountCacheKey() const;
+
         QStringList applyLimitForSimpleMethod(const QStringList &queries);
 
         /**
@@ -1191,6 +1488,26 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         SortList sortOrder;
 
+        /**
+         * @brief Keys of pages loaded with keyset pagination.
+         *
+         * See getPageKeys() for details.
+         */
+        QHash<int,PageKeys> pageKeys;
+
+        /**
+         * @brief Total number of rows, as counted by the most recent results counting.
+         *
+         * See getKnownTotalRows() for details.
+         */
+        qint64 knownTotalRows = -1;
+
+        /**
+         * @brief Guards pageKeys and knownTotalRows, as they're used from executor steps (in executor's thread)
+         * and updated by asynchronous results counting.
+         */
+        mutable QMutex pageKeysMutex;
+
         /**
          * @brief Flag indicating that the execution is currently in progress.
          *
@@ -1265,6 +1582,82 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         quint32 resultsCountingAsyncId = 0;
 
+        /**
+         * @brief Strategy of results counting.
+         *
+         * See setCountingMode() for details.
+         */
+        CountingMode countingMode = CountingMode::EXACT;
+
+        /**
+         * @brief Maximum number of rows counted in CountingMode::ESTIMATED.
+         *
+         * See setCountingEstimateLimit() for details.
+         */
+        int countingEstimateLimit = 10000;
+
+        /**
+         * @brief Exactly counted number of rows, together with data version it was counted for.
+         */
+        struct CachedRowCount
+        {
+            QString dataVersion;
+            qint64 rows = 0;
+        };
+
+        /**
+         * @brief Maximum number of entries in rowCountCache.
+         */
+        static const int rowCountCacheSize = 20;
+
+        /**
+         * @brief Cache of exactly counted rows.
+         *
+         * Keyed by getRowCountCacheKey(). Entries are valid only as long as the data version
+         * (see getDataVersion()) doesn't change. It's cleared when the database is changed.
+         */
+        QCache<QString,CachedRowCount> rowCountCache;
+
+        /**
+         * @brief State of the context after resolving query metadata.
+         *
+         * See restoreExecutionPlan() for details.
+         */
+        struct ExecutionPlan
+        {
+            QString schemaVersion;
+            QString processedQuery;
+            QList<SqliteQueryPtr> parsedQueries;
+            QStringList parsedQueryTexts;
+            int colNameSeq = 0;
+            QSet<EditionForbiddenReason> editionForbiddenReasons;
+            QList<ResultRowIdColumnPtr> rowIdColumns;
+            QString keysetColumn;
+            QList<ResultColumnPtr> resultColumns;
+            QSet<SourceTablePtr> sourceTables;
+            SourceTablePtr wholeTableSource;
+        };
+
+        /**
+         * @brief Maximum number of entries in executionPlanCache.
+         */
+        static const int executionPlanCacheSize = 10;
+
+        /**
+         * @brief Cache of execution plans.
+         *
+         * Keyed by getExecutionPlanCacheKey(). Entries are valid only as long as the schema version
+         * (see getSchemaVersion()) doesn't change. It's cleared when the database is changed.
+         */
+        QCache<QString,ExecutionPlan> executionPlanCache;
+
+        /**
+         * @brief Last step of the chain resolving query metadata.
+         *
+         * It's null if the execution plan was restored from the cache. See restoreExecutionPlan().
+         */
+        QueryExecutorStep* executionPlanStep = nullptr;
+
         /**
          * @brief Flag indicating results preloading.
          *
@@ -36,6 +36,7 @@ bool QueryExecutorAddRowIds::exec()
     updateQueries();
 //    qDebug() << "after addrowid: " << context->processedQuery;
 
+    context->keysetColumn = getKeysetColumn(select.data());
     return true;
 }
 
@@ -80,6 +81,21 @@ QHash<SelectResolver::Table,QHash<QString,QString>> QueryExecutorAddRowIds::addR
     return rowIdColsMap;
 }
 
+QString QueryExecutorAddRowIds::getKeysetColumn(SqliteSelect* select)
+{
+    if (context->rowIdColumns.size() != 1 || context->rowIdColumns.first()->queryExecutorAliasToColumn.size() != 1)
+        return QString::null;
+
+    SqliteSelect::Core* core = select->coreSelects.first();
+    if (!core->from || !core->from->singleSource || core->from->otherSources.size() > 0 || core->from->singleSource->table.isNull())
+        return QString::null;
+
+    if (core->orderBy.size() > 0 || core->limit || core->groupBy.size() > 0)
+        return QString::null;
+
+    return context->rowIdColumns.first()->queryExecutorAliasToColumn.keys().first();
+}
+
 QList<SqliteSelect*> QueryExecutorAddRowIds::getSubSelects(SqliteSelect::Core* core)
 {
     QList<SqliteSelect*> selects;
@@ -76,6 +76,17 @@ class QueryExecutorAddRowIds : public QueryExecutorStep
          * @return Map of query executor alias to real database column name.
          */
         QHash<QString, QString> getNextColNames(const SelectResolver::Table& table);
+
+        /**
+         * @brief Finds ROWID column that can be used for keyset pagination.
+         * @param select Top-most SELECT, after ROWID columns were added.
+         * @return Alias of the column, or null string if keyset pagination cannot be used.
+         *
+         * The key has to identify rows uniquely, so the query has to read from a single table (no joins, no subselects)
+         * and the table has to have a single-column key. The query also cannot define its own order or limit.
+         * See QueryExecutor::Context::keysetColumn.
+         */
+        QString getKeysetColumn(SqliteSelect* select);
 };
 
 #endif // QUERYEXECUTORADDROWIDS_H
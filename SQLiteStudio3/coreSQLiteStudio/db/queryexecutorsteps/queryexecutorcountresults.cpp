@@ -14,7 +14,8 @@ bool QueryExecutorCountResults::exec()
         return true;
     }
 
-    QString countSql = "SELECT count(*) AS cnt FROM ("+select->detokenize()+");";
+    context->countedQuery = select->detokenize();
+    QString countSql = "SELECT count(*) AS cnt FROM ("+context->countedQuery+");";
     context->countingQuery = countSql;
 
     // qDebug() << "count sql:" << countSql;
@@ -28,5 +28,16 @@ bool QueryExecutorDataSources::exec()
         context->sourceTables << table;
     }
 
+    if (!select->with && core->from && core->from->singleSource && core->from->otherSources.isEmpty() &&
+            !core->from->singleSource->table.isNull() && !core->where && core->groupBy.isEmpty() &&
+            !core->distinctKw && !core->limit)
+    {
+        QueryExecutor::SourceTablePtr table = QueryExecutor::SourceTablePtr::create();
+        table->database = core->from->singleSource->database;
+        table->table = core->from->singleSource->table;
+        table->alias = core->from->singleSource->alias;
+        context->wholeTableSource = table;
+    }
+
     return true;
 }
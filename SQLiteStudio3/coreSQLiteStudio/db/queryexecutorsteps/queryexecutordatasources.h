@@ -12,6 +12,9 @@
  *
  * Source tables are tables that result columns come from. If there's multiple columns selected
  * from single table, only single table is resolved.
+ *
+ * If the query reads all rows of a single table, the table is also stored
+ * in QueryExecutor::Context::wholeTableSource, for estimating number of rows.
  */
 class QueryExecutorDataSources : public QueryExecutorStep
 {
@@ -95,6 +95,9 @@ void QueryExecutorExecute::handleSuccessfulResult(SqlQueryPtr results)
 
     context->executionTime = QDateTime::currentMSecsSinceEpoch() - startTime;
 
+    if (context->keysetPaging)
+        rememberPageKeys(results);
+
     // For PRAGMA and EXPLAIN we simply count results for rows returned
     SqliteQueryPtr lastQuery = context->parsedQueries.last();
     if (lastQuery->queryType != SqliteQueryType::Select || lastQuery->explain)
@@ -121,6 +124,18 @@ void QueryExecutorExecute::handleFailResult(SqlQueryPtr results)
     }
 }
 
+void QueryExecutorExecute::rememberPageKeys(SqlQueryPtr results)
+{
+    QList<SqlResultsRowPtr> rows = results->getAll();
+    if (rows.isEmpty())
+        return;
+
+    QueryExecutor::PageKeys keys;
+    keys.first = rows.first()->value(context->keysetColumn);
+    keys.last = rows.last()->value(context->keysetColumn);
+    queryExecutor->setPageKeys(queryExecutor->getPage(), keys);
+}
+
 QHash<QString, QVariant> QueryExecutorExecute::getBindParamsForQuery(SqliteQueryPtr query)
 {
     QHash<QString, QVariant> queryParams;
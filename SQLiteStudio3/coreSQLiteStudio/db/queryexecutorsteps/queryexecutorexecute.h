@@ -64,6 +64,15 @@ class QueryExecutorExecute : public QueryExecutorStep
          */
         void handleFailResult(SqlQueryPtr results);
 
+        /**
+         * @brief Remembers keys of the first and the last row of the page loaded with keyset pagination.
+         * @param results Execution results.
+         *
+         * Results are preloaded for that, but it's just a single page, which would be read anyway.
+         * See QueryExecutorLimit for details on keyset pagination.
+         */
+        void rememberPageKeys(SqlQueryPtr results);
+
         /**
          * @brief Prepares parameters for query execution.
          * @param query Query to be executed.
@@ -1,5 +1,6 @@
 #include "queryexecutorlimit.h"
 #include "parser/ast/sqlitelimit.h"
+#include "parser/lexer.h"
 #include <QDebug>
 
 bool QueryExecutorLimit::exec()
@@ -16,15 +17,93 @@ bool QueryExecutorLimit::exec()
         return true; // shouldn't happen, but if happens, quit gracefully
 
     quint64 limit = queryExecutor->getResultsPerPage();
-    quint64 offset = limit * page;
 
-    // The original query is last, so if it contained any %N strings,
-    // they won't be replaced.
-    static_qstring(selectTpl, "SELECT * FROM (%1) LIMIT %2 OFFSET %3");
-    QString newSelect = selectTpl.arg(select->detokenize(), QString::number(limit), QString::number(offset));
+    QString newSelect;
+    if (!context->keysetColumn.isNull() && queryExecutor->getSortOrder().isEmpty())
+    {
+        newSelect = getKeysetSelect(select->detokenize(), page, limit);
+        context->keysetPaging = true;
+    }
+    else
+    {
+        quint64 offset = limit * page;
 
-    int begin = select->tokens.first()->start;
-    int length = select->tokens.last()->end - select->tokens.first()->start + 1;
-    context->processedQuery = context->processedQuery.replace(begin, length, newSelect);
+        // The original query is last, so if it contained any %N strings,
+        // they won't be replaced.
+        static_qstring(selectTpl, "SELECT * FROM (%1) LIMIT %2 OFFSET %3");
+        newSelect = selectTpl.arg(select->detokenize(), QString::number(limit), QString::number(offset));
+    }
+
+    select->tokens = Lexer::tokenize(newSelect, dialect);
+    updateQueries();
     return true;
 }
+
+QString QueryExecutorLimit::getKeysetSelect(const QString& innerSelect, int page, qint64 limit)
+{
+    // All arguments are applied at once, so if the original query contained any %N strings, they won't be replaced.
+    static_qstring(forwardTpl, "SELECT * FROM (%1) %2ORDER BY %3 LIMIT %4 OFFSET %5");
+    static_qstring(backwardTpl, "SELECT * FROM (SELECT * FROM (%1) %2ORDER BY %3 DESC LIMIT %4 OFFSET %5) ORDER BY %3");
+    static_qstring(afterKeyTpl, "WHERE %1 > %2 ");
+    static_qstring(beforeKeyTpl, "WHERE %1 < %2 ");
+    static_qstring(keyParam, ":queryExecutorKeysetKey");
+
+    QHash<int,QueryExecutor::PageKeys> pageKeys = queryExecutor->getPageKeys();
+    const QString& key = context->keysetColumn;
+
+    // Closest remembered pages before and after the requested one
+    int pageBefore = -1;
+    int pageAfter = -1;
+    for (int keysPage : pageKeys.keys())
+    {
+        if (keysPage < page && keysPage > pageBefore)
+            pageBefore = keysPage;
+
+        if (keysPage > page && (pageAfter < 0 || keysPage < pageAfter))
+            pageAfter = keysPage;
+    }
+
+    // Going forward, either from the beginning, or from the last key of the page before
+    qint64 forwardOffset = limit * (page - pageBefore - 1);
+
+    // Going backward, either from the first key of the page after, or from the end of results
+    qint64 backwardOffset = -1;
+    qint64 backwardLimit = limit;
+    if (pageAfter > -1)
+        backwardOffset = limit * (pageAfter - page - 1);
+
+    qint64 totalRows = queryExecutor->getKnownTotalRows();
+    qint64 pageStart = limit * page;
+    if (totalRows > pageStart)
+    {
+        qint64 rowsOnPage = qMin(limit, totalRows - pageStart);
+        qint64 offsetFromEnd = totalRows - pageStart - rowsOnPage;
+        if (backwardOffset < 0 || offsetFromEnd < backwardOffset)
+        {
+            pageAfter = -1;
+            backwardOffset = offsetFromEnd;
+            backwardLimit = rowsOnPage;
+        }
+    }
+
+    if (backwardOffset > -1 && backwardOffset < forwardOffset)
+    {
+        QString condition;
+        if (pageAfter > -1)
+        {
+            context->queryParameters[keyParam] = pageKeys[pageAfter].first;
+            condition = beforeKeyTpl.arg(key, keyParam);
+        }
+
+        return backwardTpl.arg(innerSelect, condition, key, QString::number(backwardLimit), QString::number(backwardOffset));
+    }
+
+    QString condition;
+    if (pageBefore > -1)
+    {
+        context->queryParameters[keyParam] = pageKeys[pageBefore].last;
+        condition = afterKeyTpl.arg(key, keyParam);
+    }
+
+    return forwardTpl.arg(innerSelect, condition, key, QString::number(limit), QString::number(forwardOffset));
+}
@@ -10,6 +10,13 @@
  * and QueryExecutor::Context::setResultsPerPage), then the SELECT query
  * is wrapped with another SELECT which defines it's own LIMIT and OFFSET
  * basing on the page and the results per page parameters.
+ *
+ * If the results can be ordered by a unique key (see QueryExecutor::Context::keysetColumn)
+ * and no sorting was requested, then keyset pagination is used. Results are ordered by the key
+ * and the page is found by seeking the key from the neighbour page (see QueryExecutor::getPageKeys()),
+ * or from the end of results, whichever requires skipping less rows. This way switching to next, previous,
+ * or last page costs as much as reading the page, no matter how many rows are before it.
+ * OFFSET is used only when there's no remembered page close enough.
  */
 class QueryExecutorLimit : public QueryExecutorStep
 {
@@ -17,6 +24,16 @@ class QueryExecutorLimit : public QueryExecutorStep
 
     public:
         bool exec();
+
+    private:
+        /**
+         * @brief Builds SELECT for keyset pagination.
+         * @param innerSelect SELECT to take the page from.
+         * @param page Requested page.
+         * @param limit Number of rows per page.
+         * @return SELECT returning requested page, ordered by the key.
+         */
+        QString getKeysetSelect(const QString& innerSelect, int page, qint64 limit);
 };
 
 #endif // QUERYEXECUTORLIMIT_H
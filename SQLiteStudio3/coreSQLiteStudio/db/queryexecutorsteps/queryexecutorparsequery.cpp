@@ -16,6 +16,63 @@ QueryExecutorParseQuery::~QueryExecutorParseQuery()
 }
 
 bool QueryExecutorParseQuery::exec()
+{
+    if (context->parsedQueries.size() > 0 && context->processedQuery == context->lastParsedQuery)
+        return true; // nothing has changed since the last parsing
+
+    QStringList queryTexts;
+    if (isUpdatedFromParsedQueries(queryTexts))
+        return parseModified(queryTexts);
+
+    return parseAll();
+}
+
+bool QueryExecutorParseQuery::isUpdatedFromParsedQueries(QStringList& queryTexts)
+{
+    if (context->parsedQueries.size() == 0 || context->parsedQueries.size() != context->lastParsedQueryTexts.size())
+        return false;
+
+    // Same as QueryExecutorStep::updateQueries() does. If it's not equal, then the query string was modified directly.
+    QString queryFromParsed;
+    for (const SqliteQueryPtr& query : context->parsedQueries)
+    {
+        queryTexts << query->detokenize();
+        queryFromParsed += queryTexts.last();
+        queryFromParsed += "\n";
+    }
+    return queryFromParsed == context->processedQuery;
+}
+
+bool QueryExecutorParseQuery::parseModified(const QStringList& queryTexts)
+{
+    Parser queryParser(dialect);
+    for (int i = 0, total = queryTexts.size(); i < total; i++)
+    {
+        if (queryTexts[i] == context->lastParsedQueryTexts[i])
+            continue;
+
+        queryParser.parse(queryTexts[i]);
+        if (queryParser.getErrors().size() > 0)
+        {
+            qWarning() << "QueryExecutorParseQuery:" << queryParser.getErrorString() << "\n"
+                       << "Query parsed:" << queryTexts[i];
+            return false;
+        }
+
+        if (queryParser.getQueries().size() != 1)
+        {
+            // Modified query was split into more queries (or none), so it has to be done the regular way
+            return parseAll();
+        }
+
+        context->parsedQueries[i] = queryParser.getQueries().first();
+    }
+
+    rememberParsedQueries();
+    return true;
+}
+
+bool QueryExecutorParseQuery::parseAll()
 {
     // Prepare parser
     if (parser)
@@ -40,9 +97,17 @@ bool QueryExecutorParseQuery::exec()
     }
 
     context->parsedQueries = parser->getQueries();
+    rememberParsedQueries();
+    return true;
+}
 
+void QueryExecutorParseQuery::rememberParsedQueries()
+{
     // We never want the semicolon in last query, because the query could be wrapped with a SELECT
     context->parsedQueries.last()->tokens.trimRight(Token::OPERATOR, ";");
 
-    return true;
+    context->lastParsedQuery = context->processedQuery;
+    context->lastParsedQueryTexts.clear();
+    for (const SqliteQueryPtr& query : context->parsedQueries)
+        context->lastParsedQueryTexts << query->detokenize();
 }
@@ -11,6 +11,11 @@
  *
  * This is used after some changes were made to the query and next steps will
  * require parsed representation of queries to be updated.
+ *
+ * Parsing is done only as much as needed. If steps executed since the previous parsing didn't change
+ * the query, nothing is parsed. If they modified tokens of parsed queries and called
+ * QueryExecutorStep::updateQueries() (which is the usual case), then only modified queries are parsed again.
+ * The whole query string is parsed only initially, or if it was modified directly.
  */
 class QueryExecutorParseQuery : public QueryExecutorStep
 {
@@ -23,6 +28,31 @@ class QueryExecutorParseQuery : public QueryExecutorStep
         bool exec();
 
     private:
+        /**
+         * @brief Tests if the processed query is made of current parsed queries.
+         * @param queryTexts Filled with detokenized parsed queries.
+         * @return true if the processed query was updated with QueryExecutorStep::updateQueries().
+         */
+        bool isUpdatedFromParsedQueries(QStringList& queryTexts);
+
+        /**
+         * @brief Parses again only those queries, that were modified since the last parsing.
+         * @param queryTexts Current detokenized parsed queries.
+         * @return true on success, false on parsing error.
+         */
+        bool parseModified(const QStringList& queryTexts);
+
+        /**
+         * @brief Parses the whole processed query.
+         * @return true on success, false on parsing error.
+         */
+        bool parseAll();
+
+        /**
+         * @brief Remembers state of parsed queries for the next parsing step.
+         */
+        void rememberParsedQueries();
+
         Parser* parser = nullptr;
 };
 
@@ -0,0 +1,142 @@
+#include "querymetadata.h"
+#include "parser/lexer.h"
+#include <QMutexLocker>
+#include <QDebug>
+
+QMutex QueryMetadata::cacheMutex;
+QCache<QueryMetadata::CacheKey,QueryMetadataPtr> QueryMetadata::cache(QueryMetadata::cacheSize);
+
+QueryMetadataPtr QueryMetadata::get(const QString& query, Dialect dialect)
+{
+    if (query.size() > maxCachedQueryLength)
+        return QueryMetadataPtr(new QueryMetadata(query, dialect));
+
+    CacheKey key(static_cast<int>(dialect), query);
+    {
+        QMutexLocker locker(&cacheMutex);
+        QueryMetadataPtr* cached = cache.object(key);
+        if (cached)
+            return *cached;
+    }
+
+    // Tokenizing outside of the lock, so other threads are not blocked by it.
+    QueryMetadataPtr metadata(new QueryMetadata(query, dialect));
+
+    QMutexLocker locker(&cacheMutex);
+    cache.insert(key, new QueryMetadataPtr(metadata));
+    return metadata;
+}
+
+void QueryMetadata::clearCache()
+{
+    QMutexLocker locker(&cacheMutex);
+    cache.clear();
+}
+
+QueryMetadata::QueryMetadata(const QString& query, Dialect dialect)
+{
+    static const QStringList schemaChangeCommands = {"ALTER", "ATTACH", "CREATE", "DETACH", "DROP", "REINDEX", "VACUUM"};
+
+    TokenList tokens = Lexer::tokenize(query, dialect);
+
+    accessMode = getQueryAccessMode(tokens, &select);
+
+    for (const TokenPtr& token : tokens.filter(Token::BIND_PARAM))
+        paramNames << token->value;
+
+    paramCount = paramNames.size();
+
+    if (accessMode != QueryAccessMode::WRITE)
+    {
+        journalModeChange = isJournalModeChange(tokens);
+        return;
+    }
+
+    int keywordIdx = tokens.indexOf(Token::KEYWORD);
+    if (keywordIdx > -1)
+        schemaChange = schemaChangeCommands.contains(tokens[keywordIdx]->value.toUpper());
+
+    if (schemaChange)
+        extractDrop(tokens, query, dialect);
+}
+
+bool QueryMetadata::isJournalModeChange(const TokenList& tokens)
+{
+    int keywordIdx = tokens.indexOf(Token::KEYWORD);
+    if (keywordIdx < 0 || tokens[keywordIdx]->value.toUpper() != "PRAGMA")
+        return false;
+
+    // The pragma name (possibly prefixed with a database name) has to be followed by "=" or "(" to set the mode
+    bool nameMatched = false;
+    for (int i = keywordIdx + 1; i < tokens.size(); i++)
+    {
+        const TokenPtr& token = tokens[i];
+        if (token->type == Token::SPACE || token->type == Token::COMMENT)
+            continue;
+
+        if (nameMatched)
+            return token->type == Token::PAR_LEFT || (token->type == Token::OPERATOR && token->value == "=");
+
+        nameMatched = (token->value.toLower() == "journal_mode");
+    }
+    return false;
+}
+
+void QueryMetadata::extractDrop(TokenList tokens, const QString& query, Dialect dialect)
+{
+    tokens.trim(Token::OPERATOR, ";");
+    if (tokens.size() == 0)
+        return;
+
+    if (tokens[0]->type != Token::KEYWORD || tokens.first()->value.toUpper() != "DROP")
+        return;
+
+    tokens.removeFirst(); // remove "DROP" from front
+    tokens.trimLeft(); // remove whitespaces and comments from front
+    if (tokens.size() == 0)
+    {
+        qWarning() << "DROP statement, but after removing DROP from front of the query, nothing has left. Original query:" << query;
+        return;
+    }
+
+    QString type = tokens.first()->value.toUpper();
+
+    // Now go to the first ID in the tokens
+    while (tokens.size() > 0 && tokens.first()->type != Token::OTHER)
+        tokens.removeFirst();
+
+    if (tokens.size() == 0)
+    {
+        qWarning() << "DROP statement, but after removing DROP and non-ID tokens from front of the query, nothing has left. Original query:" << query;
+        return;
+    }
+
+    QString database = "main";
+    QString object;
+
+    if (tokens.size() > 1)
+    {
+        database = tokens.first()->value;
+        object = tokens.last()->value;
+    }
+    else
+        object = tokens.first()->value;
+
+    if (type == "TABLE")
+        droppedType = DbObjectType::TABLE;
+    else if (type == "INDEX")
+        droppedType = DbObjectType::INDEX;
+    else if (type == "TRIGGER")
+        droppedType = DbObjectType::TRIGGER;
+    else if (type == "VIEW")
+        droppedType = DbObjectType::VIEW;
+    else
+    {
+        qWarning() << "Unknown object type dropped:" << type;
+        return;
+    }
+
+    drop = true;
+    droppedDatabase = database;
+    droppedObject = stripObjName(object, dialect);
+}
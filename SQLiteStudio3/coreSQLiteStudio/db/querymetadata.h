@@ -0,0 +1,141 @@
+#ifndef QUERYMETADATA_H
+#define QUERYMETADATA_H
+
+#include "coreSQLiteStudio_global.h"
+#include "dialect.h"
+#include "dbobjecttype.h"
+#include "common/utils_sql.h"
+#include <QString>
+#include <QStringList>
+#include <QSharedPointer>
+#include <QCache>
+#include <QMutex>
+#include <QPair>
+
+class QueryMetadata;
+
+/**
+ * @brief Shared pointer to query metadata.
+ *
+ * Metadata objects are immutable once created, so they can be safely shared between queries and threads.
+ */
+typedef QSharedPointer<const QueryMetadata> QueryMetadataPtr;
+
+/**
+ * @brief Statement metadata extracted from the query string.
+ *
+ * It's everything that query execution needs to know about the statement before and after it's executed,
+ * that is the locking mode, bind parameters and the object dropped by the statement (if it's a DROP statement).
+ *
+ * All of it is extracted from a single tokenization of the query. Metadata is kept in a shared LRU cache,
+ * keyed by query string and dialect, so executing the same query string repeatedly doesn't involve the Lexer at all.
+ *
+ * Use get() to obtain metadata for the query. In most cases you should use SqlQuery::getMetadata() instead,
+ * which keeps the metadata for the lifetime of the query object.
+ */
+class API_EXPORT QueryMetadata
+{
+    public:
+        /**
+         * @brief Provides metadata for given query.
+         * @param query Query to get metadata for.
+         * @param dialect SQLite dialect of the query.
+         * @return Metadata from the cache, or newly extracted (and then cached) metadata.
+         *
+         * This method is thread-safe.
+         */
+        static QueryMetadataPtr get(const QString& query, Dialect dialect);
+
+        /**
+         * @brief Removes all entries from the metadata cache.
+         */
+        static void clearCache();
+
+        /**
+         * @brief Tells whether the query reads or modifies the database.
+         * @see getQueryAccessMode()
+         */
+        QueryAccessMode accessMode = QueryAccessMode::WRITE;
+
+        /**
+         * @brief true if the query is a SELECT (or WITH ... SELECT) statement.
+         */
+        bool select = false;
+
+        /**
+         * @brief Number of bind parameter tokens in the query.
+         */
+        int paramCount = 0;
+
+        /**
+         * @brief Bind parameter names (with the prefix character), in order of their occurrence in the query.
+         */
+        QStringList paramNames;
+
+        /**
+         * @brief true if the query may change the database schema (CREATE, DROP, ALTER, ATTACH, DETACH, etc).
+         */
+        bool schemaChange = false;
+
+        /**
+         * @brief true if the query is a PRAGMA that sets the journal mode.
+         *
+         * Such PRAGMA is a read query, but it decides whether reader connections can be used with the database.
+         */
+        bool journalModeChange = false;
+
+        /**
+         * @brief true if the query is a DROP statement with a recognized object type.
+         */
+        bool drop = false;
+
+        /**
+         * @brief Type of object dropped. Valid only if drop is true.
+         */
+        DbObjectType droppedType = DbObjectType::TABLE;
+
+        /**
+         * @brief Database name of the dropped object. Valid only if drop is true.
+         */
+        QString droppedDatabase;
+
+        /**
+         * @brief Name of the dropped object (already stripped of wrapping characters). Valid only if drop is true.
+         */
+        QString droppedObject;
+
+    private:
+        /**
+         * @brief Cache key - dialect (as integer) and the query string.
+         */
+        typedef QPair<int,QString> CacheKey;
+
+        QueryMetadata(const QString& query, Dialect dialect);
+
+        void extractDrop(TokenList tokens, const QString& query, Dialect dialect);
+        static bool isJournalModeChange(const TokenList& tokens);
+
+        /**
+         * @brief Maximum number of entries in the metadata cache.
+         */
+        static const int cacheSize = 1000;
+
+        /**
+         * @brief Queries longer than this are never cached.
+         *
+         * Long queries are usually unique (scripts, generated DDL), so caching them would only evict useful entries.
+         */
+        static const int maxCachedQueryLength = 10000;
+
+        /**
+         * @brief Guards the cache, as queries are executed from many threads.
+         */
+        static QMutex cacheMutex;
+
+        /**
+         * @brief Shared LRU cache of metadata.
+         */
+        static QCache<CacheKey,QueryMetadataPtr> cache;
+};
+
+#endif // QUERYMETADATA_H
@@ -25,6 +25,24 @@ SqlResultsRowPtr SqlQuery::next()
     return nextInternal();
 }
 
+const SqlResultsRowBlock& SqlQuery::nextBatch(int maxRows)
+{
+    // Resizing to 0 keeps the allocated memory, so the block is allocated only once.
+    rowBlock.resize(0);
+    rowBlock.reserve(maxRows);
+
+    if (preloaded)
+    {
+        while (rowBlock.size() < maxRows && preloadedRowIdx < preloadedData.size())
+            rowBlock << preloadedData[preloadedRowIdx++];
+
+        return rowBlock;
+    }
+
+    nextBatchInternal(rowBlock, maxRows);
+    return rowBlock;
+}
+
 bool SqlQuery::hasNext()
 {
     if (preloaded)
@@ -33,6 +51,19 @@ bool SqlQuery::hasNext()
     return hasNextInternal();
 }
 
+void SqlQuery::nextBatchInternal(SqlResultsRowBlock& block, int maxRows)
+{
+    SqlResultsRowPtr row;
+    while (block.size() < maxRows && hasNextInternal())
+    {
+        row = nextInternal();
+        if (row.isNull())
+            break;
+
+        block << row;
+    }
+}
+
 qint64 SqlQuery::rowsAffected()
 {
     return affected;
@@ -89,6 +120,22 @@ qint64 SqlQuery::getRegularInsertRowId()
     return insertRowId["ROWID"].toLongLong();
 }
 
+QueryMetadataPtr SqlQuery::getMetadata(Dialect dialect)
+{
+    if (!metadata)
+        metadata = QueryMetadata::get(query, dialect);
+
+    return metadata;
+}
+
+ReadWriteLocker::Mode SqlQuery::getLockingMode(Dialect dialect)
+{
+    if (flags.testFlag(Db::Flag::NO_LOCK))
+        return ReadWriteLocker::NONE;
+
+    return ReadWriteLocker::getMode(getMetadata(dialect)->accessMode, false);
+}
+
 QString SqlQuery::getQuery() const
 {
     return query;
@@ -4,6 +4,8 @@
 #include "coreSQLiteStudio_global.h"
 #include "db/db.h"
 #include "db/sqlresultsrow.h"
+#include "db/querymetadata.h"
+#include "common/readwritelocker.h"
 #include <QList>
 #include <QSharedPointer>
 
@@ -84,6 +86,30 @@ class API_EXPORT SqlQuery
          */
         SqlResultsRowPtr next();
 
+        /**
+         * @brief Reads block of next rows of results.
+         * @param maxRows Maximum number of rows to read.
+         * @return Rows read. The block is shorter than maxRows (or empty) if there are no more rows available.
+         *
+         * This is meant for bulk consumers (exporting, copying data, etc), which process all rows anyway.
+         * Reading rows in blocks lets implementations skip per-row checks done by hasNext(),
+         * and lets the consumer process the whole block at once.
+         *
+         * Returned block is owned by the query and it's reused by the next call to this method,
+         * so it doesn't reallocate with each block. Copy it if you need to keep it.
+         *
+         * Typical workflow:
+         * @code
+         * SqlQueryPtr results = db->exec("SELECT * FROM table");
+         * while (results->hasNext())
+         * {
+         *     for (const SqlResultsRowPtr& row : results->nextBatch(1000))
+         *         qDebug() << row->valueList();
+         * }
+         * @endcode
+         */
+        const SqlResultsRowBlock& nextBatch(int maxRows);
+
         /**
          * @brief Tells if there is next row available.
          * @return true if there's next row, of false if there's not.
@@ -243,6 +269,17 @@ class API_EXPORT SqlQuery
             return list;
         }
 
+        /**
+         * @brief Provides metadata of the query.
+         * @param dialect SQLite dialect of the query.
+         * @return Access mode, bind parameters and dropped object of the query.
+         *
+         * Metadata is obtained from QueryMetadata::get() with the first call to this method
+         * and then it's kept for the lifetime of this query object, so consecutive executions
+         * of the same query don't need to look it up again.
+         */
+        QueryMetadataPtr getMetadata(Dialect dialect);
+
         QString getQuery() const;
         void setFlags(Db::Flags flags);
         void clearArgs();
@@ -268,9 +305,30 @@ class API_EXPORT SqlQuery
          */
         virtual bool hasNextInternal() = 0;
 
+        /**
+         * @brief Reads block of next rows of results.
+         * @param block Block to append rows to. It's empty when this method is called.
+         * @param maxRows Maximum number of rows to read.
+         *
+         * This is pretty much the same as nextBatch(), except nextBatch() handles preloaded data,
+         * while this method should work natively on the derived implementation of results object.
+         *
+         * Default implementation reads rows one by one with nextInternal().
+         */
+        virtual void nextBatchInternal(SqlResultsRowBlock& block, int maxRows);
+
         virtual bool execInternal(const QList<QVariant>& args) = 0;
         virtual bool execInternal(const QHash<QString, QVariant>& args) = 0;
 
+        /**
+         * @brief Provides locking mode for executing this query.
+         * @param dialect SQLite dialect of the query.
+         * @return NONE if Db::Flag::NO_LOCK is set, or mode matching the query access mode otherwise.
+         *
+         * When NO_LOCK is set, the query metadata is not even looked up.
+         */
+        ReadWriteLocker::Mode getLockingMode(Dialect dialect);
+
         /**
          * @brief Row ID of the most recently inserted row.
          */
@@ -294,9 +352,20 @@ class API_EXPORT SqlQuery
          */
         QList<SqlResultsRowPtr> preloadedData;
 
+        /**
+         * @brief Block of rows returned from nextBatch(), reused between calls.
+         */
+        SqlResultsRowBlock rowBlock;
+
         int affected = 0;
 
         QString query;
+
+        /**
+         * @brief Metadata of the query, initialized lazily by getMetadata().
+         */
+        QueryMetadataPtr metadata;
+
         QVariant queryArgs;
         Db::Flags flags;
 };
@@ -8,17 +8,43 @@ SqlResultsRow::~SqlResultsRow()
 {
 }
 
+SqlResultsRow::ColumnIndex SqlResultsRow::createColumnIndex(const QStringList& columns)
+{
+    QHash<QString,int>* index = new QHash<QString,int>();
+    index->reserve(columns.size());
+    for (int i = 0; i < columns.size(); i++)
+        (*index)[columns[i]] = i;
+
+    return ColumnIndex(index);
+}
+
 const QVariant SqlResultsRow::value(const QString &key) const
 {
-    return valuesMap[key];
+    if (!columnIndex)
+        return QVariant();
+
+    return value(columnIndex->value(key, -1));
+}
+
+QHash<QString, QVariant> SqlResultsRow::valueMap() const
+{
+    QHash<QString, QVariant> map;
+    if (!columnIndex)
+        return map;
+
+    map.reserve(columnIndex->size());
+    for (auto it = columnIndex->constBegin(), end = columnIndex->constEnd(); it != end; ++it)
+        map[it.key()] = value(it.value());
+
+    return map;
 }
 
-const QHash<QString, QVariant> &SqlResultsRow::valueMap() const
+QList<QVariant> SqlResultsRow::valueList() const
 {
-    return valuesMap;
+    return values.toList();
 }
 
-const QList<QVariant>& SqlResultsRow::valueList() const
+const QVector<QVariant>& SqlResultsRow::valueVector() const
 {
     return values;
 }
@@ -33,7 +59,7 @@ const QVariant SqlResultsRow::value(int idx) const
 
 bool SqlResultsRow::contains(const QString &key) const
 {
-    return valuesMap.contains(key);
+    return columnIndex && columnIndex->contains(key);
 }
 
 bool SqlResultsRow::contains(int idx) const
@@ -4,7 +4,9 @@
 #include "coreSQLiteStudio_global.h"
 #include <QVariant>
 #include <QList>
+#include <QVector>
 #include <QHash>
+#include <QStringList>
 #include <QSharedPointer>
 
 /** @file */
@@ -21,15 +23,35 @@
  * is just an interface to read data from it.
  *
  * In other words, it's kind of an abstract class.
+ *
+ * Values are kept in a single contiguous vector. Column names are not stored in the row.
+ * Instead all rows of the same results share a single ColumnIndex, which maps column names
+ * to value indexes, so the per-row cost is just the vector of values.
  */
 class API_EXPORT SqlResultsRow
 {
     public:
+        /**
+         * @brief Mapping of column names to indexes of values in the row.
+         *
+         * It's created once per results (see createColumnIndex()) and shared by all rows of those results.
+         */
+        typedef QSharedPointer<const QHash<QString,int>> ColumnIndex;
+
         /**
          * @brief Releases resources.
          */
         virtual ~SqlResultsRow();
 
+        /**
+         * @brief Creates column index to be shared by rows.
+         * @param columns Column names, in order of values in the rows.
+         * @return Shared column index.
+         *
+         * If the same column name occurs more than once, the name is mapped to the last of those columns.
+         */
+        static ColumnIndex createColumnIndex(const QStringList& columns);
+
         /**
          * @brief Gets value for given column.
          * @param key Column name.
@@ -51,16 +73,28 @@ class API_EXPORT SqlResultsRow
          * Note, that QHash doesn't guarantee order of entries. If you want to iterate through columns
          * in order they were returned from the database, use valueList(), or iterate through SqlResults::getColumnNames()
          * and use it to call value().
+         *
+         * The hash table is built with each call, so use value() if you need just few values.
          */
-        const QHash<QString, QVariant>& valueMap() const;
+        QHash<QString, QVariant> valueMap() const;
 
         /**
          * @brief Gets list of values in this row.
          * @return Ordered list of values in the row.
          *
          * Note, that this method returns values in order they were returned from database.
+         *
+         * The list is built with each call, so prefer valueVector() when you only iterate through values.
+         */
+        QList<QVariant> valueList() const;
+
+        /**
+         * @brief Gets values in this row.
+         * @return Ordered values in the row, in order they were returned from database.
+         *
+         * This is the internal storage of the row, so no copy is made.
          */
-        const QList<QVariant>& valueList() const;
+        const QVector<QVariant>& valueVector() const;
 
         /**
          * @brief Tests if the row contains given column name.
@@ -80,18 +114,14 @@ class API_EXPORT SqlResultsRow
         SqlResultsRow();
 
         /**
-         * @brief Columns and their values in the row.
+         * @brief Column name to value index mapping, shared by all rows of the results.
          */
-        QHash<QString,QVariant> valuesMap;
+        ColumnIndex columnIndex;
+
         /**
-         * @brief Ordered list of values in the row.
-         *
-         * Technical note:
-         * We keep list of values next to valuesMap, so we have it in the same order as column names when asked by valueList().
-         * This looks like having redundant data storage, but Qt container classes (such as QVariant)
-         * use smart pointers to keep their data internally, so here we actually keep only reference objects.
+         * @brief Ordered values in the row.
          */
-        QList<QVariant> values;
+        QVector<QVariant> values;
 };
 
 /**
@@ -99,4 +129,9 @@ class API_EXPORT SqlResultsRow
  */
 typedef QSharedPointer<SqlResultsRow> SqlResultsRowPtr;
 
+/**
+ * @brief Block of consecutive rows, as read by SqlQuery::nextBatch().
+ */
+typedef QVector<SqlResultsRowPtr> SqlResultsRowBlock;
+
 #endif // SQLRESULTSROW_H
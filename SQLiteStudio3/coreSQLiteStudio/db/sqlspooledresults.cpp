@@ -0,0 +1,247 @@
+#include "sqlspooledresults.h"
+#include "sqlerrorcodes.h"
+#include "common/unused.h"
+#include "common/utils.h"
+#include <QTemporaryFile>
+#include <QtNumeric>
+#include <QDebug>
+
+SqlSpooledResults::SqlSpooledResults(const QStringList& columns) :
+    columns(columns)
+{
+    columnIndex = SqlResultsRow::createColumnIndex(columns);
+    dataLengths.fill(0, columns.size());
+}
+
+SqlSpooledResults::~SqlSpooledResults()
+{
+    stream.setDevice(nullptr);
+    safe_delete(file);
+}
+
+bool SqlSpooledResults::append(const SqlResultsRowBlock& rows)
+{
+    if (errorCode != 0)
+        return false;
+
+    int length;
+    for (const SqlResultsRowPtr& row : rows)
+    {
+        const QVector<QVariant>& values = row->valueVector();
+        qint64 size = sizeof(Row);
+        for (int i = 0; i < values.size() && i < dataLengths.size(); i++)
+        {
+            length = getDataLength(values[i]);
+            if (length > dataLengths[i])
+                dataLengths[i] = length;
+
+            size += getMemorySize(values[i]);
+        }
+        rowCount++;
+
+        if (!file && memorySize + size <= maxMemorySize)
+        {
+            // Rows are immutable, so the row read from the original results can be kept as it is
+            memoryRows << row;
+            memorySize += size;
+            continue;
+        }
+
+        if (!file && !openFile())
+            return false;
+
+        if (!writeRow(values))
+            return false;
+    }
+    return true;
+}
+
+bool SqlSpooledResults::finishAppending()
+{
+    rowsRead = 0;
+    if (!file || errorCode != 0)
+        return errorCode == 0;
+
+    stream.setDevice(nullptr);
+    if (!file->flush() || !file->seek(0))
+    {
+        setError(QObject::tr("Could not read temporary file %1: %2").arg(file->fileName(), file->errorString()));
+        return false;
+    }
+
+    stream.setDevice(file);
+    return true;
+}
+
+qint64 SqlSpooledResults::getRowCount() const
+{
+    return rowCount;
+}
+
+QList<int> SqlSpooledResults::getDataLengths() const
+{
+    return dataLengths.toList();
+}
+
+QString SqlSpooledResults::getErrorText()
+{
+    return errorText;
+}
+
+int SqlSpooledResults::getErrorCode()
+{
+    return errorCode;
+}
+
+QStringList SqlSpooledResults::getColumnNames()
+{
+    return columns;
+}
+
+int SqlSpooledResults::columnCount()
+{
+    return columns.size();
+}
+
+SqlResultsRowPtr SqlSpooledResults::nextInternal()
+{
+    if (!hasNextInternal())
+        return SqlResultsRowPtr();
+
+    if (rowsRead < memoryRows.size())
+        return memoryRows[rowsRead++];
+
+    SqlResultsRowPtr row = readRow();
+    if (row)
+        rowsRead++;
+
+    return row;
+}
+
+bool SqlSpooledResults::hasNextInternal()
+{
+    return errorCode == 0 && rowsRead < rowCount;
+}
+
+void SqlSpooledResults::nextBatchInternal(SqlResultsRowBlock& block, int maxRows)
+{
+    while (block.size() < maxRows && rowsRead < memoryRows.size())
+        block << memoryRows[rowsRead++];
+
+    SqlResultsRowPtr row;
+    while (block.size() < maxRows && hasNextInternal())
+    {
+        row = readRow();
+        if (!row)
+            break;
+
+        block << row;
+        rowsRead++;
+    }
+}
+
+bool SqlSpooledResults::execInternal(const QList<QVariant>& args)
+{
+    UNUSED(args);
+    return false;
+}
+
+bool SqlSpooledResults::execInternal(const QHash<QString, QVariant>& args)
+{
+    UNUSED(args);
+    return false;
+}
+
+bool SqlSpooledResults::openFile()
+{
+    file = new QTemporaryFile();
+    if (!file->open())
+    {
+        setError(QObject::tr("Could not create temporary file for results: %1").arg(file->errorString()));
+        return false;
+    }
+
+    stream.setDevice(file);
+    return true;
+}
+
+bool SqlSpooledResults::writeRow(const QVector<QVariant>& values)
+{
+    for (const QVariant& value : values)
+        stream << value;
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        setError(QObject::tr("Could not write to temporary file %1: %2").arg(file->fileName(), file->errorString()));
+        return false;
+    }
+
+    return true;
+}
+
+SqlResultsRowPtr SqlSpooledResults::readRow()
+{
+    QVector<QVariant> values(columns.size());
+    for (QVariant& value : values)
+        stream >> value;
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        setError(QObject::tr("Could not read temporary file %1: %2").arg(file->fileName(), file->errorString()));
+        return SqlResultsRowPtr();
+    }
+
+    return SqlResultsRowPtr(new Row(columnIndex, values));
+}
+
+void SqlSpooledResults::setError(const QString& text)
+{
+    qWarning() << "Error in spooled results:" << text;
+    errorText = text;
+    errorCode = SqlErrorCode::OTHER_EXECUTION_ERROR;
+}
+
+qint64 SqlSpooledResults::getMemorySize(const QVariant& value)
+{
+    switch (value.type())
+    {
+        case QVariant::String:
+            return sizeof(QVariant) + value.toString().size() * sizeof(QChar);
+        case QVariant::ByteArray:
+            return sizeof(QVariant) + value.toByteArray().size();
+        default:
+            break;
+    }
+    return sizeof(QVariant);
+}
+
+int SqlSpooledResults::getDataLength(const QVariant& value)
+{
+    if (value.isNull())
+        return 0;
+
+    switch (value.type())
+    {
+        case QVariant::ByteArray:
+            return value.toByteArray().size();
+        case QVariant::Double:
+        {
+            // SQLite converts REAL to text with "%!.15g", which keeps at least one decimal digit, like in "1.0e+20"
+            double number = value.toDouble();
+            QString text = QString::number(number, 'g', 15);
+            if (qIsFinite(number) && !text.contains('.'))
+                return text.length() + 2;
+
+            return text.length();
+        }
+        default:
+            break;
+    }
+    return value.toString().length();
+}
+
+SqlSpooledResults::Row::Row(const ColumnIndex& columns, const QVector<QVariant>& values)
+{
+    columnIndex = columns;
+    this->values = values;
+}
@@ -0,0 +1,106 @@
+#ifndef SQLSPOOLEDRESULTS_H
+#define SQLSPOOLEDRESULTS_H
+
+#include "sqlquery.h"
+#include <QStringList>
+#include <QDataStream>
+
+class QTemporaryFile;
+
+/**
+ * @brief SqlResults implementation for replaying rows read once from other results.
+ *
+ * Rows are appended with append() in blocks, as they are read from the original results. While they are appended,
+ * the number of rows and the maximum data length of each column are collected, so they are known before the rows are read again,
+ * without running any extra counting queries against the database.
+ *
+ * First rows are kept in memory. Once they take more than maxMemorySize bytes, further rows are written
+ * to a temporary file, so results of any size can be spooled. After all rows are appended, call finishAppending()
+ * and then read rows just like from any other results. They are read in the same order they were appended.
+ */
+class API_EXPORT SqlSpooledResults : public SqlQuery
+{
+    public:
+        /**
+         * @brief Creates empty results.
+         * @param columns Column names of the spooled rows.
+         */
+        explicit SqlSpooledResults(const QStringList& columns);
+        ~SqlSpooledResults();
+
+        /**
+         * @brief Appends rows to the results.
+         * @param rows Rows to append.
+         * @return true on success, or false if rows could not be written to the temporary file.
+         *
+         * In case of failure the error is available with getErrorText().
+         */
+        bool append(const SqlResultsRowBlock& rows);
+
+        /**
+         * @brief Ends appending rows and prepares results for reading.
+         * @return true on success, or false if the temporary file could not be read.
+         */
+        bool finishAppending();
+
+        /**
+         * @brief Provides number of rows appended.
+         * @return Number of rows.
+         */
+        qint64 getRowCount() const;
+
+        /**
+         * @brief Provides maximum data length of each column.
+         * @return Lengths, in the same order as columns.
+         *
+         * Lengths are calculated the same way as SQLite's length() function does, so text is measured in characters,
+         * blobs in bytes and numbers by the length of their text representation. Null values are not counted.
+         */
+        QList<int> getDataLengths() const;
+
+        QString getErrorText();
+        int getErrorCode();
+        QStringList getColumnNames();
+        int columnCount();
+
+    protected:
+        SqlResultsRowPtr nextInternal();
+        bool hasNextInternal();
+        void nextBatchInternal(SqlResultsRowBlock& block, int maxRows);
+        bool execInternal(const QList<QVariant>& args);
+        bool execInternal(const QHash<QString, QVariant>& args);
+
+    private:
+        class Row : public SqlResultsRow
+        {
+            public:
+                Row(const ColumnIndex& columns, const QVector<QVariant>& values);
+        };
+
+        bool openFile();
+        bool writeRow(const QVector<QVariant>& values);
+        SqlResultsRowPtr readRow();
+        void setError(const QString& text);
+
+        static qint64 getMemorySize(const QVariant& value);
+        static int getDataLength(const QVariant& value);
+
+        /**
+         * @brief Size of rows kept in memory, before further rows are written to a temporary file.
+         */
+        static const qint64 maxMemorySize = 64 * 1024 * 1024;
+
+        QStringList columns;
+        SqlResultsRow::ColumnIndex columnIndex;
+        SqlResultsRowBlock memoryRows;
+        qint64 memorySize = 0;
+        QTemporaryFile* file = nullptr;
+        QDataStream stream;
+        qint64 rowCount = 0;
+        qint64 rowsRead = 0;
+        QVector<int> dataLengths;
+        QString errorText;
+        int errorCode = 0;
+};
+
+#endif // SQLSPOOLEDRESULTS_H
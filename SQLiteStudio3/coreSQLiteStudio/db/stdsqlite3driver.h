@@ -9,6 +9,7 @@
         static const int OK = UppercasePrefix##SQLITE_OK; \
         static const int ERROR = UppercasePrefix##SQLITE_ERROR; \
         static const int OPEN_READWRITE = UppercasePrefix##SQLITE_OPEN_READWRITE; \
+        static const int OPEN_READONLY = UppercasePrefix##SQLITE_OPEN_READONLY; \
         static const int OPEN_CREATE = UppercasePrefix##SQLITE_OPEN_CREATE; \
         static const int UTF8 = UppercasePrefix##SQLITE_UTF8; \
         static const int INTEGER = UppercasePrefix##SQLITE_INTEGER; \
@@ -42,6 +43,8 @@
         static int bind_int64(stmt* a1, int a2, int64 a3) {return Prefix##sqlite3_bind_int64(a1, a2, a3);} \
         static int bind_null(stmt* a1, int a2) {return Prefix##sqlite3_bind_null(a1, a2);} \
         static int bind_parameter_index(stmt* a1, const char* a2) {return Prefix##sqlite3_bind_parameter_index(a1, a2);} \
+        static int bind_parameter_count(stmt* arg) {return Prefix##sqlite3_bind_parameter_count(arg);} \
+        static const char *bind_parameter_name(stmt* a1, int a2) {return Prefix##sqlite3_bind_parameter_name(a1, a2);} \
         static int bind_text16(stmt* a1, int a2, const void* a3, int a4, void(*a5)(void*)) {return Prefix##sqlite3_bind_text16(a1, a2, a3, a4, a5);} \
         static void result_blob(context* a1, const void* a2, int a3, void(*a4)(void*)) {Prefix##sqlite3_result_blob(a1, a2, a3, a4);} \
         static void result_double(context* a1, double a2) {Prefix##sqlite3_result_double(a1, a2);} \
@@ -68,7 +71,9 @@
         static int last_insert_rowid(handle* arg) {return Prefix##sqlite3_last_insert_rowid(arg);} \
         static int step(stmt* arg) {return Prefix##sqlite3_step(arg);} \
         static int reset(stmt* arg) {return Prefix##sqlite3_reset(arg);} \
+        static int clear_bindings(stmt* arg) {return Prefix##sqlite3_clear_bindings(arg);} \
         static int close(handle* arg) {return Prefix##sqlite3_close(arg);} \
+        static int get_autocommit(handle* arg) {return Prefix##sqlite3_get_autocommit(arg);} \
         static int enable_load_extension(handle* arg1, int arg2) {return Prefix##sqlite3_enable_load_extension(arg1, arg2);} \
         static void* user_data(context* arg) {return Prefix##sqlite3_user_data(arg);} \
         static void* aggregate_context(context* arg1, int arg2) {return Prefix##sqlite3_aggregate_context(arg1, arg2);} \
@@ -456,28 +456,27 @@ bool DbObjectOrganizer::copyDataAsMiddleware(const QString& table)
     QString sql = "INSERT INTO " + wrappedDstTable + " VALUES (" + argPlaceholderList.join(", ") + ")";
     SqlQueryPtr insertQuery = dstDb->prepare(sql);
 
-    SqlResultsRowPtr row;
-    int i = 0;
     while (results->hasNext())
     {
-        row = results->next();
-        if (!row)
+        for (const SqlResultsRowPtr& row : results->nextBatch(1000))
         {
-            notifyError(tr("Error while copying data to table %1: %2").arg(table).arg(results->getErrorText()));
-            return false;
+            insertQuery->setArgs(row->valueList());
+            if (!insertQuery->execute())
+            {
+                notifyError(tr("Error while copying data to table %1: %2").arg(table).arg(insertQuery->getErrorText()));
+                return false;
+            }
         }
 
-        insertQuery->setArgs(row->valueList());
-        if (!insertQuery->execute())
+        // Block ends early if reading a row failed.
+        if (results->isError())
         {
-            notifyError(tr("Error while copying data to table %1: %2").arg(table).arg(insertQuery->getErrorText()));
+            notifyError(tr("Error while copying data to table %1: %2").arg(table).arg(results->getErrorText()));
             return false;
         }
 
-        if ((i % 1000) == 0 && isInterrupted())
+        if (isInterrupted())
             return false;
-
-        i++;
     }
 
     if (isInterrupted())
@@ -108,8 +108,6 @@ bool ExportWorker::exportQueryResults()
     }
 
     QList<QueryExecutor::ResultColumnPtr> resultColumns = executor->getResultColumns();
-    QHash<ExportManager::ExportProviderFlag,QVariant> providerData = getProviderDataForQueryResults();
-
     if (results->isInterrupted())
     {
         logExportFail("exportQueryResults() -> interrupted(1)");
@@ -123,6 +121,20 @@ bool ExportWorker::exportQueryResults()
         return false;
     }
 
+    QHash<ExportManager::ExportProviderFlag,QVariant> providerData;
+    if (needsProviderData())
+    {
+        QSharedPointer<SqlSpooledResults> spooledResults = spoolResults(results);
+        if (!spooledResults)
+        {
+            logExportFail("exportQueryResults() -> spoolResults()");
+            return false;
+        }
+
+        providerData = getProviderData(*spooledResults);
+        results = spooledResults;
+    }
+
     if (!plugin->initBeforeExport(db, output, *config))
     {
         logExportFail("initBeforeExport()");
@@ -141,13 +153,15 @@ bool ExportWorker::exportQueryResults()
         return false;
     }
 
-    SqlResultsRowPtr row;
     while (results->hasNext())
     {
-        row = results->next();
-        if (!plugin->exportQueryResultsRow(row))
+        const SqlResultsRowBlock& rows = results->nextBatch(rowBlockSize);
+        if (rows.isEmpty() || results->isError())
+            break;
+
+        if (!plugin->exportQueryResultsRows(rows))
         {
-            logExportFail("exportQueryResultsRow()");
+            logExportFail("exportQueryResultsRows()");
             return false;
         }
 
@@ -158,6 +172,13 @@ bool ExportWorker::exportQueryResults()
         }
     }
 
+    if (results->isError())
+    {
+        logExportFail("exportQueryResults() -> reading rows");
+        notifyError(tr("Error while exporting query results: %1").arg(results->getErrorText()));
+        return false;
+    }
+
     if (!plugin->afterExportQueryResults())
     {
         logExportFail("afterExportQueryResults()");
@@ -173,43 +194,56 @@ bool ExportWorker::exportQueryResults()
     return true;
 }
 
-QHash<ExportManager::ExportProviderFlag, QVariant> ExportWorker::getProviderDataForQueryResults()
+bool ExportWorker::needsProviderData() const
 {
-    static const QString colLengthSql = QStringLiteral("SELECT %1 FROM (%2)");
-    static const QString colLengthTpl = QStringLiteral("max(length(%1))");
-    QHash<ExportManager::ExportProviderFlag, QVariant> providerData;
-
-    if (plugin->getProviderFlags().testFlag(ExportManager::ROW_COUNT))
-    {
-        executor->countResults();
-        providerData[ExportManager::ROW_COUNT] = executor->getTotalRowsReturned();
-    }
+    ExportManager::ExportProviderFlags flags = plugin->getProviderFlags();
+    return flags.testFlag(ExportManager::ROW_COUNT) || flags.testFlag(ExportManager::DATA_LENGTHS);
+}
 
-    if (plugin->getProviderFlags().testFlag(ExportManager::DATA_LENGTHS))
+QSharedPointer<SqlSpooledResults> ExportWorker::spoolResults(SqlQueryPtr results)
+{
+    // Rows are read once and kept for the export, while their count and widths are collected on the way
+    QSharedPointer<SqlSpooledResults> spooledResults = QSharedPointer<SqlSpooledResults>::create(results->getColumnNames());
+    while (results->hasNext())
     {
-        QStringList wrappedCols;
-        for (const QueryExecutor::ResultColumnPtr& col : executor->getResultColumns())
-            wrappedCols << colLengthTpl.arg(wrapObjIfNeeded(col->displayName, db->getDialect()));
+        const SqlResultsRowBlock& rows = results->nextBatch(rowBlockSize);
+        if (rows.isEmpty() || results->isError())
+            break;
 
-        executor->exec(colLengthSql.arg(wrappedCols.join(", "), query));
-        SqlQueryPtr results = executor->getResults();
-        if (!results)
-        {
-            qCritical() << "Null results from executor in ExportWorker.";
-        }
-        else if (results->isError())
+        if (!spooledResults->append(rows))
         {
-            notifyError(tr("Error while counting data column width to export from query results: %1").arg(results->getErrorText()));
+            notifyError(tr("Error while reading data to export: %1").arg(spooledResults->getErrorText()));
+            return QSharedPointer<SqlSpooledResults>();
         }
-        else
-        {
-            QList<int> colWidths;
-            for (const QVariant& value : results->next()->valueList())
-                colWidths << value.toInt();
 
-            providerData[ExportManager::DATA_LENGTHS] = QVariant::fromValue(colWidths);
-        }
+        if (isInterrupted())
+            return QSharedPointer<SqlSpooledResults>();
+    }
+
+    if (results->isError())
+    {
+        notifyError(tr("Error while reading data to export: %1").arg(results->getErrorText()));
+        return QSharedPointer<SqlSpooledResults>();
     }
+
+    if (!spooledResults->finishAppending())
+    {
+        notifyError(tr("Error while reading data to export: %1").arg(spooledResults->getErrorText()));
+        return QSharedPointer<SqlSpooledResults>();
+    }
+
+    return spooledResults;
+}
+
+QHash<ExportManager::ExportProviderFlag, QVariant> ExportWorker::getProviderData(const SqlSpooledResults& results) const
+{
+    QHash<ExportManager::ExportProviderFlag, QVariant> providerData;
+    if (plugin->getProviderFlags().testFlag(ExportManager::ROW_COUNT))
+        providerData[ExportManager::ROW_COUNT] = results.getRowCount();
+
+    if (plugin->getProviderFlags().testFlag(ExportManager::DATA_LENGTHS))
+        providerData[ExportManager::DATA_LENGTHS] = QVariant::fromValue(results.getDataLengths());
+
     return providerData;
 }
 
@@ -350,7 +384,7 @@ bool ExportWorker::exportDatabaseObjects(const QList<ExportManager::ExportObject
         switch (obj->type)
         {
             case ExportManager::ExportObject::TABLE:
-                res = exportTableInternal(obj->database, obj->name, obj->ddl, parsedQuery, obj->data, obj->providerData);
+                res = exportTableInternal(obj->database, obj->name, obj->ddl, parsedQuery, obj->data);
                 break;
             case ExportManager::ExportObject::INDEX:
                 res = plugin->exportIndex(obj->database, obj->name, obj->ddl, parsedQuery.dynamicCast<SqliteCreateIndex>());
@@ -385,8 +419,7 @@ bool ExportWorker::exportTable()
 {
     SqlQueryPtr results;
     QString errorMessage;
-    QHash<ExportManager::ExportProviderFlag,QVariant> providerData;
-    queryTableDataToExport(db, table, results, providerData, &errorMessage);
+    queryTableDataToExport(db, table, results, &errorMessage);
     if (!errorMessage.isNull())
     {
         logExportFail("fetching table data");
@@ -395,6 +428,7 @@ bool ExportWorker::exportTable()
     }
 
     SchemaResolver resolver(db);
+    resolver.setUseReader(true);
     QString ddl = resolver.getObjectDdl(database, table, SchemaResolver::TABLE);
 
     if (!parser->parse(ddl) || parser->getQueries().size() < 1)
@@ -411,7 +445,7 @@ bool ExportWorker::exportTable()
         return false;
     }
 
-    if (!exportTableInternal(database, table, ddl, createTable, results, providerData))
+    if (!exportTableInternal(database, table, ddl, createTable, results))
     {
         logExportFail("exportTableInternal()");
         return false;
@@ -476,8 +510,7 @@ bool ExportWorker::exportTable()
     return true;
 }
 
-bool ExportWorker::exportTableInternal(const QString& database, const QString& table, const QString& ddl, SqliteQueryPtr parsedDdl, SqlQueryPtr results,
-                                       const QHash<ExportManager::ExportProviderFlag,QVariant>& providerData)
+bool ExportWorker::exportTableInternal(const QString& database, const QString& table, const QString& ddl, SqliteQueryPtr parsedDdl, SqlQueryPtr results)
 {
     SqliteCreateTablePtr createTable = parsedDdl.dynamicCast<SqliteCreateTable>();
     SqliteCreateVirtualTablePtr createVirtualTable = parsedDdl.dynamicCast<SqliteCreateVirtualTable>();
@@ -486,6 +519,20 @@ bool ExportWorker::exportTableInternal(const QString& database, const QString& t
     if (results)
         colNames = results->getColumnNames();
 
+    QHash<ExportManager::ExportProviderFlag,QVariant> providerData;
+    if (results && needsProviderData())
+    {
+        QSharedPointer<SqlSpooledResults> spooledResults = spoolResults(results);
+        if (!spooledResults)
+        {
+            logExportFail("exportTableInternal() -> spoolResults()");
+            return false;
+        }
+
+        providerData = getProviderData(*spooledResults);
+        results = spooledResults;
+    }
+
     if (createTable)
     {
         if (!results)
@@ -512,15 +559,17 @@ bool ExportWorker::exportTableInternal(const QString& database, const QString& t
         return false;
     }
 
-    SqlResultsRowPtr row;
     if (results)
     {
         while (results->hasNext())
         {
-            row = results->next();
-            if (!plugin->exportTableRow(row))
+            const SqlResultsRowBlock& rows = results->nextBatch(rowBlockSize);
+            if (rows.isEmpty() || results->isError())
+                break;
+
+            if (!plugin->exportTableRows(rows))
             {
-                logExportFail("exportTableRow()");
+                logExportFail("exportTableRows()");
                 return false;
             }
 
@@ -530,6 +579,13 @@ bool ExportWorker::exportTableInternal(const QString& database, const QString& t
                 return false;
             }
         }
+
+        if (results->isError())
+        {
+            logExportFail("exportTableRows() -> reading rows");
+            notifyError(tr("Error while reading data to export from table %1: %2").arg(table, results->getErrorText()));
+            return false;
+        }
     }
 
     if (!plugin->afterExportTable())
@@ -544,6 +600,7 @@ bool ExportWorker::exportTableInternal(const QString& database, const QString& t
 QList<ExportManager::ExportObjectPtr> ExportWorker::collectDbObjects(QString* errorMessage)
 {
     SchemaResolver resolver(db);
+    resolver.setUseReader(true);
     StrHash<SchemaResolver::ObjectDetails> allDetails = resolver.getAllObjectDetails();
 
     QList<ExportManager::ExportObjectPtr> objectsToExport;
@@ -562,7 +619,7 @@ QList<ExportManager::ExportObjectPtr> ExportWorker::collectDbObjects(QString* er
         if (details.type == SchemaResolver::TABLE)
         {
             exportObj->type = ExportManager::ExportObject::TABLE;
-            queryTableDataToExport(db, objName, exportObj->data, exportObj->providerData, errorMessage);
+            queryTableDataToExport(db, objName, exportObj->data, errorMessage);
             if (!errorMessage->isNull())
                 return objectsToExport;
         }
@@ -591,55 +648,16 @@ QList<ExportManager::ExportObjectPtr> ExportWorker::collectDbObjects(QString* er
     return objectsToExport;
 }
 
-void ExportWorker::queryTableDataToExport(Db* db, const QString& table, SqlQueryPtr& dataPtr, QHash<ExportManager::ExportProviderFlag,QVariant>& providerData,
-                                          QString* errorMessage) const
+void ExportWorker::queryTableDataToExport(Db* db, const QString& table, SqlQueryPtr& dataPtr, QString* errorMessage) const
 {
     static const QString sql = QStringLiteral("SELECT * FROM %1");
-    static const QString countSql = QStringLiteral("SELECT count(*) FROM %1");
-    static const QString colLengthSql = QStringLiteral("SELECT %1 FROM %2");
-    static const QString colLengthTpl = QStringLiteral("max(length(%1))");
 
     if (config->exportData)
     {
         QString wrappedTable = wrapObjIfNeeded(table, db->getDialect());
-        dataPtr = db->exec(sql.arg(wrappedTable));
+        dataPtr = db->exec(sql.arg(wrappedTable), Db::Flag::USE_READER);
         if (dataPtr->isError() && !errorMessage->isNull())
             *errorMessage = tr("Error while reading data to export from table %1: %2").arg(table, dataPtr->getErrorText());
-
-        if (plugin->getProviderFlags().testFlag(ExportManager::ROW_COUNT))
-        {
-            SqlQueryPtr countQuery = db->exec(countSql.arg(wrappedTable));
-            if (countQuery->isError())
-            {
-                if (!errorMessage->isNull())
-                    *errorMessage = tr("Error while counting data to export from table %1: %2").arg(table, countQuery->getErrorText());
-            }
-            else
-                providerData[ExportManager::ROW_COUNT] = countQuery->getSingleCell().toInt();
-        }
-
-        if (plugin->getProviderFlags().testFlag(ExportManager::DATA_LENGTHS))
-        {
-            QStringList wrappedCols;
-            for (const QString& col : dataPtr->getColumnNames())
-                wrappedCols << colLengthTpl.arg(wrapObjIfNeeded(col, db->getDialect()));
-
-            SqlQueryPtr colLengthQuery = db->exec(colLengthSql.arg(wrappedCols.join(", "), wrappedTable));
-            if (colLengthQuery->isError())
-            {
-                if (!errorMessage->isNull())
-                    *errorMessage = tr("Error while counting data column width to export from table %1: %2").arg(table, colLengthQuery->getErrorText());
-            }
-            else
-            {
-                QList<int> colWidths;
-                SqlResultsRowPtr row = colLengthQuery->next();
-                for (const QVariant& value : row->valueList())
-                    colWidths << value.toInt();
-
-                providerData[ExportManager::DATA_LENGTHS] = QVariant::fromValue(colWidths);
-            }
-        }
     }
 }
 
@@ -4,6 +4,7 @@
 #include "services/exportmanager.h"
 #include "db/queryexecutor.h"
 #include "parser/ast/sqlitecreatetable.h"
+#include "db/sqlspooledresults.h"
 #include <QObject>
 #include <QRunnable>
 #include <QMutex>
@@ -25,18 +26,25 @@ class API_EXPORT ExportWorker : public QObject, public QRunnable
     private:
         void prepareParser();
         bool exportQueryResults();
-        QHash<ExportManager::ExportProviderFlag, QVariant> getProviderDataForQueryResults();
+        bool needsProviderData() const;
+        QSharedPointer<SqlSpooledResults> spoolResults(SqlQueryPtr results);
+        QHash<ExportManager::ExportProviderFlag, QVariant> getProviderData(const SqlSpooledResults& results) const;
         bool exportDatabase();
         bool exportDatabaseObjects(const QList<ExportManager::ExportObjectPtr>& dbObjects, ExportManager::ExportObject::Type type);
         bool exportTable();
-        bool exportTableInternal(const QString& database, const QString& table, const QString& ddl, SqliteQueryPtr parsedDdl, SqlQueryPtr results,
-                                 const QHash<ExportManager::ExportProviderFlag, QVariant>& providerData);
+        bool exportTableInternal(const QString& database, const QString& table, const QString& ddl, SqliteQueryPtr parsedDdl, SqlQueryPtr results);
         QList<ExportManager::ExportObjectPtr> collectDbObjects(QString* errorMessage);
-        void queryTableDataToExport(Db* db, const QString& table, SqlQueryPtr& dataPtr, QHash<ExportManager::ExportProviderFlag, QVariant>& providerData,
-                                    QString* errorMessage) const;
+        void queryTableDataToExport(Db* db, const QString& table, SqlQueryPtr& dataPtr, QString* errorMessage) const;
         bool isInterrupted();
         void logExportFail(const QString& stageName);
 
+        /**
+         * @brief Number of data rows read and passed to the plugin at once.
+         *
+         * Interruption is checked once per block.
+         */
+        static const int rowBlockSize = 1000;
+
         ExportPlugin* plugin = nullptr;
         ExportManager::StandardExportConfig* config = nullptr;
         QIODevice* output = nullptr;
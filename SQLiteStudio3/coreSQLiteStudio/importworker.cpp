@@ -4,10 +4,13 @@
 #include "db/db.h"
 #include "plugins/importplugin.h"
 #include "common/utils.h"
+#include <QRegularExpression>
+#include <QtConcurrent/QtConcurrentRun>
 
 ImportWorker::ImportWorker(ImportPlugin* plugin, ImportManager::StandardImportConfig* config, Db* db, const QString& table, QObject *parent) :
     QObject(parent), plugin(plugin), config(config), db(db), table(table)
 {
+    readerThreadPool.setMaxThreadCount(1);
 }
 
 void ImportWorker::run()
@@ -25,30 +28,16 @@ void ImportWorker::run()
         return;
     }
 
-    if (!db->begin())
-    {
-        error(tr("Could not start transaction in order to import a data: %1").arg(db->getErrorText()));
-        return;
-    }
+    if (config->fastImport)
+        applyFastImportPragmas();
 
-    if (!prepareTable())
-    {
-        db->rollback();
-        return;
-    }
+    bool result = importInTransaction();
 
-    if (!importData())
-    {
-        db->rollback();
-        return;
-    }
+    if (config->fastImport)
+        restorePragmas();
 
-    if (!db->commit())
-    {
-        error(tr("Could not commit transaction for imported data: %1").arg(db->getErrorText()));
-        db->rollback();
+    if (!result)
         return;
-    }
 
     if (tableCreated)
         emit createdTable(db, table);
@@ -80,6 +69,47 @@ void ImportWorker::error(const QString& err)
     emit finished(false);
 }
 
+bool ImportWorker::importInTransaction()
+{
+    if (!db->begin())
+    {
+        error(tr("Could not start transaction in order to import a data: %1").arg(db->getErrorText()));
+        return false;
+    }
+
+    if (!prepareTable())
+    {
+        db->rollback();
+        return false;
+    }
+
+    if (config->deferIndexes && !tableCreated && !dropIndexesForImport())
+    {
+        db->rollback();
+        return false;
+    }
+
+    if (!importData())
+    {
+        db->rollback();
+        return false;
+    }
+
+    if (!recreateIndexes())
+    {
+        db->rollback();
+        return false;
+    }
+
+    if (!db->commit())
+    {
+        error(tr("Could not commit transaction for imported data: %1").arg(db->getErrorText()));
+        db->rollback();
+        return false;
+    }
+    return true;
+}
+
 bool ImportWorker::prepareTable()
 {
     QStringList finalColumns;
@@ -133,26 +163,134 @@ bool ImportWorker::prepareTable()
 
 bool ImportWorker::importData()
 {
-    static const QString insertTemplate = QStringLiteral("INSERT INTO %1 VALUES (%2)");
+    static const QString insertTemplate = QStringLiteral("INSERT INTO %1 VALUES %2");
 
     int colCount = targetColumns.size();
     QStringList valList;
     for (int i = 0; i < colCount; i++)
         valList << "?";
 
-    QString theInsert = insertTemplate.arg(wrapObjIfNeeded(table, db->getDialect()), valList.join(", "));
-    SqlQueryPtr query = db->prepare(theInsert);
+    QString rowPlaceholders = "(" + valList.join(", ") + ")";
+    QString wrappedTable = wrapObjIfNeeded(table, db->getDialect());
+
+    // SQLite 2 doesn't support multiple rows in VALUES clause
+    int rowsPerInsert = 1;
+    if (db->getDialect() == Dialect::Sqlite3)
+        rowsPerInsert = qBound(1, maxInsertArgs / qMax(colCount, 1), (int)maxRowsPerInsert);
+
+    QStringList multiRowPlaceholders;
+    for (int i = 0; i < rowsPerInsert; i++)
+        multiRowPlaceholders << rowPlaceholders;
+
+    SqlQueryPtr singleRowQuery = db->prepare(insertTemplate.arg(wrappedTable, rowPlaceholders));
+    SqlQueryPtr multiRowQuery = db->prepare(insertTemplate.arg(wrappedTable, multiRowPlaceholders.join(", ")));
+
+    // With ON CONFLICT FAIL a failed statement keeps rows it inserted before the faulty one,
+    // so each multi-row insert goes in a savepoint, to be undone entirely before inserting its rows one by one.
+    SqlQueryPtr savepointQuery = db->prepare(QStringLiteral("SAVEPOINT importRows"));
+    SqlQueryPtr releaseQuery = db->prepare(QStringLiteral("RELEASE importRows"));
+    SqlQueryPtr rollbackToQuery = db->prepare(QStringLiteral("ROLLBACK TO importRows"));
+
+    // Blocks are made of whole multi-row inserts, so only the last block may need single-row inserts
+    rowsPerBlock = rowsPerInsert * qMax(1, rowBlockSize / rowsPerInsert);
+    rowBlocks.clear();
+    readingFinished = false;
+    readingStopped = false;
+    inputPosition = -1;
+    readerWaitMsecs = 0;
+    writerWaitMsecs = 0;
+    importTimer.start();
+    throughputTimer.start();
+    QFuture<void> reader = QtConcurrent::run(&readerThreadPool, this, &ImportWorker::readRows);
 
+    QString errorMsg;
     int rowCnt = 0;
-    QList<QVariant> row;
-    while ((row = plugin->next()).size() > 0)
+    int insertedInBlock;
+    int rowsInInsert;
+    QList<QVariant> args;
+    RowBlock block;
+    while (takeRowBlock(block))
     {
-        // Fill up missing values in the line
-        for (int i = row.size(); i < colCount; i++)
-            row << QVariant(QVariant::String);
+        for (insertedInBlock = 0; insertedInBlock < block.size(); insertedInBlock += rowsInInsert)
+        {
+            rowsInInsert = qMin(rowsPerInsert, block.size() - insertedInBlock);
+            if (rowsInInsert < rowsPerInsert)
+            {
+                // Remaining rows of the last block go one by one, as they would require yet another query to be prepared
+                if (!insertRowsOneByOne(singleRowQuery, block, insertedInBlock, rowsInInsert, rowCnt, errorMsg))
+                    break;
+
+                continue;
+            }
+
+            args.clear();
+            for (int i = insertedInBlock, lgt = insertedInBlock + rowsInInsert; i < lgt; i++)
+                args += block[i];
+
+            if (!savepointQuery->execute())
+            {
+                errorMsg = savepointQuery->getErrorText();
+                break;
+            }
+
+            multiRowQuery->setArgs(args);
+            if (multiRowQuery->execute())
+            {
+                if (!releaseQuery->execute())
+                {
+                    errorMsg = releaseQuery->getErrorText();
+                    break;
+                }
+
+                rowCnt += rowsInInsert;
+                continue;
+            }
+
+            // Rows of the failed statement are undone, so they are inserted again one by one to find the faulty one
+            if (!rollbackToQuery->execute())
+            {
+                errorMsg = rollbackToQuery->getErrorText();
+                break;
+            }
+
+            if (!releaseQuery->execute())
+            {
+                errorMsg = releaseQuery->getErrorText();
+                break;
+            }
+
+            if (!insertRowsOneByOne(singleRowQuery, block, insertedInBlock, rowsInInsert, rowCnt, errorMsg))
+                break;
+        }
+
+        if (errorMsg.isNull() && isInterrupted())
+            errorMsg = tr("Interrupted.", "import process status update");
+
+        if (throughputTimer.elapsed() >= throughputReportInterval)
+            reportThroughput(rowCnt);
+
+        if (!errorMsg.isNull())
+            break;
+    }
+
+    // Plugin cannot be finalized while it's still being read
+    stopReadingRows();
+    reader.waitForFinished();
+
+    if (!errorMsg.isNull())
+    {
+        error(tr("Error while importing data: %1").arg(errorMsg));
+        return false;
+    }
+
+    return true;
+}
 
-        // Assign argument values
-        query->setArgs(row.mid(0, colCount));
+bool ImportWorker::insertRowsOneByOne(SqlQueryPtr query, const ImportWorker::RowBlock& block, int from, int count, int& rowCnt, QString& errorMsg)
+{
+    for (int i = from, lgt = from + count; i < lgt; i++)
+    {
+        query->setArgs(block[i]);
         if (!query->execute())
         {
             if (config->ignoreErrors)
@@ -165,19 +303,218 @@ bool ImportWorker::importData()
             }
             else
             {
-                error(tr("Error while importing data: %1").arg(query->getErrorText()));
+                errorMsg = query->getErrorText();
                 return false;
             }
         }
+        rowCnt++;
+    }
+    return true;
+}
+
+void ImportWorker::readRows()
+{
+    int colCount = targetColumns.size();
+    RowBlock block;
+    block.reserve(rowsPerBlock);
+
+    QList<QVariant> row;
+    while ((row = plugin->next()).size() > 0)
+    {
+        // Fill up missing values in the line
+        for (int i = row.size(); i < colCount; i++)
+            row << QVariant(QVariant::String);
+
+        if (row.size() > colCount)
+            row = row.mid(0, colCount);
+
+        block << row;
+        if (block.size() < rowsPerBlock)
+            continue;
+
+        if (!putRowBlock(block))
+            return;
+
+        reportProgress();
+        block.clear();
+        block.reserve(rowsPerBlock);
+    }
+
+    if (!block.isEmpty() && !putRowBlock(block))
+        return;
+
+    reportProgress();
+
+    QMutexLocker locker(&rowBlocksMutex);
+    readingFinished = true;
+    rowBlockAvailable.wakeAll();
+}
+
+void ImportWorker::reportProgress()
+{
+    qint64 totalBytes = plugin->getInputSize();
+    qint64 bytesRead = plugin->getInputPosition();
+    if (totalBytes <= 0 || bytesRead < 0)
+        return;
+
+    // Progress is reported with every permille, not to flood the UI with updates
+    rowBlocksMutex.lock();
+    inputPosition = bytesRead;
+    rowBlocksMutex.unlock();
+
+    int permille = static_cast<int>(qMin(bytesRead, totalBytes) * 1000 / totalBytes);
+    if (permille == lastProgress)
+        return;
+
+    lastProgress = permille;
+    emit progress(bytesRead, totalBytes);
+}
+
+void ImportWorker::reportThroughput(int rowCnt)
+{
+    throughputTimer.restart();
+
+    rowBlocksMutex.lock();
+    qint64 bytesRead = inputPosition;
+    qint64 readingMsecs = qMax(importTimer.elapsed() - readerWaitMsecs, qint64(1));
+    qint64 insertingMsecs = qMax(importTimer.elapsed() - writerWaitMsecs, qint64(1));
+    rowBlocksMutex.unlock();
+
+    double bytesPerSecond = (bytesRead < 0) ? -1.0 : (bytesRead * 1000.0 / readingMsecs);
+    emit throughput(bytesPerSecond, rowCnt * 1000.0 / insertingMsecs);
+}
+
+bool ImportWorker::putRowBlock(const ImportWorker::RowBlock& block)
+{
+    QMutexLocker locker(&rowBlocksMutex);
+    QElapsedTimer waitTimer;
+    waitTimer.start();
+    while (rowBlocks.size() >= maxQueuedRowBlocks && !readingStopped)
+        rowBlockSpaceAvailable.wait(&rowBlocksMutex);
+
+    readerWaitMsecs += waitTimer.elapsed();
+
+    if (readingStopped)
+        return false;
+
+    rowBlocks.enqueue(block);
+    rowBlockAvailable.wakeAll();
+    return true;
+}
+
+bool ImportWorker::takeRowBlock(ImportWorker::RowBlock& block)
+{
+    QMutexLocker locker(&rowBlocksMutex);
+    QElapsedTimer waitTimer;
+    waitTimer.start();
+    while (rowBlocks.isEmpty() && !readingFinished)
+        rowBlockAvailable.wait(&rowBlocksMutex);
 
-        if ((rowCnt % 100) == 0 && isInterrupted())
+    writerWaitMsecs += waitTimer.elapsed();
+
+    if (rowBlocks.isEmpty())
+        return false;
+
+    block = rowBlocks.dequeue();
+    rowBlockSpaceAvailable.wakeAll();
+    return true;
+}
+
+void ImportWorker::stopReadingRows()
+{
+    QMutexLocker locker(&rowBlocksMutex);
+    readingStopped = true;
+    rowBlocks.clear();
+    rowBlockSpaceAvailable.wakeAll();
+}
+
+void ImportWorker::applyFastImportPragmas()
+{
+    if (db->getDialect() != Dialect::Sqlite3)
+        return;
+
+    originalJournalMode = db->exec("PRAGMA journal_mode")->getSingleCell().toString();
+    originalSynchronous = db->exec("PRAGMA synchronous")->getSingleCell().toString();
+
+    // Journal is kept in memory, not turned off, so the import can still be rolled back. WAL mode is persistent, so it's left untouched.
+    if (!originalJournalMode.isEmpty() && originalJournalMode.toLower() != "wal")
+        db->exec("PRAGMA journal_mode = MEMORY");
+    else
+        originalJournalMode.clear();
+
+    if (!originalSynchronous.isEmpty())
+        db->exec("PRAGMA synchronous = OFF");
+}
+
+void ImportWorker::restorePragmas()
+{
+    SqlQueryPtr result;
+    if (!originalJournalMode.isEmpty())
+    {
+        result = db->exec(QString("PRAGMA journal_mode = %1").arg(originalJournalMode));
+        if (result->isError())
+            qWarning() << "Could not restore journal_mode after import:" << result->getErrorText();
+    }
+
+    if (!originalSynchronous.isEmpty())
+    {
+        result = db->exec(QString("PRAGMA synchronous = %1").arg(originalSynchronous));
+        if (result->isError())
+            qWarning() << "Could not restore synchronous mode after import:" << result->getErrorText();
+    }
+}
+
+bool ImportWorker::dropIndexesForImport()
+{
+    static const QString indexesSql = QStringLiteral("SELECT name, sql FROM sqlite_master WHERE type = 'index' AND lower(tbl_name) = lower(?) AND sql IS NOT NULL");
+    static const QString dropSql = QStringLiteral("DROP INDEX %1");
+    static const QRegularExpression uniqueIndexRe("^\\s*CREATE\\s+UNIQUE\\s", QRegularExpression::CaseInsensitiveOption);
+
+    SqlQueryPtr results = db->exec(indexesSql, {table});
+    if (results->isError())
+    {
+        error(tr("Could not read indexes of table '%1': %2").arg(table, results->getErrorText()));
+        return false;
+    }
+
+    // Unique indexes stay in place, so constraint violations are still reported for each row
+    SqlResultsRowPtr row;
+    QString ddl;
+    while (results->hasNext())
+    {
+        row = results->next();
+        ddl = row->value("sql").toString();
+        if (uniqueIndexRe.match(ddl).hasMatch())
+            continue;
+
+        deferredIndexes << QPair<QString,QString>(row->value("name").toString(), ddl);
+    }
+
+    Dialect dialect = db->getDialect();
+    for (const QPair<QString,QString>& index : deferredIndexes)
+    {
+        results = db->exec(dropSql.arg(wrapObjIfNeeded(index.first, dialect)));
+        if (results->isError())
         {
-            error(tr("Error while importing data: %1").arg(tr("Interrupted.", "import process status update")));
+            error(tr("Could not drop index '%1' for the time of import: %2").arg(index.first, results->getErrorText()));
             return false;
         }
-        rowCnt++;
     }
+    return true;
+}
 
+bool ImportWorker::recreateIndexes()
+{
+    SqlQueryPtr result;
+    for (const QPair<QString,QString>& index : deferredIndexes)
+    {
+        result = db->exec(index.second);
+        if (result->isError())
+        {
+            error(tr("Could not create index '%1' after importing data: %2").arg(index.first, result->getErrorText()));
+            return false;
+        }
+    }
     return true;
 }
 
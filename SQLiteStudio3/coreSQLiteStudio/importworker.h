@@ -5,6 +5,10 @@
 #include <QObject>
 #include <QRunnable>
 #include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QThreadPool>
+#include <QElapsedTimer>
 
 class ImportWorker : public QObject, public QRunnable
 {
@@ -15,11 +19,31 @@ class ImportWorker : public QObject, public QRunnable
         void run();
 
     private:
+        typedef QList<QList<QVariant>> RowBlock;
+
         void readPluginColumns();
         void error(const QString& err);
+        bool importInTransaction();
         bool prepareTable();
         bool importData();
+        bool insertRowsOneByOne(SqlQueryPtr query, const RowBlock& block, int from, int count, int& rowCnt, QString& errorMsg);
         bool isInterrupted();
+        void applyFastImportPragmas();
+        void restorePragmas();
+        bool dropIndexesForImport();
+        bool recreateIndexes();
+
+        /**
+         * @brief Reads rows from the plugin into row blocks queue.
+         *
+         * It's executed in a separate thread, so the input is parsed while previous rows are inserted into the database.
+         */
+        void readRows();
+        void reportProgress();
+        void reportThroughput(int rowCnt);
+        bool putRowBlock(const RowBlock& block);
+        bool takeRowBlock(RowBlock& block);
+        void stopReadingRows();
 
         ImportPlugin* plugin = nullptr;
         ImportManager::StandardImportConfig* config = nullptr;
@@ -32,6 +56,43 @@ class ImportWorker : public QObject, public QRunnable
         bool interrupted = false;
         QMutex interruptMutex;
         bool tableCreated = false;
+        QString originalJournalMode;
+        QString originalSynchronous;
+        QList<QPair<QString,QString>> deferredIndexes;
+
+        /**
+         * @brief Thread pool for reading rows.
+         *
+         * The worker itself runs in the global pool, so reading in the same pool could wait for a free thread forever.
+         */
+        QThreadPool readerThreadPool;
+        QMutex rowBlocksMutex;
+        QWaitCondition rowBlockAvailable;
+        QWaitCondition rowBlockSpaceAvailable;
+        QQueue<RowBlock> rowBlocks;
+        bool readingFinished = false;
+        bool readingStopped = false;
+        int rowsPerBlock = rowBlockSize;
+        int lastProgress = -1;
+
+        /**
+         * @brief Input position reported by the plugin in the reader thread. Guarded by rowBlocksMutex, just like the wait times.
+         */
+        qint64 inputPosition = -1;
+        qint64 readerWaitMsecs = 0;
+        qint64 writerWaitMsecs = 0;
+        QElapsedTimer importTimer;
+        QElapsedTimer throughputTimer;
+
+        static const int rowBlockSize = 1000;
+        static const int maxQueuedRowBlocks = 8;
+
+        /**
+         * @brief Maximum number of arguments in a single query, as older SQLite versions allow up to 999 arguments.
+         */
+        static const int maxInsertArgs = 999;
+        static const int maxRowsPerInsert = 500;
+        static const int throughputReportInterval = 1000;
 
     public slots:
         void interrupt();
@@ -39,6 +100,16 @@ class ImportWorker : public QObject, public QRunnable
     signals:
         void createdTable(Db* db, const QString& table);
         void finished(bool result);
+        void progress(qint64 bytesRead, qint64 totalBytes);
+
+        /**
+         * @brief Reports throughput of import stages.
+         * @param bytesPerSecond Bytes of input read and parsed per second, or -1 if the plugin doesn't report its input position.
+         * @param rowsPerSecond Rows inserted into the table per second.
+         *
+         * Time spent by a stage on waiting for the other one is not counted, so the slower rate points to the stage limiting the import.
+         */
+        void throughput(double bytesPerSecond, double rowsPerSecond);
 };
 
 #endif // IMPORTWORKER_H
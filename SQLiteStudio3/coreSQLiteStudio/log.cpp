@@ -54,6 +54,18 @@ void logSql(Db* db, const QString& str, const QList<QVariant>& args, Db::Flags f
         qDebug() << "    SQL arg>" << i++ << "=" << arg;
 }
 
+void logSqlBusyWait(Db* db, int retries, qint64 msecs, bool timedOut)
+{
+    if (!SQL_DEBUG)
+        return;
+
+    if (!SQL_DEBUG_FILTER.isEmpty() && SQL_DEBUG_FILTER != db->getName())
+        return;
+
+    qDebug() << QString("SQL %1> database busy, waited %2 ms (%3 retries)%4").arg(db->getName()).arg(msecs).arg(retries)
+                .arg(timedOut ? ", timed out" : "");
+}
+
 void setExecutorLoggingEnabled(bool enabled)
 {
     EXECUTOR_DEBUG = enabled;
@@ -75,3 +87,20 @@ void logExecutorAfterStep(const QString& str)
 
     qDebug() << getLogDateTime() << str;
 }
+
+void logExecutorStepTime(QueryExecutorStep* step, qint64 nsecs)
+{
+    if (!EXECUTOR_DEBUG)
+        return;
+
+    qDebug() << getLogDateTime() << "Step" << step->metaObject()->className() << step->objectName()
+             << QString("took %1 ms").arg(nsecs / 1000000.0, 0, 'f', 3);
+}
+
+void logExecutorChainTime(int steps, qint64 nsecs)
+{
+    if (!EXECUTOR_DEBUG)
+        return;
+
+    qDebug() << getLogDateTime() << QString("Executor chain of %1 steps took %2 ms").arg(steps).arg(nsecs / 1000000.0, 0, 'f', 3);
+}
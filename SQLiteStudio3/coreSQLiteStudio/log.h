@@ -13,8 +13,11 @@ class QueryExecutorStep;
 API_EXPORT QString getLogDateTime();
 API_EXPORT void logSql(Db* db, const QString& str, const QHash<QString,QVariant>& args, Db::Flags flags);
 API_EXPORT void logSql(Db* db, const QString& str, const QList<QVariant>& args, Db::Flags flags);
+API_EXPORT void logSqlBusyWait(Db* db, int retries, qint64 msecs, bool timedOut);
 API_EXPORT void logExecutorStep(QueryExecutorStep* step);
 API_EXPORT void logExecutorAfterStep(const QString& str);
+API_EXPORT void logExecutorStepTime(QueryExecutorStep* step, qint64 nsecs);
+API_EXPORT void logExecutorChainTime(int steps, qint64 nsecs);
 API_EXPORT void setSqlLoggingEnabled(bool enabled);
 API_EXPORT void setSqlLoggingFilter(const QString& filter);
 API_EXPORT void setExecutorLoggingEnabled(bool enabled);
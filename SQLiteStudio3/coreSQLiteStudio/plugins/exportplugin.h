@@ -190,6 +190,17 @@ class ExportPlugin : virtual public Plugin
          */
         virtual bool exportQueryResultsRow(SqlResultsRowPtr row) = 0;
 
+        /**
+         * @brief Does export entries for a block of data rows.
+         * @param rows Consecutive data rows.
+         * @return true for success, or false in case of a fatal error.
+         *
+         * Query results are read in blocks and each block is passed to this method, instead of calling
+         * exportQueryResultsRow() for each row. Implementation can do per-block work once
+         * (like writing all rows to the output at once). Usually it's enough to call exportQueryResultsRow() for each row.
+         */
+        virtual bool exportQueryResultsRows(const SqlResultsRowBlock& rows) = 0;
+
         /**
          * @brief Does final entry for exported query results.
          * @return true for success, or false in case of a fatal error.
@@ -242,6 +253,18 @@ class ExportPlugin : virtual public Plugin
          */
         virtual bool exportTableRow(SqlResultsRowPtr data) = 0;
 
+        /**
+         * @brief Does export entries for a block of table data rows.
+         * @param rows Consecutive data rows.
+         * @return true for success, or false in case of a fatal error.
+         *
+         * Table data is read in blocks and each block is passed to this method, instead of calling
+         * exportTableRow() for each row. Usually it's enough to call exportTableRow() for each row.
+         *
+         * This method will be called only if StandardExportConfig::exportData in initBeforeExport() was true.
+         */
+        virtual bool exportTableRows(const SqlResultsRowBlock& rows) = 0;
+
         /**
          * @brief Does final entry for exported table, after its data was exported.
          * @return true for success, or false in case of a fatal error.
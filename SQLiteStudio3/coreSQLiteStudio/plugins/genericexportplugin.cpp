@@ -70,11 +70,31 @@ void GenericExportPlugin::setExportMode(ExportManager::ExportMode mode)
     this->exportMode = mode;
 }
 
+bool GenericExportPlugin::exportQueryResultsRows(const SqlResultsRowBlock& rows)
+{
+    for (const SqlResultsRowPtr& row : rows)
+    {
+        if (!exportQueryResultsRow(row))
+            return false;
+    }
+    return true;
+}
+
 bool GenericExportPlugin::afterExportQueryResults()
 {
     return true;
 }
 
+bool GenericExportPlugin::exportTableRows(const SqlResultsRowBlock& rows)
+{
+    for (const SqlResultsRowPtr& row : rows)
+    {
+        if (!exportTableRow(row))
+            return false;
+    }
+    return true;
+}
+
 bool GenericExportPlugin::afterExportTable()
 {
     return true;
@@ -19,7 +19,9 @@ class API_EXPORT GenericExportPlugin : virtual public GenericPlugin, public Expo
         QString getDefaultEncoding() const;
         bool isBinaryData() const;
         void setExportMode(ExportManager::ExportMode exportMode);
+        bool exportQueryResultsRows(const SqlResultsRowBlock& rows);
         bool afterExportQueryResults();
+        bool exportTableRows(const SqlResultsRowBlock& rows);
         bool afterExportTable();
         bool beforeExportTables();
         bool afterExportTables();
@@ -90,6 +90,24 @@ class ImportPlugin : virtual public Plugin
          */
         virtual QList<QVariant> next() = 0;
 
+        /**
+         * @brief Provides size of the data source.
+         * @return Size of the input in bytes, or -1 if it's not known.
+         *
+         * Together with getInputPosition() it's used to report progress of the import.
+         * Default implementation returns -1, so plugins not reporting their input size don't need to implement it.
+         */
+        virtual qint64 getInputSize() const {return -1;}
+
+        /**
+         * @brief Provides amount of the data source read so far.
+         * @return Number of input bytes read, or -1 if it's not known.
+         *
+         * This method is called from the same thread as next(), right after it.
+         * Default implementation returns -1.
+         */
+        virtual qint64 getInputPosition() const {return -1;}
+
         /**
          * @brief Provides config object that holds configuration for importing.
          * @return Config object, or null if the importing with this plugin is not configurable.
@@ -1118,6 +1118,19 @@ void SchemaResolver::setNoDbLocking(bool value)
         dbFlags ^= Db::Flag::NO_LOCK;
 }
 
+bool SchemaResolver::getUseReader() const
+{
+    return dbFlags.testFlag(Db::Flag::USE_READER);
+}
+
+void SchemaResolver::setUseReader(bool value)
+{
+    if (value)
+        dbFlags |= Db::Flag::USE_READER;
+    else if (dbFlags.testFlag(Db::Flag::USE_READER))
+        dbFlags ^= Db::Flag::USE_READER;
+}
+
 
 SchemaResolver::ObjectCacheKey::ObjectCacheKey(Type type, Db* db, const QString& value1, const QString& value2, const QString& value3) :
     type(type), db(db), value1(value1), value2(value2), value3(value3)
@@ -186,6 +186,20 @@ class API_EXPORT SchemaResolver
         bool getNoDbLocking() const;
         void setNoDbLocking(bool value);
 
+        /**
+         * @brief Tells whether schema queries may be executed on a reader connection.
+         * @see setUseReader()
+         */
+        bool getUseReader() const;
+
+        /**
+         * @brief Allows schema queries to be executed on a reader connection (see Db::Flag::USE_READER).
+         * @param value true to allow reader connection.
+         *
+         * Use it when resolving schema in background, so it doesn't wait for queries executed by the user.
+         */
+        void setUseReader(bool value);
+
         static QString objectTypeToString(ObjectType type);
         static ObjectType stringToObjectType(const QString& type);
         static void staticInit();
@@ -82,7 +82,6 @@ class API_EXPORT ExportManager : public PluginServiceBase
             QString name;
             QString ddl;
             SqlQueryPtr data;
-            QHash<ExportManager::ExportProviderFlag,QVariant> providerData;
         };
 
         typedef QSharedPointer<ExportObject> ExportObjectPtr;
@@ -12,9 +12,12 @@
 #include <QVariantList>
 #include <QHash>
 #include <QDebug>
-#include <QRegularExpression>
 #include <QFile>
 #include <QUrl>
+#include <QMutexLocker>
+
+QCache<QString,QRegularExpression> FunctionManagerImpl::regExpCache(FunctionManagerImpl::regExpCacheSize);
+QMutex FunctionManagerImpl::regExpCacheMutex;
 
 FunctionManagerImpl::FunctionManagerImpl()
 {
@@ -358,7 +361,7 @@ QVariant FunctionManagerImpl::nativeRegExp(const QList<QVariant>& args, Db* db,
         return QVariant();
     }
 
-    QRegularExpression re(args[0].toString());
+    QRegularExpression re = getCompiledRegExp(args[0].toString());
     if (!re.isValid())
     {
         ok = false;
@@ -369,6 +372,21 @@ QVariant FunctionManagerImpl::nativeRegExp(const QList<QVariant>& args, Db* db,
     return match.hasMatch();
 }
 
+QRegularExpression FunctionManagerImpl::getCompiledRegExp(const QString& pattern)
+{
+    QMutexLocker lock(&regExpCacheMutex);
+    QRegularExpression* re = regExpCache.object(pattern);
+    if (re)
+        return *re;
+
+    re = new QRegularExpression(pattern);
+    if (re->isValid())
+        re->optimize();
+
+    regExpCache.insert(pattern, re);
+    return *re;
+}
+
 QVariant FunctionManagerImpl::nativeSqlFile(const QList<QVariant>& args, Db* db, bool& ok)
 {
     if (args.size() != 1)
@@ -3,6 +3,9 @@
 
 #include "services/functionmanager.h"
 #include <QCryptographicHash>
+#include <QRegularExpression>
+#include <QCache>
+#include <QMutex>
 
 class SqlFunctionPlugin;
 class Plugin;
@@ -58,6 +61,17 @@ class API_EXPORT FunctionManagerImpl : public FunctionManager
         void registerNativeFunction(const QString& name, const QStringList& args, NativeFunction::ImplementationFunction funcPtr);
 
         static QStringList getArgMarkers(int argCount);
+
+        /**
+         * @brief Provides compiled regular expression for given pattern.
+         * @param pattern Regular expression pattern.
+         * @return Compiled (and optimized) expression. It may be invalid, if the pattern is invalid.
+         *
+         * The regexp() function is evaluated for every row with usually the same pattern,
+         * so compiled expressions are kept in a cache of recently used patterns.
+         */
+        static QRegularExpression getCompiledRegExp(const QString& pattern);
+
         static QVariant nativeRegExp(const QList<QVariant>& args, Db* db, bool& ok);
         static QVariant nativeSqlFile(const QList<QVariant>& args, Db* db, bool& ok);
         static QVariant nativeReadFile(const QList<QVariant>& args, Db* db, bool& ok);
@@ -88,6 +102,15 @@ class API_EXPORT FunctionManagerImpl : public FunctionManager
         QHash<Key,ScriptFunction*> functionsByKey;
         QList<NativeFunction*> nativeFunctions;
         QHash<Key,NativeFunction*> nativeFunctionsByKey;
+
+        /**
+         * @brief Recently used regular expressions, keyed by pattern.
+         *
+         * Functions are evaluated by threads executing queries, so access to the cache is guarded by the regExpCacheMutex.
+         */
+        static QCache<QString,QRegularExpression> regExpCache;
+        static QMutex regExpCacheMutex;
+        static const int regExpCacheSize = 50;
 };
 
 int qHash(const FunctionManagerImpl::Key& key);
@@ -69,6 +69,8 @@ void ImportManager::importToTable(Db* db, const QString& table)
     ImportWorker* worker = new ImportWorker(plugin, &importConfig, db, table);
     connect(worker, SIGNAL(finished(bool)), this, SLOT(finalizeImport(bool)));
     connect(worker, SIGNAL(createdTable(Db*,QString)), this, SLOT(handleTableCreated(Db*,QString)));
+    connect(worker, SIGNAL(progress(qint64,qint64)), this, SIGNAL(importProgress(qint64,qint64)));
+    connect(worker, SIGNAL(throughput(double,double)), this, SIGNAL(importThroughput(double,double)));
     connect(this, SIGNAL(orderWorkerToInterrupt()), worker, SLOT(interrupt()));
 
     QThreadPool::globalInstance()->start(worker);
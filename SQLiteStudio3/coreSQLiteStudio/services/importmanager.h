@@ -38,6 +38,22 @@ class API_EXPORT ImportManager : public PluginServiceBase
             QString inputFileName;
 
             bool ignoreErrors = false;
+
+            /**
+             * @brief Relaxes durability of the database for the time of import.
+             *
+             * Sets journal_mode=MEMORY (unless the database is in WAL mode) and synchronous=OFF for the time of import.
+             * Import is much faster, but if the application or the system crashes during the import, the database may get corrupted.
+             */
+            bool fastImport = false;
+
+            /**
+             * @brief Drops indexes of the table before importing and creates them again once data is imported.
+             *
+             * Creating index once for all rows is faster than updating it with every row inserted.
+             * Unique indexes are not dropped, so constraint violations are still detected for each row.
+             */
+            bool deferIndexes = false;
         };
 
         enum StandardConfigFlag
@@ -76,6 +92,8 @@ class API_EXPORT ImportManager : public PluginServiceBase
         void importFinished();
         void importSuccessful();
         void importFailed();
+        void importProgress(qint64 bytesRead, qint64 totalBytes);
+        void importThroughput(double bytesPerSecond, double rowsPerSecond);
         void orderWorkerToInterrupt();
         void schemaModified(Db* db);
 };
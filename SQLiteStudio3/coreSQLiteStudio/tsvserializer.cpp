@@ -75,6 +75,11 @@ QList<QStringList> TsvSerializer::deserialize(const QString& data)
     return rows;
 }
 
+QString TsvSerializer::getRowSeparator()
+{
+    return rowSeparator;
+}
+
 QStringList TsvSerializer::tokenizeStrWithRowSeparator(const QString& data)
 {
     QStringList tokens;
@@ -11,6 +11,7 @@ class API_EXPORT TsvSerializer
         static QString serialize(const QList<QStringList>& data);
         static QString serialize(const QStringList& data);
         static QList<QStringList> deserialize(const QString& data);
+        static QString getRowSeparator();
 
     private:
         static QStringList tokenizeStrWithRowSeparator(const QString& data);
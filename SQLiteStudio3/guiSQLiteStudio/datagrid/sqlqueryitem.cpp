@@ -139,45 +139,17 @@ void SqlQueryItem::setValue(const QVariant &value, bool limited, bool loadedFrom
     // Value for display (in a cell) will always be limited, for performance reasons
     setValueForDisplay("x"); // the same trick as with the DataRole::VALUE
     if (!limited)
-    {
-        int theLimit = SqlQueryModel::getCellDataLengthLimit();
-        switch (value.type())
-        {
-            case QVariant::ByteArray:
-            {
-                QByteArray newBytes = newValue.toByteArray();
-                if (newBytes.size() > theLimit)
-                {
-                    newBytes.resize(theLimit);
-                    setValueForDisplay(newBytes);
-                }
-                else
-                    setValueForDisplay(newValue);
-
-                break;
-            }
-            case QVariant::String:
-            {
-                QString newString = newValue.toString();
-                if (newString.size() > theLimit)
-                {
-                    newString.resize(theLimit);
-                    setValueForDisplay(newString);
-                }
-                else
-                    setValueForDisplay(newValue);
-
-                break;
-            }
-            default:
-                setValueForDisplay(newValue);
-        }
-    }
+        setValueForDisplay(limitValueForDisplay(newValue));
     else
         setValueForDisplay(newValue);
 
-    if (modified && getModel())
-        getModel()->itemValueEdited(this);
+    SqlQueryModel* model = getModel();
+    if (!model)
+        return;
+
+    model->itemValueChanged(this);
+    if (modified)
+        model->itemValueEdited(this);
 }
 
 bool SqlQueryItem::isLimitedValue() const
@@ -233,7 +205,46 @@ QVariant SqlQueryItem::adjustVariantType(const QVariant& value)
     return value;
 }
 
+QVariant SqlQueryItem::limitValueForDisplay(const QVariant& value)
+{
+    int theLimit = SqlQueryModel::getCellDataLengthLimit();
+    switch (value.type())
+    {
+        case QVariant::ByteArray:
+        {
+            QByteArray bytes = value.toByteArray();
+            if (bytes.size() > theLimit)
+            {
+                bytes.resize(theLimit);
+                return bytes;
+            }
+            break;
+        }
+        case QVariant::String:
+        {
+            QString string = value.toString();
+            if (string.size() > theLimit)
+            {
+                string.resize(theLimit);
+                return string;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return value;
+}
+
 QString SqlQueryItem::getToolTip() const
+{
+    if (!index().isValid())
+        return QString::null;
+
+    return getToolTip(getColumn(), getRowId());
+}
+
+QString SqlQueryItem::getToolTip(SqlQueryModelColumn* col, const RowId& rowId)
 {
     static const QString tableTmp = "<table>%1</table>";
     static const QString rowTmp = "<tr><td colspan=2 style=\"white-space: pre\">%1</td><td style=\"align: right\"><b>%2</b></td></tr>";
@@ -241,10 +252,6 @@ QString SqlQueryItem::getToolTip() const
     static const QString constrRowTmp = "<tr><td width=16><img src=\"%1\"/></td><td style=\"white-space: pre\"><b>%2</b></td><td>%3</td></tr>";
     static const QString emptyRow = "<tr><td colspan=3></td></tr>";
 
-    if (!index().isValid())
-        return QString::null;
-
-    SqlQueryModelColumn* col = getColumn();
     if (!col)
         return QString::null; // happens when simple execution method was performed
 
@@ -255,7 +262,6 @@ QString SqlQueryItem::getToolTip() const
     {
         rows << rowTmp.arg(tr("Table:", "data view tooltip")).arg(col->table);
 
-        RowId rowId = getRowId();
         QString rowIdStr;
         if (rowId.size() == 1)
         {
@@ -326,6 +332,11 @@ void SqlQueryItem::setData(const QVariant &value, int role)
     QStandardItem::setData(value, role);
 }
 
+void SqlQueryItem::copyDataFrom(const SqlQueryItem& item)
+{
+    QStandardItem::operator=(item);
+}
+
 QVariant SqlQueryItem::data(int role) const
 {
     switch (role)
@@ -450,9 +461,5 @@ QVariant SqlQueryItem::getFullValue()
     if (!isLimitedValue())
         return getValue();
 
-    QVariant originalValue = getValue();
-    loadFullData();
-    QVariant result = getValue();
-    setValue(originalValue, true, !isUncommitted());
-    return result;
+    return getModel()->loadFullValues({this}).value(this);
 }
@@ -74,8 +74,8 @@ class GUI_API_EXPORT SqlQueryItem : public QObject, public QStandardItem
         /**
          * @brief getFullValue Loads and returns full value from database, but keeps the original value.
          * @return Full value, reloaded from database.
-         * Calls loadFullData(), then getValue() for the result,
-         * but just before returning - restores initial, limited value.
+         * Uses SqlQueryModel::loadFullValues(), so the value of the cell is not modified.
+         * To get full values of many cells, use SqlQueryModel::loadFullValues() directly.
          */
         QVariant getFullValue();
 
@@ -87,9 +87,39 @@ class GUI_API_EXPORT SqlQueryItem : public QObject, public QStandardItem
         void setData(const QVariant& value, int role = Qt::UserRole + 1);
         QVariant data(int role = Qt::UserRole + 1) const;
 
+        /**
+         * @brief Copies all data of other item into this item.
+         * @param item Item to copy data from.
+         *
+         * Unlike setting data role by role, this doesn't notify the model about the change.
+         * It's meant for items created on demand for cells, which the model already presented with the same data.
+         */
+        void copyDataFrom(const SqlQueryItem& item);
+
+        /**
+         * @brief Converts value to integer or real number, if it's represented the same way as a number.
+         * @param value Value to convert.
+         * @return Converted value, or the original value if it's not a number.
+         */
+        static QVariant adjustVariantType(const QVariant& value);
+
+        /**
+         * @brief Cuts value to the cell data length limit.
+         * @param value Value to cut.
+         * @return Value to display in the cell.
+         */
+        static QVariant limitValueForDisplay(const QVariant& value);
+
+        /**
+         * @brief Builds tooltip for the cell.
+         * @param col Column of the cell.
+         * @param rowId ROWID of the cell.
+         * @return Tooltip contents, or null string if there's no column.
+         */
+        static QString getToolTip(SqlQueryModelColumn* col, const RowId& rowId);
+
     private:
         void setLimitedValue(bool limited);
-        QVariant adjustVariantType(const QVariant& value);
         QString getToolTip() const;
 };
 
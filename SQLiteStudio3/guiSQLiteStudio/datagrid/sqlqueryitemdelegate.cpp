@@ -29,11 +29,12 @@ SqlQueryItemDelegate::SqlQueryItemDelegate(QObject *parent) :
 void SqlQueryItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
 {
     QStyledItemDelegate::paint(painter, option, index);
-    SqlQueryItem* item = getItem(index);
 
-    if (item->isUncommitted())
+    // Using data roles, so painting doesn't create items for cells that don't have them yet
+    if (index.data(SqlQueryItem::DataRole::UNCOMMITTED).toBool())
     {
-        painter->setPen(item->isCommittingError() ? CFG_UI.Colors.DataUncommittedError.get() : CFG_UI.Colors.DataUncommitted.get());
+        bool committingError = index.data(SqlQueryItem::DataRole::COMMITTING_ERROR).toBool();
+        painter->setPen(committingError ? CFG_UI.Colors.DataUncommittedError.get() : CFG_UI.Colors.DataUncommitted.get());
         painter->setBrush(Qt::NoBrush);
         painter->drawRect(option.rect.x(), option.rect.y(), option.rect.width()-1, option.rect.height()-1);
     }
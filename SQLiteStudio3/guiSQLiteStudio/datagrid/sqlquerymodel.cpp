@@ -21,8 +21,9 @@
 #include <QtMath>
 #include <QMessageBox>
 #include <QThread>
-
-QSet<SqlQueryModel*> SqlQueryModel::existingModels;
+#include <QTimer>
+#include <QDataStream>
+#include <QtConcurrent/QtConcurrentRun>
 
 SqlQueryModel::SqlQueryModel(QObject *parent) :
     QStandardItemModel(parent)
@@ -32,18 +33,37 @@ SqlQueryModel::SqlQueryModel(QObject *parent) :
     connect(queryExecutor, SIGNAL(executionFinished(SqlQueryPtr)), this, SLOT(handleExecFinished(SqlQueryPtr)));
     connect(queryExecutor, SIGNAL(executionFailed(int,QString)), this, SLOT(handleExecFailed(int,QString)));
     connect(queryExecutor, SIGNAL(resultsCountingFinished(quint64,quint64,int)), this, SLOT(resultsCountingFinished(quint64,quint64,int)));
+    connect(this, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(handleRowsInserted(QModelIndex,int,int)));
+    connect(this, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)), this, SLOT(handleRowsAboutToBeRemoved(QModelIndex,int,int)));
+    connect(this, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(handleRowsRemoved(QModelIndex,int,int)));
+    connect(this, SIGNAL(modelReset()), this, SLOT(handleModelReset()));
+
+    searchIndexWatcher = new QFutureWatcher<SqlQueryModelSearchIndexPtr>(this);
+    connect(searchIndexWatcher, SIGNAL(finished()), this, SLOT(handleSearchIndexBuilt()));
+
+    rowSortWatcher = new QFutureWatcher<SqlResultsRowBlock>(this);
+    connect(rowSortWatcher, SIGNAL(finished()), this, SLOT(handleLoadedRowsSorted()));
+
+    commitWatcher = new QFutureWatcher<bool>(this);
+    connect(commitWatcher, SIGNAL(finished()), this, SLOT(handleCommitFinished()));
 
     NotifyManager* notifyManager = NotifyManager::getInstance();
     connect(notifyManager, SIGNAL(objectModified(Db*,QString,QString)), this, SLOT(handlePossibleTableModification(Db*,QString,QString)));
     connect(notifyManager, SIGNAL(objectRenamed(Db*,QString,QString,QString)), this, SLOT(handlePossibleTableRename(Db*,QString,QString,QString)));
 
     setItemPrototype(new SqlQueryItem());
-    existingModels << this;
 }
 
 SqlQueryModel::~SqlQueryModel()
 {
-    existingModels.remove(this);
+    if (committing)
+    {
+        // Transaction is rolled back by the worker. Items are going away anyway, so there's nothing to update.
+        commitWorker->interrupt();
+        commitWatcher->waitForFinished();
+        safe_delete(commitWorker);
+        detachDependencyTables();
+    }
 
     delete queryExecutor;
     queryExecutor = nullptr;
@@ -76,8 +96,15 @@ void SqlQueryModel::executeQuery()
         return;
     }
 
+    if (committing)
+    {
+        notifyWarn(tr("Cannot execute the query while the data is being committed."));
+        return;
+    }
+
     sortOrder.clear();
     queryExecutor->setSkipRowCounting(false);
+    queryExecutor->setCountingMode(getCountingMode());
     queryExecutor->setSortOrder(sortOrder);
     queryExecutor->setPage(0);
     queryExecutor->setForceSimpleMode(simpleExecutionMode);
@@ -102,24 +129,28 @@ void SqlQueryModel::executeQueryInternal()
         return;
     }
 
-    QList<SqlQueryItem*> uncommittedItems = getUncommittedItems();
-    if (uncommittedItems.size() > 0)
+    // Rows fetched while scrolling are added to rows already loaded, so no changes are lost and the view stays usable
+    if (windowFetch == WindowFetch::REPLACE)
     {
-        QMessageBox::StandardButton result = QMessageBox::question(nullptr, tr("Uncommitted data"),
-                                                                   tr("There are uncommitted data changes. Do you want to proceed anyway? "
-                                                                      "All uncommitted changes will be lost."));
-
-        if (result != QMessageBox::Yes)
+        QList<SqlQueryItem*> uncommittedItems = getUncommittedItems();
+        if (uncommittedItems.size() > 0)
         {
-            internalExecutionStopped();
-            return;
+            QMessageBox::StandardButton result = QMessageBox::question(nullptr, tr("Uncommitted data"),
+                                                                       tr("There are uncommitted data changes. Do you want to proceed anyway? "
+                                                                          "All uncommitted changes will be lost."));
+
+            if (result != QMessageBox::Yes)
+            {
+                internalExecutionStopped();
+                return;
+            }
+
+            rollback(uncommittedItems);
         }
 
-        rollback(uncommittedItems);
+        emit executionStarted();
     }
 
-    emit executionStarted();
-
     queryExecutor->setQuery(query);
     queryExecutor->setResultsPerPage(getRowsPerPage());
     queryExecutor->setExplainMode(explain);
@@ -130,14 +161,43 @@ void SqlQueryModel::executeQueryInternal()
 void SqlQueryModel::internalExecutionStopped()
 {
     reloading = false;
+    windowFetch = WindowFetch::REPLACE;
     emit loadingEnded(false);
 }
 
 void SqlQueryModel::interrupt()
 {
+    if (committing)
+    {
+        commitWorker->interrupt();
+        return;
+    }
+
+    if (queryExecutor->isResultsCountingInProgress())
+    {
+        cancelResultsCounting();
+        return;
+    }
+
     queryExecutor->interrupt();
 }
 
+void SqlQueryModel::cancelResultsCounting()
+{
+    if (!queryExecutor->isResultsCountingInProgress())
+        return;
+
+    queryExecutor->cancelResultsCounting();
+    lastPageAfterCounting = false;
+
+    // What we know for sure is that there's at least as many rows as loaded so far (page is the last one loaded).
+    int rowsPerPage = getRowsPerPage();
+    totalRowsReturned = static_cast<quint64>(page + 1) * rowsPerPage;
+    totalPages = page + 2;
+    totalRowsAccuracy = QueryExecutor::RowCountAccuracy::LOWER_BOUND;
+    emit totalRowsAndPagesAvailable();
+}
+
 qint64 SqlQueryModel::getExecutionTime()
 {
     return lastExecutionTime;
@@ -158,6 +218,11 @@ qint64 SqlQueryModel::getTotalPages()
     return totalPages;
 }
 
+QueryExecutor::RowCountAccuracy SqlQueryModel::getTotalRowsAccuracy() const
+{
+    return totalRowsAccuracy;
+}
+
 QList<SqlQueryModelColumnPtr> SqlQueryModel::getColumns()
 {
     return columns;
@@ -165,12 +230,16 @@ QList<SqlQueryModelColumnPtr> SqlQueryModel::getColumns()
 
 SqlQueryItem *SqlQueryModel::itemFromIndex(const QModelIndex &index) const
 {
+    SqlQueryItem* item = materializeItem(index.row(), index.column());
+    if (item)
+        return item;
+
     return dynamic_cast<SqlQueryItem*>(QStandardItemModel::itemFromIndex(index));
 }
 
 SqlQueryItem*SqlQueryModel::itemFromIndex(int row, int column) const
 {
-    return dynamic_cast<SqlQueryItem*>(item(row, column));
+    return materializeItem(row, column);
 }
 
 int SqlQueryModel::getCellDataLengthLimit()
@@ -195,6 +264,34 @@ QModelIndexList SqlQueryModel::findIndexes(const QModelIndex& start, const QMode
     int fromCol = start.column();
     int toCol = end.column();
 
+    const SqlQueryModelSearchIndex* searchIdx = nullptr;
+    if (role == SqlQueryItem::DataRole::VALUE)
+        searchIdx = getSearchIndex(start, end);
+
+    if (searchIdx)
+    {
+        QVector<int> cellIds;
+        for (int col = fromCol; col <= toCol; col++)
+        {
+            for (int row : searchIdx->findRows(col, value))
+                cellIds << row * searchIdx->getColumnCount() + col;
+        }
+
+        QModelIndex idx;
+        for (const QPair<int,int>& cell : getSearchCandidates(cellIds, start, end))
+        {
+            if (!allHits && results.count() >= hits)
+                break;
+
+            idx = index(cell.first, cell.second, parentIdx);
+            if (value != data(idx, role))
+                continue;
+
+            results.append(idx);
+        }
+        return results;
+    }
+
     for (int row = fromRow; row <= toRow && (allHits || results.count() < hits); row++)
     {
         for (int col = fromCol; col <= toCol && (allHits || results.count() < hits); col++)
@@ -214,6 +311,51 @@ QModelIndexList SqlQueryModel::findIndexes(const QModelIndex& start, const QMode
     return results;
 }
 
+QModelIndexList SqlQueryModel::findIndexesContaining(const QModelIndex& start, const QModelIndex& end, const QString& text, Qt::CaseSensitivity cs, int hits) const
+{
+    QModelIndexList results;
+    bool allHits = hits < 0;
+    QModelIndex parentIdx = parent(start);
+    auto matchCell = [&](int row, int col) -> bool
+    {
+        QModelIndex idx = index(row, col, parentIdx);
+        if (!idx.isValid() || !data(idx, SqlQueryItem::DataRole::VALUE).toString().contains(text, cs))
+            return false;
+
+        results.append(idx);
+        return true;
+    };
+
+    const SqlQueryModelSearchIndex* searchIdx = nullptr;
+    if (text.length() >= SqlQueryModelSearchIndex::trigramLength)
+        searchIdx = getSearchIndex(start, end);
+
+    if (searchIdx)
+    {
+        for (const QPair<int,int>& cell : getSearchCandidates(searchIdx->findCells(text), start, end))
+        {
+            if (!allHits && results.count() >= hits)
+                break;
+
+            matchCell(cell.first, cell.second);
+        }
+        return results;
+    }
+
+    for (int row = start.row(); row <= end.row() && (allHits || results.count() < hits); row++)
+    {
+        for (int col = start.column(); col <= end.column() && (allHits || results.count() < hits); col++)
+            matchCell(row, col);
+    }
+
+    return results;
+}
+
+void SqlQueryModel::itemValueChanged(SqlQueryItem* item)
+{
+    itemsChangedSinceLoading << item;
+}
+
 QList<SqlQueryItem*> SqlQueryModel::findItems(int role, const QVariant& value, int hits) const
 {
     return toItemList(findIndexes(role, value, hits));
@@ -305,20 +447,24 @@ void SqlQueryModel::commit(const QList<SqlQueryItem*>& items)
     commitInternal(filterOutCommittedItems(items));
 }
 
-bool SqlQueryModel::commitRow(const QList<SqlQueryItem*>& itemsInRow)
+bool SqlQueryModel::prepareRowCommit(const QList<SqlQueryItem*>& itemsInRow, CommitStep& step)
 {
     const SqlQueryItem* item = itemsInRow.at(0);
     if (!item)
     {
-        qWarning() << "null item while call to commitRow() method. It shouldn't happen.";
+        qWarning() << "null item while call to prepareRowCommit() method. It shouldn't happen.";
         return true;
     }
     if (item->isNewRow())
-        return commitAddedRow(getRow(item->row())); // we need to get all items again, in case of selective commit
-    else if (item->isDeletedRow())
-        return commitDeletedRow(getRow(item->row())); // we need to get all items again, in case of selective commit
-    else
-        return commitEditedRow(itemsInRow);
+    {
+        step.type = CommitStep::Type::ADDED_ROW;
+        step.rows << getRow(item->row()); // we need to get all items again, in case of selective commit
+        return prepareAddedRowCommit(step.rows.first(), step);
+    }
+
+    step.type = CommitStep::Type::EDITED_ROW;
+    step.rows << itemsInRow;
+    return prepareEditedRowCommit(itemsInRow, step);
 }
 
 void SqlQueryModel::rollbackRow(const QList<SqlQueryItem*>& itemsInRow)
@@ -350,107 +496,194 @@ void SqlQueryModel::rollback(const QList<SqlQueryItem*>& items)
 
 void SqlQueryModel::commitInternal(const QList<SqlQueryItem*>& items)
 {
-    Db* db = getDb();
-    if (!db->isOpen())
+    if (committing)
+        return;
+
+    if (isExecutionInProgress())
     {
-        notifyError(tr("Cannot commit the data for a cell that refers to the already closed database."));
+        notifyWarn(tr("Cannot commit the data while the data is being loaded."));
         return;
     }
 
-    attachDependencyTables();
-
-    if (!db->begin())
+    Db* db = getDb();
+    if (!db->isOpen())
     {
-        notifyError(tr("Could not begin transaction on the database. Details: %1").arg(db->getErrorText()));
+        notifyError(tr("Cannot commit the data for a cell that refers to the already closed database."));
         return;
     }
 
-    // Getting number of rows to be added and deleted, so we can update totalPages at the end
-    int numberOfItemsAdded = groupItemsByRows(findItems(SqlQueryItem::DataRole::NEW_ROW, true)).size();
-    int numberOfItemsDeleted = groupItemsByRows(findItems(SqlQueryItem::DataRole::DELETED, true)).size();
+    attachDependencyTables();
 
     // Removing "commit error" mark from items that are going to be committed now
     for (SqlQueryItem* item : items)
         item->setCommittingError(false);
 
-    // Grouping by row and committing
+    // Deleted rows go first and all at once, so they can be deleted in batches (and free their unique values for other rows)
     QList<QList<SqlQueryItem*>> groupedItems = groupItemsByRows(items);
-    emit aboutToCommit(groupedItems.size());
-
-    int step = 1;
-    rowsDeletedSuccessfullyInTheCommit.clear();
-    bool ok = true;
+    QList<QList<SqlQueryItem*>> deletedRows;
+    QList<QList<SqlQueryItem*>> otherRows;
     for (const QList<SqlQueryItem*>& itemsInRow : groupedItems)
     {
-        if (!commitRow(itemsInRow))
-        {
-            ok = false;
+        SqlQueryItem* item = itemsInRow.first();
+        if (item && item->isDeletedRow())
+            deletedRows << getRow(item->row()); // we need to get all items again, in case of selective commit
+        else
+            otherRows << itemsInRow;
+    }
+
+    // Queries are prepared from items here, so the worker doesn't need to touch items
+    commitSteps.clear();
+    commitRowIdChanges.clear();
+    bool ok = deletedRows.isEmpty() || prepareDeletedRowsCommit(deletedRows, commitSteps);
+    for (const QList<SqlQueryItem*>& itemsInRow : otherRows)
+    {
+        if (!ok)
             break;
-        }
-        emit committingStepFinished(step++);
+
+        CommitStep step;
+        ok = prepareRowCommit(itemsInRow, step);
+        commitSteps << step;
     }
+    commitRowIdChanges.clear();
 
-    // Getting current uncommitted list (after rows deletion it may be different)
-    QList<SqlQueryItem*> itemsLeft = findItems(SqlQueryItem::DataRole::UNCOMMITTED, true);
+    if (!ok)
+    {
+        commitSteps.clear();
+        detachDependencyTables();
+        return;
+    }
 
-    // Getting common elements of initial and current item list, because of a possibility of the selective commit
-    QMutableListIterator<SqlQueryItem*> it(itemsLeft);
-    while (it.hasNext())
+    QList<SqlQueryModelCommitWorker::Step> workerSteps;
+    int totalRows = 0;
+    for (const CommitStep& step : commitSteps)
     {
-        if (!items.contains(it.next()))
-            it.remove();
+        workerSteps << step.queries;
+        totalRows += step.queries.rows;
     }
 
-    // Committing to the database
-    if (ok)
+    committing = true;
+    commitItems = items;
+    emit aboutToCommit(totalRows);
+
+    commitWorker = new SqlQueryModelCommitWorker(db, workerSteps);
+    connect(commitWorker, SIGNAL(rowsCommitted(int)), this, SIGNAL(committingStepFinished(int)));
+    commitWatcher->setFuture(QtConcurrent::run(commitWorker, &SqlQueryModelCommitWorker::run));
+}
+
+void SqlQueryModel::handleCommitFinished()
+{
+    bool ok = commitWatcher->result();
+    if (!ok)
     {
-        if (!db->commit())
+        int failedStep = commitWorker->getFailedStep();
+        if (failedStep > -1)
         {
-            ok = false;
-            notifyError(tr("An error occurred while committing the transaction: %1").arg(db->getErrorText()));
+            const CommitStep& step = commitSteps[failedStep];
+            for (SqlQueryItem* item : step.errorItems.value(commitWorker->getFailedStatement()))
+                item->setCommittingError(true);
+
+            notifyError(step.errorMessage.arg(commitWorker->getErrorText()));
         }
-        else
+        else if (commitWorker->isInterrupted())
+        {
+            notifyInfo(tr("Committing data was interrupted. Changes were rolled back in the database and they are still waiting for commit."));
+        }
+    }
+
+    finishCommit(ok);
+}
+
+void SqlQueryModel::finishCommit(bool successful)
+{
+    int itemsAddedDeletedDelta = 0;
+    if (successful)
+    {
+        // Applying results of steps in the same order as they were executed, as ROWID changes may depend on each other
+        QList<int> rowsDeleted;
+        for (int i = 0, total = commitSteps.size(); i < total; i++)
         {
-            // Committed successfully
-            for (SqlQueryItem* item : itemsLeft)
+            const CommitStep& step = commitSteps[i];
+            switch (step.type)
             {
-                item->setUncommitted(false);
-                item->setNewRow(false);
+                case CommitStep::Type::ADDED_ROW:
+                    finishAddedRowCommit(step.rows.first(), commitWorker->getInsertRowId(i));
+                    itemsAddedDeletedDelta++;
+                    break;
+                case CommitStep::Type::EDITED_ROW:
+                    for (const CommitStep::RowIdChange& change : step.rowIdChanges)
+                        updateRowIdForAllItems(change.table, change.rowId, change.newRowId);
+
+                    break;
+                case CommitStep::Type::DELETED_ROWS:
+                    for (const QList<SqlQueryItem*>& itemsInRow : step.rows)
+                        rowsDeleted << itemsInRow.first()->row();
+
+                    itemsAddedDeletedDelta -= step.rows.size();
+                    break;
             }
+        }
 
-            qSort(rowsDeletedSuccessfullyInTheCommit);
-            int removeOffset = 0;
-            for (int row : rowsDeletedSuccessfullyInTheCommit)
-                removeRow(row - removeOffset++); // deleting row decrements all rows below
-
-            emit commitStatusChanged(getUncommittedItems().size() > 0);
+        for (SqlQueryItem* item : commitItems)
+        {
+            item->setUncommitted(false);
+            item->setNewRow(false);
         }
-    }
-    rowsDeletedSuccessfullyInTheCommit.clear();
 
-    if (!ok)
-    {
-        if (!db->rollback())
+        // Removing from the bottom, so numbers of rows still to be removed don't change.
+        // Subsequent rows are removed together, as removing rows one by one is slow for large models.
+        qSort(rowsDeleted);
+        int rowsInRange;
+        for (int i = rowsDeleted.size() - 1; i >= 0; i -= rowsInRange)
         {
-            notifyError(tr("An error occurred while rolling back the transaction: %1").arg(db->getErrorText()));
-            // Nothing else we can do about it, but it should not happen.
+            int lastRow = rowsDeleted[i];
+            rowsInRange = 1;
+            while (i - rowsInRange >= 0 && rowsDeleted[i - rowsInRange] == lastRow - rowsInRange)
+                rowsInRange++;
+
+            removeRows(lastRow - rowsInRange + 1, rowsInRange);
         }
     }
 
-    detachDependencyTables();
-
-    // Updating added/deleted counts, to honor rows not deleted because of some errors
-    numberOfItemsAdded -= groupItemsByRows(findItems(SqlQueryItem::DataRole::NEW_ROW, true)).size();
-    numberOfItemsDeleted -= groupItemsByRows(findItems(SqlQueryItem::DataRole::DELETED, true)).size();
-    int itemsAddedDeletedDelta = numberOfItemsAdded - numberOfItemsDeleted;
+    safe_delete(commitWorker);
+    commitSteps.clear();
+    commitItems.clear();
+    committing = false;
 
+    detachDependencyTables();
     recalculateRowsAndPages(itemsAddedDeletedDelta);
 
+    if (successful)
+        emit commitStatusChanged(getUncommittedItems().size() > 0);
+
     emit commitFinished();
 }
 
+RowId SqlQueryModel::getRowIdForCommit(const AliasedTable& table, const RowId& rowId)
+{
+    if (!commitRowIdChanges.contains(table))
+        return rowId;
+
+    return commitRowIdChanges[table].value(getRowIdKey(rowId), rowId);
+}
+
+QByteArray SqlQueryModel::getRowIdKey(const RowId& rowId)
+{
+    QStringList rowIdColumns = rowId.keys();
+    qSort(rowIdColumns);
+
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+    for (const QString& column : rowIdColumns)
+        stream << column << rowId[column];
+
+    return key;
+}
+
 void SqlQueryModel::rollbackInternal(const QList<SqlQueryItem*>& items)
 {
+    if (committing)
+        return;
+
     QList<QList<SqlQueryItem*> > groupedItems = groupItemsByRows(items);
     foreach (const QList<SqlQueryItem*>& itemsInRow, groupedItems)
         rollbackRow(itemsInRow);
@@ -461,12 +694,14 @@ void SqlQueryModel::rollbackInternal(const QList<SqlQueryItem*>& items)
 void SqlQueryModel::reload()
 {
     queryExecutor->setSkipRowCounting(false);
+    queryExecutor->setCountingMode(getCountingMode());
     reloadInternal();
 }
 
 void SqlQueryModel::reloadInternal()
 {
-    if (!reloadAvailable)
+    // Progress of the commit is painted with events processed, so some deferred reload could get here in the middle of the commit
+    if (!reloadAvailable || committing)
         return;
 
     if (queryExecutor->isExecutionInProgress())
@@ -565,17 +800,24 @@ int SqlQueryModel::getCurrentPage(bool includeOneBeingLoaded) const
     return result < 0 ? 0 : result;
 }
 
-bool SqlQueryModel::commitAddedRow(const QList<SqlQueryItem*>& itemsInRow)
+bool SqlQueryModel::prepareAddedRowCommit(const QList<SqlQueryItem*>& itemsInRow, CommitStep& step)
 {
     UNUSED(itemsInRow);
+    UNUSED(step);
     return false;
 }
 
-bool SqlQueryModel::commitEditedRow(const QList<SqlQueryItem*>& itemsInRow)
+void SqlQueryModel::finishAddedRowCommit(const QList<SqlQueryItem*>& itemsInRow, const RowId& insertRowId)
+{
+    UNUSED(itemsInRow);
+    UNUSED(insertRowId);
+}
+
+bool SqlQueryModel::prepareEditedRowCommit(const QList<SqlQueryItem*>& itemsInRow, CommitStep& step)
 {
     if (itemsInRow.size() == 0)
     {
-        qWarning() << "SqlQueryModel::commitEditedRow() called with no items in the list.";
+        qWarning() << "SqlQueryModel::prepareEditedRowCommit() called with no items in the list.";
         return true;
     }
 
@@ -583,10 +825,11 @@ bool SqlQueryModel::commitEditedRow(const QList<SqlQueryItem*>& itemsInRow)
 
     QHash<AliasedTable,QList<SqlQueryItem*>> itemsByTable = groupItemsByTable(itemsInRow);
 
+    step.errorMessage = tr("An error occurred while committing the data: %1");
+
     // Values
-    QString query;
+    SqlQueryModelCommitWorker::Statement statement;
     SqlQueryModelColumn* col = nullptr;
-    QHash<QString,QVariant> queryArgs;
     QStringList assignmentArgs;
     RowId rowId;
     RowId newRowId;
@@ -600,7 +843,7 @@ bool SqlQueryModel::commitEditedRow(const QList<SqlQueryItem*>& itemsInRow)
         table = it.key();
         if (table.getTable().isNull())
         {
-            qCritical() << "Tried to commit null table in SqlQueryModel::commitEditedRow().";
+            qCritical() << "Tried to commit null table in SqlQueryModel::prepareEditedRowCommit().";
             continue;
         }
 
@@ -608,9 +851,9 @@ bool SqlQueryModel::commitEditedRow(const QList<SqlQueryItem*>& itemsInRow)
         if (items.size() == 0)
             continue;
 
-        // RowId
+        // RowId, as it will be after previous steps of the commit
         queryBuilder.clear();
-        rowId = items.first()->getRowId();
+        rowId = getRowIdForCommit(table, items.first()->getRowId());
         queryBuilder.setRowId(rowId);
         newRowId = getNewRowId(rowId, items); // if any of item updates any of rowid columns, then this will be different than initial rowid
 
@@ -636,45 +879,37 @@ bool SqlQueryModel::commitEditedRow(const QList<SqlQueryItem*>& itemsInRow)
         }
 
         // Completing query
-        query = queryBuilder.build();
+        statement.query = queryBuilder.build();
 
         // RowId condition arguments
-        queryArgs = queryBuilder.getQueryArgs();
+        statement.namedArgs = queryBuilder.getQueryArgs();
 
         // Per-column arguments
         assignmentArgs = queryBuilder.getAssignmentArgs();
         for (int i = 0, total = items.size(); i < total; ++i)
-            queryArgs[assignmentArgs[i]] = items[i]->getValue();
+            statement.namedArgs[assignmentArgs[i]] = items[i]->getValue();
 
-        // Get the data
-        SqlQueryPtr results = db->exec(query, queryArgs);
-        if (results->isError())
-        {
-            for (SqlQueryItem* item : items)
-                item->setCommittingError(true);
+        step.queries.statements << statement;
+        step.errorItems << items;
 
-            notifyError(tr("An error occurred while committing the data: %1").arg(results->getErrorText()));
-            return false;
-        }
-
-        // After successful commit, check if RowId was modified and upadate it accordingly
+        // If RowId is modified, items are updated after the commit, but following steps need the new one already
         if (rowId != newRowId)
-            updateRowIdForAllItems(table, rowId, newRowId);
+        {
+            step.rowIdChanges << CommitStep::RowIdChange{table, rowId, newRowId};
+            commitRowIdChanges[table][getRowIdKey(items.first()->getRowId())] = newRowId;
+        }
     }
 
     return true;
 }
 
-bool SqlQueryModel::commitDeletedRow(const QList<SqlQueryItem*>& itemsInRow)
+bool SqlQueryModel::prepareDeletedRowsCommit(const QList<QList<SqlQueryItem*>>& rows, QList<CommitStep>& steps)
 {
-    if (itemsInRow.size() == 0)
-    {
-        qCritical() << "No items passed to SqlQueryModel::commitDeletedRow().";
-        return false;
-    }
-
-    int row = itemsInRow[0]->index().row();
-    rowsDeletedSuccessfullyInTheCommit << row;
+    CommitStep step;
+    step.type = CommitStep::Type::DELETED_ROWS;
+    step.rows = rows;
+    step.queries.rows = rows.size();
+    steps << step;
     return true;
 }
 
@@ -737,70 +972,371 @@ QList<SqlQueryModelColumnPtr> SqlQueryModel::getTableColumnModels(const QString&
     return getTableColumnModels("main", table);
 }
 
-bool SqlQueryModel::loadData(SqlQueryPtr results)
+void SqlQueryModel::loadData(SqlQueryPtr results)
 {
-    if (rowCount() > 0)
+    bool replace = (windowFetch == WindowFetch::REPLACE);
+    if (replace && rowCount() > 0)
         clear();
 
     allDataLoaded = false;
-    view->horizontalHeader()->show();
 
-    // Read columns first. It will be needed later.
-    readColumns();
+    // Rows fetched while scrolling have the same columns as rows already loaded. Existing items refer to those columns.
+    if (replace)
+    {
+        view->horizontalHeader()->show();
+
+        // Read columns first. It will be needed later.
+        readColumns();
+    }
+
+    int rowsPerPage = getRowsPerPage();
+    if (replace)
+    {
+        rowNumBase = getCurrentPage() * rowsPerPage + 1;
+        updateColumnHeaderLabels();
+    }
+
+    // Rows are preloaded, so this only takes shared pointers to them. No events are processed while loading,
+    // so the model cannot be modified, nor deleted in the middle of it.
+    SqlResultsRowBlock rowList = results->nextBatch(rowsPerPage);
+
+    // No items are created here. Cells are served from loaded rows, until they're needed as items.
+    if (replace)
+    {
+        setRowCount(rowList.size());
+        loadedRows = rowList;
+        firstLoadedPage = getCurrentPage();
+        loadedPageRowCounts = {rowList.size()};
+        moreRowsAfterLoadedPages = (rowList.size() >= rowsPerPage);
+    }
+    else
+        insertFetchedRows(rowList);
+
+    allDataLoaded = true;
+}
+
+void SqlQueryModel::insertFetchedRows(const SqlResultsRowBlock& rowList)
+{
+    // Page after the last full page may turn out to be empty. It's not a page to keep in the window, it just tells there are no more rows.
+    if (rowList.isEmpty())
+    {
+        if (windowFetch == WindowFetch::APPEND)
+            moreRowsAfterLoadedPages = false;
+
+        queryExecutor->setPage(page);
+        return;
+    }
+
+    int rowsPerPage = getRowsPerPage();
+    if (windowFetch == WindowFetch::APPEND)
+    {
+        int firstRow = rowCount();
+        setRowCount(firstRow + rowList.size());
+        for (int i = 0; i < rowList.size(); i++)
+            loadedRows[firstRow + i] = rowList[i];
+
+        loadedPageRowCounts << rowList.size();
+        moreRowsAfterLoadedPages = (rowList.size() >= rowsPerPage);
+    }
+    else
+    {
+        insertRows(0, rowList.size());
+        for (int i = 0; i < rowList.size(); i++)
+            loadedRows[i] = rowList[i];
+
+        loadedPageRowCounts.prepend(rowList.size());
+        firstLoadedPage = getCurrentPage();
+
+        // Keep the rows that were visible before in the viewport
+        view->shiftVerticalScroll(rowList.size());
+    }
+
+    evictDistantPages();
+
+    page = firstLoadedPage + loadedPageRowCounts.size() - 1;
+    rowNumBase = firstLoadedPage * rowsPerPage + 1;
+    if (rowCount() > 0)
+        emit headerDataChanged(Qt::Vertical, 0, rowCount() - 1);
+}
+
+void SqlQueryModel::evictDistantPages()
+{
+    int rows;
+    while (loadedPageRowCounts.size() > continuousScrollingPages)
+    {
+        if (windowFetch == WindowFetch::APPEND)
+        {
+            rows = loadedPageRowCounts.first();
+            if (hasUncommittedItems(0, rows))
+                break;
+
+            if (rows > 0)
+                removeRows(0, rows);
+
+            loadedPageRowCounts.removeFirst();
+            firstLoadedPage++;
+            view->shiftVerticalScroll(-rows);
+        }
+        else
+        {
+            rows = loadedPageRowCounts.last();
+            if (hasUncommittedItems(rowCount() - rows, rows))
+                break;
+
+            if (rows > 0)
+                removeRows(rowCount() - rows, rows);
+
+            loadedPageRowCounts.removeLast();
+            moreRowsAfterLoadedPages = true;
+        }
+    }
+}
+
+bool SqlQueryModel::hasUncommittedItems(int firstRow, int rows) const
+{
+    if (rows <= 0)
+        return false;
+
+    QModelIndex startIdx = index(firstRow, 0);
+    QModelIndex endIdx = index(firstRow + rows - 1, columnCount() - 1);
+    return findIndexes(startIdx, endIdx, SqlQueryItem::DataRole::UNCOMMITTED, true, 1).size() > 0;
+}
+
+int SqlQueryModel::getPageIndexForRow(int row) const
+{
+    int pageEnd = 0;
+    for (int i = 0; i < loadedPageRowCounts.size(); i++)
+    {
+        pageEnd += loadedPageRowCounts[i];
+        if (row < pageEnd)
+            return i;
+    }
+    return loadedPageRowCounts.size() - 1;
+}
+
+void SqlQueryModel::fetchPageIntoWindow(int newPage, bool prepend)
+{
+    windowFetch = prepend ? WindowFetch::PREPEND : WindowFetch::APPEND;
+    queryExecutor->setSkipRowCounting(true);
+    queryExecutor->setPage(newPage);
+    reloadInternal();
+}
+
+SqlQueryItem* SqlQueryModel::materializeItem(int row, int column) const
+{
+    SqlQueryItem* cellItem = dynamic_cast<SqlQueryItem*>(item(row, column));
+    if (cellItem || row < 0 || row >= loadedRows.size() || column < 0 || column >= columns.size())
+        return cellItem;
+
+    SqlResultsRowPtr loadedRow = loadedRows[row];
+    if (!loadedRow)
+        return nullptr;
+
+    // Data of the cell doesn't change, it's just kept by the item from now on. The item is created from the item prototype
+    // by QStandardItemModel::itemFromIndex(), which doesn't emit any signals, and then it gets the data of prepared item
+    // without notifying the model either. This way views don't see any side effects of looking items up.
+    SqlQueryItem loadedItem;
+    updateItem(&loadedItem, loadedRow->value(column), column, getRowIdValue(loadedRow, column));
+
+    cellItem = dynamic_cast<SqlQueryItem*>(QStandardItemModel::itemFromIndex(index(row, column)));
+    if (cellItem)
+        cellItem->copyDataFrom(loadedItem);
+
+    return cellItem;
+}
+
+const SqlQueryModelSearchIndex* SqlQueryModel::getSearchIndex(const QModelIndex& start, const QModelIndex& end) const
+{
+    qint64 cells = qint64(end.row() - start.row() + 1) * (end.column() - start.column() + 1);
+    if (cells < searchIndexMinCells || !allDataLoaded)
+        return nullptr;
+
+    if (searchIndex)
+        return searchIndex.data();
+
+    if (searchIndexWatcher->isRunning())
+        return nullptr;
+
+    // Rows are shared with the background thread by copy of the vector. Rows themselves are not modified after loading.
+    searchIndexBuildGeneration = searchIndexGeneration;
+    searchIndexWatcher->setFuture(QtConcurrent::run(&SqlQueryModelSearchIndex::build, loadedRows, columns.size()));
+    return nullptr;
+}
+
+QVector<QPair<int,int>> SqlQueryModel::getSearchCandidates(const QVector<int>& cellIds, const QModelIndex& start, const QModelIndex& end) const
+{
+    int fromRow = start.row();
+    int toRow = end.row();
+    int fromCol = start.column();
+    int toCol = end.column();
+    auto inRange = [=](int row, int col) -> bool
+    {
+        return row >= fromRow && row <= toRow && col >= fromCol && col <= toCol;
+    };
+
+    QVector<QPair<int,int>> cells;
+    int indexColumns = searchIndex->getColumnCount();
+    int row;
+    int col;
+    for (int cellId : cellIds)
+    {
+        row = cellId / indexColumns;
+        col = cellId % indexColumns;
+        if (inRange(row, col))
+            cells << qMakePair(row, col);
+    }
+
+    // Edited cells and cells with full values loaded are not in the index, so they're always verified
+    QModelIndex idx;
+    for (SqlQueryItem* item : itemsChangedSinceLoading)
+    {
+        idx = indexFromItem(item);
+        if (inRange(idx.row(), idx.column()))
+            cells << qMakePair(idx.row(), idx.column());
+    }
+
+    std::sort(cells.begin(), cells.end());
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+    return cells;
+}
+
+void SqlQueryModel::invalidateSearchIndex()
+{
+    searchIndex.clear();
+    searchIndexGeneration++;
+}
+
+bool SqlQueryModel::sortLoadedRows(const QueryExecutor::SortList& newSortOrder)
+{
+    if (!canSortLoadedRows())
+        return false;
+
+    QList<SqlQueryModelRowSorter::SortColumn> sortColumns;
+    SqlQueryModelRowSorter::SortColumn sortColumn;
+    SqlQueryModelColumn::ConstraintCollate* collate = nullptr;
+    bool ok;
+    for (const QueryExecutor::Sort& sort : newSortOrder)
+    {
+        if (sort.order == QueryExecutor::Sort::NONE)
+            continue;
+
+        if (sort.column < 0 || sort.column >= columns.size())
+            return false;
+
+        collate = columns[sort.column]->getCollateConstraint();
+        sortColumn.column = sort.column;
+        sortColumn.descending = (sort.order == QueryExecutor::Sort::DESC);
+        sortColumn.collation = SqlQueryModelRowSorter::collationFromName(collate ? collate->collationName : QString(), ok);
+        if (!ok)
+            return false;
+
+        sortColumns << sortColumn;
+    }
+
+    // Original order of rows (without sorting) can be restored only by the database
+    if (sortColumns.isEmpty())
+        return false;
+
+    // Another sorting is in progress, this request is dropped
+    if (rowSortWatcher->isRunning())
+        return true;
+
+    pendingSortOrder = newSortOrder;
+    rowSortGeneration = searchIndexGeneration;
+    rowSortWatcher->setFuture(QtConcurrent::run(&SqlQueryModelRowSorter::sort, loadedRows, sortColumns, (int)cellDataLengthLimit));
+    return true;
+}
+
+bool SqlQueryModel::canSortLoadedRows() const
+{
+    // All results have to be loaded and rows cannot differ from loaded data, as rows are rebuilt from loaded data
+    return allDataLoaded && !isExecutionInProgress() && rowCount() > 0 &&
+            firstLoadedPage == 0 && loadedPageRowCounts.size() == 1 && !moreRowsAfterLoadedPages &&
+            itemsChangedSinceLoading.isEmpty() && !loadedRows.contains(SqlResultsRowPtr()) &&
+            getUncommittedItems().isEmpty();
+}
+
+QVariant SqlQueryModel::getLoadedCellData(SqlResultsRowPtr row, int columnIdx, int role) const
+{
+    QVariant value = row->value(columnIdx);
+    switch (role)
+    {
+        case Qt::EditRole:
+        case SqlQueryItem::DataRole::VALUE:
+            return SqlQueryItem::adjustVariantType(value);
+        case SqlQueryItem::DataRole::VALUE_FOR_DISPLAY:
+        case Qt::DisplayRole:
+        {
+            if (value.isNull() && role == Qt::DisplayRole)
+                return "NULL";
+
+            value = SqlQueryItem::adjustVariantType(value);
+            if (isLimitedValue(row->value(columnIdx)))
+                return value;
 
-    // Load data
-    SqlResultsRowPtr row;
-    int rowIdx = 0;
-    int rowsPerPage = getRowsPerPage();
-    rowNumBase = getCurrentPage() * rowsPerPage + 1;
+            return SqlQueryItem::limitValueForDisplay(value);
+        }
+        case Qt::ForegroundRole:
+        {
+            if (value.isNull())
+                return QBrush(CFG_UI.Colors.DataNullFg.get());
 
-    updateColumnHeaderLabels();
-    QList<QList<QStandardItem*>> rowList;
-    while (results->hasNext() && rowIdx < rowsPerPage)
-    {
-        row = results->next();
-        if (!row)
             break;
+        }
+        case Qt::TextAlignmentRole:
+        {
+            if (value.isNull())
+                return Qt::AlignCenter;
 
-        rowList << loadRow(row);
-
-        if ((rowIdx % 50) == 0)
+            return static_cast<int>(getCellAlignment(columns[columnIdx], value));
+        }
+        case Qt::FontRole:
         {
-            qApp->processEvents();
-            if (!existingModels.contains(this))
-                return false;
+            QFont font = CFG_UI.Fonts.DataView.get();
+            if (value.isNull())
+                font.setItalic(true);
+
+            return font;
         }
+        case Qt::ToolTipRole:
+        {
+            if (!CFG_UI.General.ShowDataViewTooltips.get() || view->getSimpleBrowserMode())
+                return QVariant();
 
-        rowIdx++;
+            return SqlQueryItem::getToolTip(columns[columnIdx].data(), getRowIdValue(row, columnIdx));
+        }
+        case SqlQueryItem::DataRole::ROWID:
+            return getRowIdValue(row, columnIdx);
+        case SqlQueryItem::DataRole::COLUMN:
+            return QVariant::fromValue(columns[columnIdx].data());
+        case SqlQueryItem::DataRole::LIMITED_VALUE:
+            return isLimitedValue(value);
+        case SqlQueryItem::DataRole::UNCOMMITTED:
+        case SqlQueryItem::DataRole::COMMITTING_ERROR:
+        case SqlQueryItem::DataRole::NEW_ROW:
+        case SqlQueryItem::DataRole::DELETED:
+        case SqlQueryItem::DataRole::JUST_INSERTED_WITHOUT_ROWID:
+            return false;
     }
+    return QVariant();
+}
 
-    rowIdx = 0;
-    for (const QList<QStandardItem*>& row : rowList)
-        insertRow(rowIdx++, row);
+Qt::Alignment SqlQueryModel::getCellAlignment(const SqlQueryModelColumnPtr& column, const QVariant& value) const
+{
+    if (column->isNumeric() && isNumeric(value))
+        return Qt::AlignRight|Qt::AlignVCenter;
 
-    allDataLoaded = true;
-    return true;
+    return Qt::AlignLeft|Qt::AlignVCenter;
 }
 
-QList<QStandardItem*> SqlQueryModel::loadRow(SqlResultsRowPtr row)
+bool SqlQueryModel::isLimitedValue(const QVariant& value)
 {
-    QList<QStandardItem*> itemList;
-    SqlQueryItem* item = nullptr;
-    RowId rowId;
-    int colIdx = 0;
-    foreach (const QVariant& value, row->valueList().mid(0, resultColumnCount))
-    {
-        item = new SqlQueryItem();
-        rowId = getRowIdValue(row, colIdx);
-        updateItem(item, value, colIdx, rowId);
-        itemList << item;
-        colIdx++;
-    }
-
-    return itemList;
+    // This should be equal at most, unless we have UTF-8 string, than there might be more bytes.
+    // If less, than it's not limited.
+    return value.toByteArray().size() >= cellDataLengthLimit;
 }
 
-RowId SqlQueryModel::getRowIdValue(SqlResultsRowPtr row, int columnIdx)
+RowId SqlQueryModel::getRowIdValue(SqlResultsRowPtr row, int columnIdx) const
 {
     RowId rowId;
     AliasedTable table = tablesForColumns[columnIdx];
@@ -827,24 +1363,14 @@ RowId SqlQueryModel::getRowIdValue(SqlResultsRowPtr row, int columnIdx)
     return rowId;
 }
 
-void SqlQueryModel::updateItem(SqlQueryItem* item, const QVariant& value, int columnIndex, const RowId& rowId)
+void SqlQueryModel::updateItem(SqlQueryItem* item, const QVariant& value, int columnIndex, const RowId& rowId) const
 {
     SqlQueryModelColumnPtr column = columns[columnIndex];
-    Qt::Alignment alignment;
-
-    if (column->isNumeric() && isNumeric(value))
-        alignment = Qt::AlignRight|Qt::AlignVCenter;
-    else
-        alignment = Qt::AlignLeft|Qt::AlignVCenter;
-
-    // This should be equal at most, unless we have UTF-8 string, than there might be more bytes.
-    // If less, than it's not limited.
-    bool limited = value.toByteArray().size() >= cellDataLengthLimit;
 
     item->setJustInsertedWithOutRowId(false);
-    item->setValue(value, limited, true);
+    item->setValue(value, isLimitedValue(value), true);
     item->setColumn(column.data());
-    item->setTextAlignment(alignment);
+    item->setTextAlignment(getCellAlignment(column, value));
     item->setRowId(rowId);
 }
 
@@ -887,22 +1413,25 @@ RowId SqlQueryModel::getNewRowId(const RowId& currentRowId, const QList<SqlQuery
 
 void SqlQueryModel::updateRowIdForAllItems(const AliasedTable& table, const RowId& rowId, const RowId& newRowId)
 {
-    SqlQueryItem* item = nullptr;
+    // Checking by data roles, so only cells that are actually updated get their items created
+    QModelIndex idx;
+    SqlQueryModelColumn* column = nullptr;
     for (int row = 0; row < rowCount(); row++)
     {
         for (int col = 0; col < columnCount(); col++)
         {
-            item = itemFromIndex(row, col);
-            if (item->getColumn()->database.compare(table.getDatabase(), Qt::CaseInsensitive) != 0)
+            idx = index(row, col);
+            column = data(idx, SqlQueryItem::DataRole::COLUMN).value<SqlQueryModelColumn*>();
+            if (column->database.compare(table.getDatabase(), Qt::CaseInsensitive) != 0)
                 continue;
 
-            if (item->getColumn()->table.compare(table.getTable(), Qt::CaseInsensitive) != 0)
+            if (column->table.compare(table.getTable(), Qt::CaseInsensitive) != 0)
                 continue;
 
-            if (item->getRowId() != rowId)
+            if (data(idx, SqlQueryItem::DataRole::ROWID).toHash() != rowId)
                 continue;
 
-            item->setRowId(newRowId);
+            itemFromIndex(row, col)->setRowId(newRowId);
         }
     }
 }
@@ -910,8 +1439,9 @@ void SqlQueryModel::updateRowIdForAllItems(const AliasedTable& table, const RowI
 QHash<QString, QVariantList> SqlQueryModel::toValuesGroupedByColumns(const QList<SqlQueryItem*>& items)
 {
     QHash<QString, QVariantList> values;
+    QHash<SqlQueryItem*,QVariant> fullValues = loadFullValues(items);
     for (SqlQueryItem* item : items)
-        values[item->getColumn()->displayName] << item->getFullValue();
+        values[item->getColumn()->displayName] << fullValues[item];
 
     return values;
 }
@@ -1132,30 +1662,53 @@ void SqlQueryModel::handleExecFinished(SqlQueryPtr results)
 {
     if (results->isError())
     {
+        windowFetch = WindowFetch::REPLACE;
         emit executionFailed(tr("Error while executing SQL query on database '%1': %2").arg(db->getName(), results->getErrorText()));
         return;
     }
 
     storeStep1NumbersFromExecution();
-    if (!loadData(results))
-        return;
-
+    loadData(results);
     storeStep2NumbersFromExecution();
 
     requiredDbAttaches = queryExecutor->getRequiredDbAttaches();
     reloadAvailable = true;
 
-    emit loadingEnded(true);
+    bool fetchedWhileScrolling = (windowFetch != WindowFetch::REPLACE);
+    windowFetch = WindowFetch::REPLACE;
+    if (fetchedWhileScrolling)
+        emit rowsFetchedWhileScrolling();
+    else
+        emit loadingEnded(true);
+
     restoreNumbersToQueryExecutor();
     if (!reloading)
         emit executionSuccessful();
 
     reloading = false;
 
-    bool rowsCountedManually = queryExecutor->isRowCountingRequired() || rowCount() < getRowsPerPage();
+    // Page loaded in the middle of results gets its preceding page too, so user can scroll up from the start
+    if (!fetchedWhileScrolling && canFetchPreviousRows())
+        QTimer::singleShot(0, this, SLOT(fetchPreviousRows()));
+
+    // Results have to be released before counting, as the counting may finish (and detach databases) immediately
+    results.clear();
+
+    bool rowsCountedManually = queryExecutor->isRowCountingRequired() || loadedPageRowCounts.isEmpty() ||
+                               loadedPageRowCounts.last() < getRowsPerPage();
     bool countRes = false;
-    if (rowsCountedManually)
+    if (queryExecutor->getSkipRowCounting() && totalRowsAccuracy != QueryExecutor::RowCountAccuracy::EXACT)
+    {
+        updateInexactTotalRows();
+    }
+    else if (rowsCountedManually)
     {
+        if (lastPageAfterCounting)
+        {
+            // It's already the last page
+            lastPageAfterCounting = false;
+            queryExecutor->setCountingMode(getCountingMode());
+        }
         emit totalRowsAndPagesAvailable();
         emit storeExecutionInHistory();
     }
@@ -1163,17 +1716,21 @@ void SqlQueryModel::handleExecFinished(SqlQueryPtr results)
         countRes = queryExecutor->countResults();
 
     if (!countRes || !queryExecutor->getAsyncMode())
-    {
-        results.clear();
         detachDatabases();
-    }
 }
 
 void SqlQueryModel::handleExecFailed(int code, QString errorMessage)
 {
     UNUSED(code);
 
-    if (rowCount() > 0)
+    bool fetchedWhileScrolling = (windowFetch != WindowFetch::REPLACE);
+    windowFetch = WindowFetch::REPLACE;
+    if (fetchedWhileScrolling)
+    {
+        // Rows already loaded stay as they are. Don't try to fetch after the failed page again.
+        moreRowsAfterLoadedPages = false;
+    }
+    else if (rowCount() > 0)
     {
         clear();
         columns.clear();
@@ -1192,24 +1749,131 @@ void SqlQueryModel::handleExecFailed(int code, QString errorMessage)
         emit executionFailed(tr("Error while executing SQL query on database '%1': %2").arg(db->getName(), errorMessage));
 
     restoreNumbersToQueryExecutor();
-    resultsCountingFinished(0, 0, 0);
+    if (!fetchedWhileScrolling)
+        resultsCountingFinished(0, 0, 0);
 
     reloading = false;
 }
 
+void SqlQueryModel::handleRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    UNUSED(parent);
+    // Rows inserted by loadData() are assigned right after they're inserted. Other rows (like new rows) have their items.
+    loadedRows.insert(first, last - first + 1, SqlResultsRowPtr());
+    invalidateSearchIndex();
+
+    // Pages are counted by loadData(). Rows added by the user extend the page they were added to.
+    if (allDataLoaded && !loadedPageRowCounts.isEmpty())
+        loadedPageRowCounts[getPageIndexForRow(first)] += last - first + 1;
+}
+
+void SqlQueryModel::handleRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last)
+{
+    UNUSED(parent);
+    QMutableSetIterator<SqlQueryItem*> it(itemsChangedSinceLoading);
+    int row;
+    while (it.hasNext())
+    {
+        row = it.next()->row();
+        if (row >= first && row <= last)
+            it.remove();
+    }
+}
+
+void SqlQueryModel::handleRowsRemoved(const QModelIndex& parent, int first, int last)
+{
+    UNUSED(parent);
+    loadedRows.remove(first, last - first + 1);
+    invalidateSearchIndex();
+
+    if (!allDataLoaded)
+        return;
+
+    // Page counts still include removed rows, so each removed row is at the "first" position
+    int pageIdx;
+    for (int i = first; i <= last && !loadedPageRowCounts.isEmpty(); i++)
+    {
+        pageIdx = getPageIndexForRow(first);
+        if (loadedPageRowCounts[pageIdx] > 0)
+            loadedPageRowCounts[pageIdx]--;
+    }
+}
+
+void SqlQueryModel::handleModelReset()
+{
+    loadedRows.clear();
+    loadedPageRowCounts.clear();
+    itemsChangedSinceLoading.clear();
+    invalidateSearchIndex();
+}
+
+void SqlQueryModel::handleLoadedRowsSorted()
+{
+    // Rows could have been reloaded, or edited while they were being sorted
+    if (rowSortGeneration != searchIndexGeneration || !canSortLoadedRows())
+        return;
+
+    SqlResultsRowBlock sortedRows = rowSortWatcher->result();
+    if (sortedRows.isEmpty())
+    {
+        // Order could not be determined from loaded (limited) values
+        queryExecutor->setSkipRowCounting(true);
+        queryExecutor->setSortOrder(pendingSortOrder);
+        reloadInternal();
+        return;
+    }
+
+    // Rows are replaced without resetting the model, so columns and their widths stay as they are
+    allDataLoaded = false;
+    removeRows(0, rowCount());
+    setRowCount(sortedRows.size());
+    loadedRows = sortedRows;
+    loadedPageRowCounts = {sortedRows.size()};
+    allDataLoaded = true;
+
+    sortOrder = pendingSortOrder;
+    queryExecutor->setSortOrder(sortOrder);
+    emit sortingUpdated(sortOrder);
+    emit headerDataChanged(Qt::Horizontal, 0, columnCount() - 1);
+}
+
+void SqlQueryModel::handleSearchIndexBuilt()
+{
+    // Rows could have changed while the index was being built
+    if (searchIndexBuildGeneration != searchIndexGeneration)
+        return;
+
+    searchIndex = searchIndexWatcher->result();
+}
+
 void SqlQueryModel::resultsCountingFinished(quint64 rowsAffected, quint64 rowsReturned, int totalPages)
 {
     this->rowsAffected = rowsAffected;
     this->totalRowsReturned = rowsReturned;
     this->totalPages = totalPages;
+    totalRowsAccuracy = queryExecutor->getTotalRowsAccuracy();
     detachDatabases();
     emit totalRowsAndPagesAvailable();
     emit storeExecutionInHistory();
+
+    if (lastPageAfterCounting)
+    {
+        lastPageAfterCounting = false;
+        queryExecutor->setCountingMode(getCountingMode());
+        if (totalRowsAccuracy == QueryExecutor::RowCountAccuracy::EXACT && totalPages > 0)
+            lastPage();
+    }
 }
 
 void SqlQueryModel::itemValueEdited(SqlQueryItem* item)
 {
-    UNUSED(item);
+    // Checking all items on each edited cell makes pasting many cells quadratic, so it's done only when necessary
+    if (item->isUncommitted())
+    {
+        emit commitStatusChanged(true);
+        return;
+    }
+
     emit commitStatusChanged(getUncommittedItems().size() > 0);
 }
 
@@ -1218,8 +1882,12 @@ void SqlQueryModel::changeSorting(int logicalIndex, Qt::SortOrder order)
     if (!reloadAvailable)
         return;
 
+    QueryExecutor::SortList newSortOrder = {QueryExecutor::Sort(order, logicalIndex)};
+    if (sortLoadedRows(newSortOrder))
+        return;
+
     queryExecutor->setSkipRowCounting(true);
-    queryExecutor->setSortOrder({QueryExecutor::Sort(order, logicalIndex)});
+    queryExecutor->setSortOrder(newSortOrder);
     reloadInternal();
 }
 
@@ -1287,6 +1955,16 @@ void SqlQueryModel::lastPage()
     if (!reloadAvailable)
         return;
 
+    if (totalRowsAccuracy != QueryExecutor::RowCountAccuracy::EXACT)
+    {
+        // Where the last page is becomes known only after counting all rows, so do it now
+        lastPageAfterCounting = true;
+        queryExecutor->setSkipRowCounting(false);
+        queryExecutor->setCountingMode(QueryExecutor::CountingMode::EXACT);
+        reloadInternal();
+        return;
+    }
+
     int page  = totalPages - 1;
     if (page < 0) // this should never happen, but let's have it just in case
     {
@@ -1327,6 +2005,7 @@ void SqlQueryModel::storeStep1NumbersFromExecution()
     if (!queryExecutor->getSkipRowCounting())
     {
         totalPages = queryExecutor->getTotalPages();
+        totalRowsAccuracy = QueryExecutor::RowCountAccuracy::EXACT;
         if (!queryExecutor->isRowCountingRequired())
             totalRowsReturned = queryExecutor->getTotalRowsReturned();
     }
@@ -1371,11 +2050,16 @@ QueryExecutor::SortList SqlQueryModel::getSortOrder() const
 
 void SqlQueryModel::setSortOrder(const QueryExecutor::SortList& newSortOrder)
 {
-    sortOrder = newSortOrder;
-
     if (!reloadAvailable)
+    {
+        sortOrder = newSortOrder;
+        return;
+    }
+
+    if (sortLoadedRows(newSortOrder))
         return;
 
+    sortOrder = newSortOrder;
     queryExecutor->setSkipRowCounting(true);
     queryExecutor->setSortOrder(newSortOrder);
     reloadInternal();
@@ -1505,7 +2189,11 @@ void SqlQueryModel::recalculateRowsAndPages(int rowsDelta)
     totalRowsReturned += rowsDelta;
 
     int rowsPerPage = getRowsPerPage();
-    totalPages = (int)qCeil(((double)totalRowsReturned) / ((double)rowsPerPage));
+    if (totalRowsAccuracy == QueryExecutor::RowCountAccuracy::LOWER_BOUND)
+        totalPages = static_cast<int>(totalRowsReturned / rowsPerPage) + 1;
+    else
+        totalPages = (int)qCeil(((double)totalRowsReturned) / ((double)rowsPerPage));
+
     emit totalRowsAndPagesAvailable();
 
     if (rowCount() == 0)
@@ -1545,6 +2233,48 @@ int SqlQueryModel::getRowsPerPage() const
     return rowsPerPage;
 }
 
+QueryExecutor::CountingMode SqlQueryModel::getCountingMode() const
+{
+    switch (static_cast<Cfg::ResultsCountingMode>(CFG_UI.General.ResultsCountingMode.get()))
+    {
+        case Cfg::COUNT_EXACT:
+            break;
+        case Cfg::COUNT_ESTIMATED:
+            return QueryExecutor::CountingMode::ESTIMATED;
+        case Cfg::COUNT_LAZY:
+            return QueryExecutor::CountingMode::LAZY;
+    }
+    return QueryExecutor::CountingMode::EXACT;
+}
+
+void SqlQueryModel::updateInexactTotalRows()
+{
+    if (loadedPageRowCounts.isEmpty())
+        return;
+
+    int rowsPerPage = getRowsPerPage();
+    int rowsInPage = loadedPageRowCounts.last();
+    qint64 rowsUpToThisPage = static_cast<qint64>(page) * rowsPerPage + rowsInPage;
+    if (rowsInPage < rowsPerPage || !moreRowsAfterLoadedPages)
+    {
+        // Not a full page (or a full page followed by an empty one), so it's the last one and now we know the exact number
+        totalRowsReturned = rowsUpToThisPage;
+        totalPages = page + 1;
+        totalRowsAccuracy = QueryExecutor::RowCountAccuracy::EXACT;
+    }
+    else if (rowsUpToThisPage >= static_cast<qint64>(totalRowsReturned))
+    {
+        // Went beyond the estimate, so it's a lower bound from now on, with one more page available
+        totalRowsReturned = rowsUpToThisPage;
+        totalPages = page + 2;
+        totalRowsAccuracy = QueryExecutor::RowCountAccuracy::LOWER_BOUND;
+    }
+    else
+        return;
+
+    emit totalRowsAndPagesAvailable();
+}
+
 int SqlQueryModel::getQueryCountLimitForSmartMode() const
 {
     return queryExecutor->getQueryCountLimitForSmartMode();
@@ -1565,6 +2295,43 @@ bool SqlQueryModel::isAllDataLoaded() const
     return allDataLoaded;
 }
 
+bool SqlQueryModel::isContinuousScrolling() const
+{
+    return CFG_UI.General.ContinuousScrolling.get() && hardRowLimit < 0;
+}
+
+bool SqlQueryModel::canFetchMore(const QModelIndex& parent) const
+{
+    if (parent.isValid() || !isContinuousScrolling() || !allDataLoaded || !reloadAvailable || isExecutionInProgress() || committing)
+        return false;
+
+    return moreRowsAfterLoadedPages;
+}
+
+void SqlQueryModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    fetchPageIntoWindow(page + 1, false);
+}
+
+bool SqlQueryModel::canFetchPreviousRows() const
+{
+    if (!isContinuousScrolling() || !allDataLoaded || !reloadAvailable || isExecutionInProgress() || committing)
+        return false;
+
+    return firstLoadedPage > 0;
+}
+
+void SqlQueryModel::fetchPreviousRows()
+{
+    if (!canFetchPreviousRows())
+        return;
+
+    fetchPageIntoWindow(firstLoadedPage - 1, true);
+}
+
 int SqlQueryModel::getHardRowLimit() const
 {
     return hardRowLimit;
@@ -1587,6 +2354,9 @@ void SqlQueryModel::setSimpleExecutionMode(bool value)
 
 void SqlQueryModel::addNewRow()
 {
+    if (committing)
+        return;
+
     addNewRowInternal(getInsertRowIndex());
 
     emit commitStatusChanged(true);
@@ -1594,6 +2364,9 @@ void SqlQueryModel::addNewRow()
 
 void SqlQueryModel::addMultipleRows()
 {
+    if (committing)
+        return;
+
     bool ok;
     int rows = QInputDialog::getInt(view, tr("Insert multiple rows"), tr("Number of rows to insert:"), 1, 1, 10000, 1, &ok);
     if (!ok)
@@ -1608,6 +2381,9 @@ void SqlQueryModel::addMultipleRows()
 
 void SqlQueryModel::deleteSelectedRows()
 {
+    if (committing)
+        return;
+
     QList<SqlQueryItem*> selectedItems = view->getSelectedItems();
     QSet<int> rows;
     foreach (SqlQueryItem* item, selectedItems)
@@ -1675,6 +2451,11 @@ void SqlQueryModel::applyRegExpFilter(const QString& value)
     // For custom query this is not supported.
 }
 
+void SqlQueryModel::applyFullTextFilter(const QString& value)
+{
+    applyStringFilter(value);
+}
+
 void SqlQueryModel::resetFilter()
 {
     // For custom query this is not supported.
@@ -1686,6 +2467,26 @@ int SqlQueryModel::columnCount(const QModelIndex& parent) const
     return headerColumns.size();
 }
 
+QVariant SqlQueryModel::data(const QModelIndex& index, int role) const
+{
+    int row = index.row();
+    if (!index.isValid() || item(row, index.column()) || row >= loadedRows.size() || index.column() >= columns.size())
+        return QStandardItemModel::data(index, role);
+
+    SqlResultsRowPtr loadedRow = loadedRows[row];
+    if (!loadedRow)
+        return QStandardItemModel::data(index, role);
+
+    return getLoadedCellData(loadedRow, index.column(), role);
+}
+
+bool SqlQueryModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    // Otherwise QStandardItemModel would create an empty item, with no column, nor ROWID
+    materializeItem(index.row(), index.column());
+    return QStandardItemModel::setData(index, value, role);
+}
+
 QVariant SqlQueryModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
     if (role == Qt::DisplayRole)
@@ -1731,6 +2532,7 @@ void SqlQueryModel::loadFullDataForEntireRow(int row)
 {
     int colCnt = columns.size();
     SqlQueryItem *item = nullptr;
+    QList<SqlQueryItem*> limitedItems;
     for (int col = 0; col < colCnt; col++)
     {
         item = itemFromIndex(row, col);
@@ -1740,10 +2542,187 @@ void SqlQueryModel::loadFullDataForEntireRow(int row)
         if (!item->isLimitedValue())
             continue;
 
-        item->loadFullData();
+        limitedItems << item;
+    }
+
+    if (limitedItems.isEmpty())
+        return;
+
+    QHash<SqlQueryItem*,QVariant> values = loadLimitedValues(limitedItems);
+    for (SqlQueryItem* limitedItem : values.keys())
+        limitedItem->setValue(values[limitedItem], false, true);
+}
+
+QHash<SqlQueryItem*,QVariant> SqlQueryModel::loadFullValues(const QList<SqlQueryItem*>& items)
+{
+    QHash<SqlQueryItem*,QVariant> values;
+    QList<SqlQueryItem*> limitedItems;
+    for (SqlQueryItem* item : items)
+    {
+        if (item->isLimitedValue())
+            limitedItems << item;
+        else
+            values[item] = item->getValue();
+    }
+
+    values.unite(loadLimitedValues(limitedItems));
+
+    // Values that could not be loaded
+    for (SqlQueryItem* item : limitedItems)
+    {
+        if (!values.contains(item))
+            values[item] = item->getValue();
+    }
+
+    return values;
+}
+
+QHash<SqlQueryItem*,QVariant> SqlQueryModel::loadLimitedValues(const QList<SqlQueryItem*>& limitedItems)
+{
+    QHash<SqlQueryItem*,QVariant> values;
+    if (limitedItems.isEmpty())
+        return values;
+
+    if (!getDb()->isOpen())
+    {
+        qWarning() << "Tried to load the data for cells that refer to the already closed database.";
+        return values;
+    }
+
+    // Cells not editable can't be identified in the database, so their values can't be loaded
+    QList<SqlQueryItem*> itemsToLoad;
+    for (SqlQueryItem* item : limitedItems)
+    {
+        if (item->getColumn()->editionForbiddenReason.size() == 0)
+            itemsToLoad << item;
+    }
+
+    // Grouping by source table and by ROWID columns (they're the same for all rows of the table, but let's not assume it)
+    QHash<AliasedTable,QList<SqlQueryItem*>> itemsByTable = groupItemsByTable(itemsToLoad);
+    QHash<QString,QList<SqlQueryItem*>> itemsByRowIdColumns;
+    QStringList keyColumns;
+    for (const QList<SqlQueryItem*>& tableItems : itemsByTable)
+    {
+        itemsByRowIdColumns.clear();
+        for (SqlQueryItem* item : tableItems)
+        {
+            keyColumns = item->getRowId().keys();
+            qSort(keyColumns);
+            itemsByRowIdColumns[keyColumns.join(",")] << item;
+        }
+
+        for (const QList<SqlQueryItem*>& rowIdItems : itemsByRowIdColumns)
+            loadFullValuesForTable(rowIdItems, values);
+    }
+
+    return values;
+}
+
+void SqlQueryModel::loadFullValuesForTable(const QList<SqlQueryItem*>& items, QHash<SqlQueryItem*,QVariant>& values)
+{
+    static_qstring(selectTpl, "SELECT %1 FROM %2 WHERE %3");
+    static_qstring(inTpl, "%1 IN (%2)");
+
+    Db* db = getDb();
+    Dialect dialect = db->getDialect();
+
+    QStringList keyColumns = items.first()->getRowId().keys();
+    if (keyColumns.isEmpty())
+        return;
+
+    qSort(keyColumns);
+
+    // Database and table
+    SqlQueryModelColumn* col = items.first()->getColumn();
+    QString source = wrapObjIfNeeded(col->table, dialect);
+    if (!col->database.isNull())
+        source.prepend(wrapObjIfNeeded(col->database, dialect)+".");
+
+    // Cells by rows and columns to select. ROWID columns go first in results, so rows can be matched with cells.
+    QHash<QString,QList<SqlQueryItem*>> itemsByRowId;
+    QHash<QString,RowId> rowIds;
+    QHash<QString,int> resultColumnIndexes;
+    QStringList resultColumns = keyColumns; // ROWID columns are used unwrapped, just like by RowIdConditionBuilder
+    QString rowIdKey;
+    for (SqlQueryItem* item : items)
+    {
+        rowIdKey = getRowIdKey(keyColumns, item->getRowId());
+        itemsByRowId[rowIdKey] << item;
+        rowIds[rowIdKey] = item->getRowId();
+
+        if (!resultColumnIndexes.contains(item->getColumn()->column))
+        {
+            resultColumnIndexes[item->getColumn()->column] = resultColumns.size();
+            resultColumns << wrapObjIfNeeded(item->getColumn()->column, dialect);
+        }
+    }
+
+    // Querying in batches of rows
+    QStringList rowIdKeys = itemsByRowId.keys();
+    int rowsPerQuery = qMax(1, fullValuesMaxArgs / keyColumns.size());
+    QStringList conditions;
+    QStringList keyConditions;
+    QList<QVariant> args;
+    QString where;
+    SqlQueryPtr results;
+    SqlResultsRowPtr row;
+    for (int i = 0, total = rowIdKeys.size(); i < total; i += rowsPerQuery)
+    {
+        conditions.clear();
+        args.clear();
+        for (const QString& key : rowIdKeys.mid(i, rowsPerQuery))
+        {
+            const RowId& rowId = rowIds[key];
+            if (keyColumns.size() == 1)
+            {
+                conditions << "?";
+                args << rowId[keyColumns.first()];
+                continue;
+            }
+
+            keyConditions.clear();
+            for (const QString& keyColumn : keyColumns)
+            {
+                keyConditions << keyColumn + " = ?";
+                args << rowId[keyColumn];
+            }
+            conditions << "(" + keyConditions.join(" AND ") + ")";
+        }
+
+        if (keyColumns.size() == 1)
+            where = inTpl.arg(keyColumns.first(), conditions.join(", "));
+        else
+            where = conditions.join(" OR ");
+
+        results = db->exec(selectTpl.arg(resultColumns.join(", "), source, where), args);
+        if (results->isError())
+        {
+            qWarning() << "Could not load full values of cells from table" << col->table << ":" << results->getErrorText();
+            return;
+        }
+
+        while (results->hasNext())
+        {
+            row = results->next();
+            RowId resultRowId;
+            for (int k = 0, keys = keyColumns.size(); k < keys; k++)
+                resultRowId[keyColumns[k]] = row->value(k);
+
+            for (SqlQueryItem* item : itemsByRowId.value(getRowIdKey(keyColumns, resultRowId)))
+                values[item] = row->value(resultColumnIndexes[item->getColumn()->column]);
+        }
     }
 }
 
+QString SqlQueryModel::getRowIdKey(const QStringList& keyColumns, const RowId& rowId)
+{
+    QStringList keyValues;
+    for (const QString& keyColumn : keyColumns)
+        keyValues << rowId[keyColumn].toString();
+
+    return keyValues.join(QChar(0));
+}
+
 void SqlQueryModel::CommitUpdateQueryBuilder::clear()
 {
     database.clear();
@@ -10,8 +10,12 @@
 #include "guiSQLiteStudio_global.h"
 #include "sqlqueryitemdelegate.h"
 #include "common/strhash.h"
+#include "datagrid/sqlquerymodelsearchindex.h"
+#include "datagrid/sqlquerymodelrowsorter.h"
+#include "datagrid/sqlquerymodelcommitworker.h"
 #include <QStandardItemModel>
 #include <QItemSelection>
+#include <QFutureWatcher>
 
 class SqlQueryItem;
 class FormView;
@@ -48,6 +52,7 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         qint64 getTotalRowsReturned();
         qint64 getTotalRowsAffected();
         qint64 getTotalPages();
+        QueryExecutor::RowCountAccuracy getTotalRowsAccuracy() const;
         QList<SqlQueryModelColumnPtr> getColumns();
         SqlQueryItem* itemFromIndex(const QModelIndex& index) const;
         SqlQueryItem* itemFromIndex(int row, int column) const;
@@ -55,12 +60,47 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         QModelIndexList findIndexes(const QModelIndex &start, const QModelIndex& end, int role, const QVariant &value, int hits = -1) const;
         QList<SqlQueryItem*> findItems(int role, const QVariant &value, int hits = -1) const;
         QList<SqlQueryItem*> findItems(const QModelIndex &start, const QModelIndex& end, int role, const QVariant &value, int hits = -1) const;
+
+        /**
+         * @brief Finds cells with values containing given text.
+         * @param start First cell to look at.
+         * @param end Last cell to look at.
+         * @param text Text to look for.
+         * @param cs Case sensitivity of the comparison.
+         * @param hits Maximum number of cells to find, or -1 to find all.
+         * @return Matching cells in order of rows, then columns.
+         *
+         * Like findIndexes(), it uses the search index for large pages of data, once the index is built.
+         */
+        QModelIndexList findIndexesContaining(const QModelIndex &start, const QModelIndex& end, const QString& text,
+                                              Qt::CaseSensitivity cs = Qt::CaseInsensitive, int hits = -1) const;
+
+        /**
+         * @brief Tells the model that value of the item has changed.
+         * @param item Item with changed value.
+         *
+         * It's called by the item, so the model knows which cells differ from values indexed by the search index.
+         */
+        void itemValueChanged(SqlQueryItem* item);
         QList<SqlQueryItem*> getUncommittedItems() const;
         QList<SqlQueryItem*> getRow(int row);
         int columnCount(const QModelIndex& parent = QModelIndex()) const;
+        QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+        bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole);
         QVariant headerData(int section, Qt::Orientation orientation, int role) const;
         bool isExecutionInProgress() const;
         void loadFullDataForEntireRow(int row);
+
+        /**
+         * @brief Provides full values of given cells, loading values limited by the cell data length limit from the database.
+         * @param items Cells to provide values for.
+         * @return Full value for each of given cells.
+         *
+         * Limited values are loaded with a single query for a batch of rows of the same table (instead of a query for each cell),
+         * so it's meant to be used for operations on many cells, like copying a selection.
+         * Values of cells are not modified. If a value could not be loaded, the limited value is provided.
+         */
+        QHash<SqlQueryItem*,QVariant> loadFullValues(const QList<SqlQueryItem*>& items);
         StrHash<QString> attachDependencyTables();
         void detachDependencyTables();
         virtual QString generateSelectQueryForItems(const QList<SqlQueryItem*>& items);
@@ -97,6 +137,14 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          */
         virtual void applyRegExpFilter(const QString& value);
 
+        /**
+         * @brief applyFullTextFilter
+         * @param value Filter expression.
+         * Default implementation calls applyStringFilter(). Working implementation (i.e. for a table)
+         * should use a full-text index to find rows containing given plain text in any column and reload the data.
+         */
+        virtual void applyFullTextFilter(const QString& value);
+
         /**
          * @brief resetFilter
          * Default implementation does nothing. Working implementation (i.e. for a table)
@@ -140,6 +188,19 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
 
         bool isAllDataLoaded() const;
 
+        /**
+         * @brief Tells whether pages are loaded on demand while scrolling the view.
+         * @return true if continuous scrolling is enabled in configuration and applicable to this model.
+         *
+         * In continuous scrolling mode pages of results are appended to (or prepended to) rows already
+         * presented in the view, as user scrolls to the end (or to the beginning) of the view.
+         * Only a few pages are kept in the model. Pages most distant from the loaded one are removed.
+         */
+        bool isContinuousScrolling() const;
+        bool canFetchMore(const QModelIndex& parent) const;
+        void fetchMore(const QModelIndex& parent);
+        bool canFetchPreviousRows() const;
+
         bool isStructureOutOfDate() const;
 
         int getQueryCountLimitForSmartMode() const;
@@ -167,37 +228,97 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         };
 
         /**
-         * @brief commitAddedRow Inserts new row to a table.
+         * @brief Part of the commit prepared from items of one, or more rows.
+         *
+         * Steps are prepared on the GUI thread, before the commit starts. Their queries are executed by the commit worker
+         * in a background thread, so they must not refer to items. Items are updated after the worker has finished.
+         */
+        struct CommitStep
+        {
+            enum class Type
+            {
+                ADDED_ROW,
+                EDITED_ROW,
+                DELETED_ROWS
+            };
+
+            struct RowIdChange
+            {
+                AliasedTable table;
+                RowId rowId;
+                RowId newRowId;
+            };
+
+            Type type = Type::EDITED_ROW;
+
+            /**
+             * @brief Items of rows committed by the step.
+             */
+            QList<QList<SqlQueryItem*>> rows;
+
+            /**
+             * @brief Queries to be executed by the commit worker.
+             */
+            SqlQueryModelCommitWorker::Step queries;
+
+            /**
+             * @brief Items to be marked with commit error if the statement (at the same index in queries) fails.
+             */
+            QList<QList<SqlQueryItem*>> errorItems;
+
+            /**
+             * @brief Message notified if any statement fails. Its lowest remaining place marker is replaced with the error from the database.
+             */
+            QString errorMessage;
+
+            /**
+             * @brief ROWID changes made by edited row, to be applied to all items of the row's table after the commit.
+             */
+            QList<RowIdChange> rowIdChanges;
+        };
+
+        /**
+         * @brief prepareAddedRowCommit Prepares insertion of new row to a table.
          * @param itemsInRow All cells for the new row.
-         * @return true on success, false on failure.
+         * @param step Step to fill with queries.
+         * @return true on success, false if the row cannot be committed.
          * Default implementation does nothing and returns false, because inserting for custom query results is not possible.
          * Inheriting class can reimplement this, so for example model specialized for single table can add rows.
-         * The method implementation should take items that are in model (and are passed to this method)
-         * and insert them into the actual database table. It also has to update items in the model,
-         * so they are no longer "new" and have the same data as inserted into the database.
+         * The implementation should put query inserting the row into the step. Items are updated later,
+         * with finishAddedRowCommit(), so they are no longer "new" and have the same data as inserted into the database.
          */
-        virtual bool commitAddedRow(const QList<SqlQueryItem*>& itemsInRow);
+        virtual bool prepareAddedRowCommit(const QList<SqlQueryItem*>& itemsInRow, CommitStep& step);
 
         /**
-         * @brief commitEditedRow Updates table row with new values.
+         * @brief finishAddedRowCommit Updates items of the row inserted by the commit.
+         * @param itemsInRow All cells for the new row.
+         * @param insertRowId ROWID of inserted row, if the step asked for it.
+         * It's called after the whole commit was successful. Default implementation does nothing.
+         */
+        virtual void finishAddedRowCommit(const QList<SqlQueryItem*>& itemsInRow, const RowId& insertRowId);
+
+        /**
+         * @brief prepareEditedRowCommit Prepares update of table row with new values.
          * @param itemsInRow Modified cell values.
-         * @return true on success, false on failure.
+         * @param step Step to fill with queries.
+         * @return true on success, false if the row cannot be committed.
          * Default implementation should be okay for most cases. It takes all modified cells and updates their
          * values in table basing on the ROWID, database, table and column names - which are all available,
          * unless the cell doesn't referr to the table, but in that case the cell should not be editable for user anyway.
          * <b>Important</b> thing to pay attention to is that the item list passed in arguments contains <b>only modified items</b>.
          */
-        virtual bool commitEditedRow(const QList<SqlQueryItem*>& itemsInRow);
+        virtual bool prepareEditedRowCommit(const QList<SqlQueryItem*>& itemsInRow, CommitStep& step);
 
         /**
-         * @brief commitDeletedRow Deletes row from the table.
-         * @param itemsInRow All cells for the deleted row.
-         * @return true on success, false on failure.
-         * Default implementation gets rid of row items from the model and that's all.
-         * Inheriting class can reimplement this, so for example model specialized for single table can delete rows.
-         * The method implementation should delete the row from the database.
+         * @brief prepareDeletedRowsCommit Prepares deletion of all rows marked for deletion.
+         * @param rows Cells of deleted rows, grouped by rows.
+         * @param steps List to append prepared steps to.
+         * @return true on success, false if rows cannot be committed.
+         * Default implementation prepares a single step without queries, so rows are just removed from the model.
+         * Inheriting class can reimplement this, so for example model specialized for single table can delete rows,
+         * many of them with a single query.
          */
-        virtual bool commitDeletedRow(const QList<SqlQueryItem*>& itemsInRow);
+        virtual bool prepareDeletedRowsCommit(const QList<QList<SqlQueryItem*>>& rows, QList<CommitStep>& steps);
 
         /**
          * @brief rollbackAddedRow
@@ -225,7 +346,7 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         SqlQueryModelColumnPtr getColumnModel(const QString& table, const QString& column);
         QList<SqlQueryModelColumnPtr> getTableColumnModels(const QString& database, const QString& table);
         QList<SqlQueryModelColumnPtr> getTableColumnModels(const QString& table);
-        void updateItem(SqlQueryItem* item, const QVariant& value, int columnIndex, const RowId& rowId);
+        void updateItem(SqlQueryItem* item, const QVariant& value, int columnIndex, const RowId& rowId) const;
         RowId getNewRowId(const RowId& currentRowId, const QList<SqlQueryItem*> items);
         void updateRowIdForAllItems(const AliasedTable& table, const RowId& rowId, const RowId& newRowId);
         QHash<QString, QVariantList> toValuesGroupedByColumns(const QList<SqlQueryItem*>& items);
@@ -265,14 +386,101 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         };
 
         /**
-         * @brief Loads data from queyr execution into UI cells.
+         * @brief Loads data from query execution into UI cells.
          * @param results Execution results from query executor.
-         * @return Whether to continue execution or not.
+         *
+         * Results are preloaded by the query executor in its thread, so rows are already decoded at this point.
+         * All rows of the page are inserted into the model at once, with a single rows insertion signal.
+         */
+        void loadData(SqlQueryPtr results);
+
+        /**
+         * @brief Puts rows fetched in continuous scrolling mode at the beginning or at the end of the model.
+         * @param rowList Fetched rows.
+         */
+        void insertFetchedRows(const SqlResultsRowBlock& rowList);
+
+        /**
+         * @brief Removes pages farthest from the recently fetched one, so only continuousScrollingPages are kept.
+         *
+         * Pages with uncommitted changes are never removed.
+         */
+        void evictDistantPages();
+
+        bool hasUncommittedItems(int firstRow, int rows) const;
+
+        /**
+         * @brief Loads full values of limited cells from the database.
+         * @param limitedItems Cells with limited values.
+         * @return Loaded values. Cells which values could not be loaded are not included.
+         */
+        QHash<SqlQueryItem*,QVariant> loadLimitedValues(const QList<SqlQueryItem*>& limitedItems);
+
+        /**
+         * @brief Loads full values of limited cells of a single table.
+         * @param items Cells of the same table, with the same ROWID columns.
+         * @param values Loaded values are put here.
+         */
+        void loadFullValuesForTable(const QList<SqlQueryItem*>& items, QHash<SqlQueryItem*,QVariant>& values);
+        static QString getRowIdKey(const QStringList& keyColumns, const RowId& rowId);
+        int getPageIndexForRow(int row) const;
+        void fetchPageIntoWindow(int newPage, bool prepend);
+
+        RowId getRowIdValue(SqlResultsRowPtr row, int columnIdx) const;
+
+        /**
+         * @brief Provides item for the cell, creating it from loaded row if necessary.
+         * @param row Row index.
+         * @param column Column index.
+         * @return Existing or created item, or null if there is no item and no loaded row for the cell.
+         *
+         * See loadedRows for details.
+         */
+        SqlQueryItem* materializeItem(int row, int column) const;
+
+        /**
+         * @brief Provides data of a cell that has no item created yet.
+         * @param row Loaded row.
+         * @param columnIdx Column index.
+         * @param role Data role.
+         * @return The same data as SqlQueryItem::data() would return for a cell just loaded from the database.
+         */
+        QVariant getLoadedCellData(SqlResultsRowPtr row, int columnIdx, int role) const;
+
+        /**
+         * @brief Provides search index for lookups in the given range of cells.
+         * @param start First cell of the range.
+         * @param end Last cell of the range.
+         * @return Index ready to use, or null if the range is too small for the index, or the index is not built yet.
+         *
+         * If the index is not built yet, building is started in a background thread, so it's ready for next lookups.
+         */
+        const SqlQueryModelSearchIndex* getSearchIndex(const QModelIndex& start, const QModelIndex& end) const;
+
+        /**
+         * @brief Provides cells to verify for lookups with the search index.
+         * @param cellIds Candidate cell ids from the search index.
+         * @param start First cell of the range.
+         * @param end Last cell of the range.
+         * @return Candidate cells from the range, together with cells changed since they were loaded, as (row, column) pairs in order.
+         */
+        QVector<QPair<int,int>> getSearchCandidates(const QVector<int>& cellIds, const QModelIndex& start, const QModelIndex& end) const;
+
+        void invalidateSearchIndex();
+
+        /**
+         * @brief Sorts rows already loaded into the model, instead of executing the query again with the new order.
+         * @param newSortOrder Order to sort with.
+         * @return true if sorting was started, or false if the query has to be executed again to sort the data.
+         *
+         * It's possible only if all results are loaded and there are no changes made to them in the model.
+         * Rows are sorted in a background thread and put into the model by handleLoadedRowsSorted().
          */
-        bool loadData(SqlQueryPtr results);
+        bool sortLoadedRows(const QueryExecutor::SortList& newSortOrder);
+        bool canSortLoadedRows() const;
 
-        QList<QStandardItem*> loadRow(SqlResultsRowPtr row);
-        RowId getRowIdValue(SqlResultsRowPtr row, int columnIdx);
+        Qt::Alignment getCellAlignment(const SqlQueryModelColumnPtr& column, const QVariant& value) const;
+        static bool isLimitedValue(const QVariant& value);
         void readColumns();
         void readColumnDetails();
         void updateColumnsHeader();
@@ -283,7 +491,10 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         QList<AliasedTable> getTablesForColumns();
         QList<bool> getColumnEditionEnabledList();
         QList<SqlQueryItem*> toItemList(const QModelIndexList& indexes) const;
-        bool commitRow(const QList<SqlQueryItem*>& itemsInRow);
+        bool prepareRowCommit(const QList<SqlQueryItem*>& itemsInRow, CommitStep& step);
+        void finishCommit(bool successful);
+        RowId getRowIdForCommit(const AliasedTable& table, const RowId& rowId);
+        static QByteArray getRowIdKey(const RowId& rowId);
         void rollbackRow(const QList<SqlQueryItem*>& itemsInRow);
         void storeStep1NumbersFromExecution();
         void storeStep2NumbersFromExecution();
@@ -300,6 +511,8 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         int getInsertRowIndex();
         void notifyItemEditionEnded(const QModelIndex& idx);
         int getRowsPerPage() const;
+        QueryExecutor::CountingMode getCountingMode() const;
+        void updateInexactTotalRows();
 
         QString query;
         bool explain = false;
@@ -351,6 +564,20 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          */
         int totalPages = -1;
 
+        /**
+         * @brief totalRowsAccuracy
+         * Tells if totalRowsReturned is exact, or it's an estimate or a lower bound
+         * (depending on the results counting mode configured).
+         */
+        QueryExecutor::RowCountAccuracy totalRowsAccuracy = QueryExecutor::RowCountAccuracy::EXACT;
+
+        /**
+         * @brief lastPageAfterCounting
+         * Set when user requested the last page while the total number of rows was not exact.
+         * Rows are counted exactly first and then the last page is loaded.
+         */
+        bool lastPageAfterCounting = false;
+
         /**
          * @brief page
          * The page variable keeps page of recently sucessfly loaded data.
@@ -365,6 +592,45 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          */
         QueryExecutor::SortList sortOrder;
 
+        /**
+         * @brief Kind of the data load that is in progress.
+         *
+         * Any load other than REPLACE comes from continuous scrolling and keeps rows that are already loaded.
+         */
+        enum class WindowFetch
+        {
+            REPLACE,
+            APPEND,
+            PREPEND
+        };
+
+        WindowFetch windowFetch = WindowFetch::REPLACE;
+
+        /**
+         * @brief firstLoadedPage
+         * Page of the first row in the model. It's different than the page only in continuous scrolling mode,
+         * where the page is the last of loaded pages.
+         */
+        int firstLoadedPage = 0;
+
+        /**
+         * @brief loadedPageRowCounts
+         * Number of model rows belonging to each of loaded pages, starting from the firstLoadedPage.
+         * It's updated when rows are added or deleted by the user, so the whole page can be removed from the model later.
+         */
+        QList<int> loadedPageRowCounts;
+
+        /**
+         * @brief moreRowsAfterLoadedPages
+         * Tells whether the last loaded page was full, so there might be more rows to fetch.
+         */
+        bool moreRowsAfterLoadedPages = false;
+
+        /**
+         * @brief Number of pages kept in the model in continuous scrolling mode.
+         */
+        static const int continuousScrollingPages = 3;
+
         QHash<Column,SqlQueryModelColumnPtr> columnMap;
         QHash<AliasedTable,QHash<QString,QString>> tableToRowIdColumn;
         QStringList headerColumns;
@@ -396,25 +662,102 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          */
         QList<bool> columnEditionStatus;
 
-        QList<int> rowsDeletedSuccessfullyInTheCommit;
+        /**
+         * @brief Tells whether commit is in progress, so nothing else reloads, commits or rolls back the model at the same time.
+         *
+         * Items of rows being committed are updated once the commit worker finishes, so they must stay in the model until then.
+         */
+        bool committing = false;
 
-        bool allDataLoaded = false;
+        /**
+         * @brief Steps of the commit in progress, in order of execution.
+         */
+        QList<CommitStep> commitSteps;
 
-        bool structureOutOfDate = false;
+        /**
+         * @brief Items which are committed by the commit in progress.
+         */
+        QList<SqlQueryItem*> commitItems;
+        SqlQueryModelCommitWorker* commitWorker = nullptr;
+        QFutureWatcher<bool>* commitWatcher = nullptr;
+
+        /**
+         * @brief ROWID of table rows changed by steps prepared so far, for each table.
+         *
+         * Keys are made of ROWID from before the commit (see getRowIdKey()), as that's what items still have, while steps are prepared.
+         */
+        QHash<AliasedTable,QHash<QByteArray,RowId>> commitRowIdChanges;
 
         /**
-         * @brief Set of existing model objects, updated for each construction and destruction.
+         * @brief Maximum number of arguments for a single query loading full values of cells.
+         *
+         * Older SQLite versions allow up to 999 arguments.
+         */
+        static const int fullValuesMaxArgs = 999;
+
+        /**
+         * @brief Rows loaded from the database, in order of model rows.
+         *
+         * Cells of loaded rows don't have SqlQueryItem objects created up front. Their data is provided
+         * by data() directly from the row. The item is created by materializeItem() only when it's requested
+         * by itemFromIndex() or when the cell is edited. It's the item that keeps the state of cell
+         * (uncommitted value, deleted row, etc).
          *
-         * This is used by loadData() to determinathe whether processEvents() caused deletion of the model.
-         * We need to keep processEvents() call so the UI is responsive to Interrupt button,
-         * but this causes crash when model is deleted in the events processing (like when FK combobox is deleted faster than data is loaded).
+         * For rows which were not loaded from the database (like new rows) there is a null pointer.
+         * The list is kept in sync with model rows by handleRowsInserted(), handleRowsRemoved() and handleModelReset().
          */
-        static QSet<SqlQueryModel*> existingModels;
+        QVector<SqlResultsRowPtr> loadedRows;
+
+        /**
+         * @brief Index of loaded values for fast lookups of cells.
+         *
+         * It's built in a background thread, on first lookup in a page of at least searchIndexMinCells cells.
+         * Any change to rows of the model invalidates it.
+         */
+        SqlQueryModelSearchIndexPtr searchIndex;
+
+        QFutureWatcher<SqlQueryModelSearchIndexPtr>* searchIndexWatcher = nullptr;
+
+        /**
+         * @brief Incremented when the search index is invalidated, so index built for outdated rows is discarded.
+         */
+        int searchIndexGeneration = 0;
+        mutable int searchIndexBuildGeneration = 0;
+
+        /**
+         * @brief Items with values changed after being loaded, so their values are not in the search index.
+         */
+        QSet<SqlQueryItem*> itemsChangedSinceLoading;
+
+        static const int searchIndexMinCells = 10000;
+
+        QFutureWatcher<SqlResultsRowBlock>* rowSortWatcher = nullptr;
+
+        /**
+         * @brief Sort order requested from sortLoadedRows(), applied once rows are sorted.
+         */
+        QueryExecutor::SortList pendingSortOrder;
+
+        /**
+         * @brief Value of searchIndexGeneration (which changes with any change of rows) when sorting was started.
+         */
+        int rowSortGeneration = 0;
+
+        bool allDataLoaded = false;
+
+        bool structureOutOfDate = false;
 
     private slots:
         void handleExecFinished(SqlQueryPtr results);
         void handleExecFailed(int code, QString errorMessage);
         void resultsCountingFinished(quint64 rowsAffected, quint64 rowsReturned, int totalPages);
+        void handleRowsInserted(const QModelIndex& parent, int first, int last);
+        void handleRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+        void handleRowsRemoved(const QModelIndex& parent, int first, int last);
+        void handleModelReset();
+        void handleSearchIndexBuilt();
+        void handleLoadedRowsSorted();
+        void handleCommitFinished();
 
     public slots:
         void itemValueEdited(SqlQueryItem* item);
@@ -426,11 +769,13 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         void lastPage();
         void executeQuery();
         void interrupt();
+        void cancelResultsCounting();
         void commit();
         void rollback();
         void commit(const QList<SqlQueryItem*>& items);
         void rollback(const QList<SqlQueryItem*>& items);
         void reload();
+        void fetchPreviousRows();
         void updateSelectiveCommitRollbackActions(const QItemSelection& selected, const QItemSelection& deselected);
         void addNewRow();
         void addMultipleRows();
@@ -481,6 +826,14 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          */
         void totalRowsAndPagesAvailable();
 
+        /**
+         * @brief rowsFetchedWhileScrolling
+         *
+         * Emitted instead of loadingEnded() after a page was fetched in continuous scrolling mode
+         * and added to rows already presented.
+         */
+        void rowsFetchedWhileScrolling();
+
         void storeExecutionInHistory();
 
         /**
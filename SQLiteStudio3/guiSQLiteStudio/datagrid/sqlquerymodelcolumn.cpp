@@ -171,6 +171,15 @@ SqlQueryModelColumn::ConstraintDefault* SqlQueryModelColumn::getDefaultConstrain
     return list[0];
 }
 
+SqlQueryModelColumn::ConstraintCollate* SqlQueryModelColumn::getCollateConstraint() const
+{
+    QList<ConstraintCollate*> list = getConstraints<ConstraintCollate*>();
+    if (list.size() == 0)
+        return nullptr;
+
+    return list[0];
+}
+
 int qHash(SqlQueryModelColumn::EditionForbiddenReason reason)
 {
     return static_cast<int>(reason);
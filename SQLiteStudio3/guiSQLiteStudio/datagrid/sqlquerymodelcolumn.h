@@ -151,6 +151,7 @@ class GUI_API_EXPORT SqlQueryModelColumn
         bool isCollate() const;
         QList<ConstraintFk*> getFkConstraints() const;
         ConstraintDefault* getDefaultConstraint() const;
+        ConstraintCollate* getCollateConstraint() const;
 
         QString displayName;
         QString column;
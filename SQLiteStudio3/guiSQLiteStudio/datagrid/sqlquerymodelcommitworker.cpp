@@ -0,0 +1,125 @@
+#include "sqlquerymodelcommitworker.h"
+#include "db/db.h"
+#include "services/notifymanager.h"
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+SqlQueryModelCommitWorker::SqlQueryModelCommitWorker(Db* db, const QList<Step>& steps) :
+    db(db), steps(steps)
+{
+    insertRowIds.resize(steps.size());
+}
+
+bool SqlQueryModelCommitWorker::run()
+{
+    if (!db->begin())
+    {
+        notifyError(tr("Could not begin transaction on the database. Details: %1").arg(db->getErrorText()));
+        return false;
+    }
+
+    // Steps of the same kind use the same query, so it's prepared once and executed with arguments of each step
+    QHash<QString,SqlQueryPtr> preparedQueries;
+    SqlQueryPtr query;
+    QElapsedTimer progressTimer;
+    progressTimer.start();
+    int rowsDone = 0;
+    for (int stepIdx = 0, total = steps.size(); stepIdx < total; stepIdx++)
+    {
+        if (isInterrupted())
+        {
+            rollback();
+            return false;
+        }
+
+        const Step& step = steps[stepIdx];
+        for (int i = 0, lgt = step.statements.size(); i < lgt; i++)
+        {
+            const Statement& statement = step.statements[i];
+            query = preparedQueries.value(statement.query);
+            if (!query)
+            {
+                if (preparedQueries.size() >= maxPreparedQueries)
+                    preparedQueries.clear();
+
+                query = db->prepare(statement.query);
+                preparedQueries[statement.query] = query;
+            }
+
+            if (statement.namedArgs.isEmpty())
+                query->setArgs(statement.args);
+            else
+                query->setArgs(statement.namedArgs);
+
+            if (!query->execute())
+            {
+                failedStep = stepIdx;
+                failedStatement = i;
+                errorText = query->getErrorText();
+                rollback();
+                return false;
+            }
+        }
+
+        if (step.readInsertRowId && query)
+            insertRowIds[stepIdx] = query->getInsertRowId();
+
+        rowsDone += step.rows;
+        if (progressTimer.elapsed() >= progressInterval)
+        {
+            progressTimer.restart();
+            emit rowsCommitted(rowsDone);
+        }
+    }
+
+    if (!db->commit())
+    {
+        notifyError(tr("An error occurred while committing the transaction: %1").arg(db->getErrorText()));
+        rollback();
+        return false;
+    }
+
+    emit rowsCommitted(rowsDone);
+    return true;
+}
+
+void SqlQueryModelCommitWorker::interrupt()
+{
+    QMutexLocker locker(&interruptMutex);
+    interrupted = true;
+}
+
+bool SqlQueryModelCommitWorker::isInterrupted()
+{
+    QMutexLocker locker(&interruptMutex);
+    return interrupted;
+}
+
+int SqlQueryModelCommitWorker::getFailedStep() const
+{
+    return failedStep;
+}
+
+int SqlQueryModelCommitWorker::getFailedStatement() const
+{
+    return failedStatement;
+}
+
+QString SqlQueryModelCommitWorker::getErrorText() const
+{
+    return errorText;
+}
+
+RowId SqlQueryModelCommitWorker::getInsertRowId(int step) const
+{
+    return insertRowIds.value(step);
+}
+
+void SqlQueryModelCommitWorker::rollback()
+{
+    if (!db->rollback())
+    {
+        // Nothing else we can do about it, but it should not happen.
+        notifyError(tr("An error occurred while rolling back the transaction: %1").arg(db->getErrorText()));
+    }
+}
@@ -0,0 +1,124 @@
+#ifndef SQLQUERYMODELCOMMITWORKER_H
+#define SQLQUERYMODELCOMMITWORKER_H
+
+#include "db/sqlquery.h"
+#include <QObject>
+#include <QMutex>
+#include <QVector>
+
+class Db;
+
+/**
+ * @brief Executes queries committing data changes of SqlQueryModel.
+ *
+ * Queries are prepared by the model from its items before the commit starts, so the worker doesn't touch the model
+ * and run() can be executed in a background thread. All queries are executed in a single transaction, which is
+ * rolled back if any query fails, or if the worker is interrupted.
+ */
+class SqlQueryModelCommitWorker : public QObject
+{
+        Q_OBJECT
+
+    public:
+        struct Statement
+        {
+            QString query;
+
+            /**
+             * @brief Positional arguments, used if there are no named arguments.
+             */
+            QList<QVariant> args;
+            QHash<QString,QVariant> namedArgs;
+        };
+
+        struct Step
+        {
+            QList<Statement> statements;
+
+            /**
+             * @brief Number of grid rows committed by the step, for progress reporting.
+             */
+            int rows = 1;
+
+            /**
+             * @brief Whether to keep ROWID of the row inserted by the last statement of the step.
+             */
+            bool readInsertRowId = false;
+        };
+
+        SqlQueryModelCommitWorker(Db* db, const QList<Step>& steps);
+
+        /**
+         * @brief Executes all steps in a transaction.
+         * @return true if all steps were executed and the transaction was committed, or false otherwise.
+         *
+         * Errors of beginning, committing or rolling back the transaction are notified here.
+         * Error of a step is left to the caller, which knows what the step was about. See getFailedStep().
+         */
+        bool run();
+
+        /**
+         * @brief Interrupts the commit. It's safe to call it from any thread.
+         */
+        void interrupt();
+
+        bool isInterrupted();
+
+        /**
+         * @brief Provides index of the step which failed.
+         * @return Index of the step, or -1 if none of steps failed.
+         */
+        int getFailedStep() const;
+
+        /**
+         * @brief Provides index of the statement which failed, within the failed step.
+         * @return Index of the statement, or -1 if none of steps failed.
+         */
+        int getFailedStatement() const;
+
+        /**
+         * @brief Provides error from the database for the failed step.
+         * @return Error text.
+         */
+        QString getErrorText() const;
+
+        /**
+         * @brief Provides ROWID of the row inserted by given step.
+         * @param step Index of the step.
+         * @return ROWID, or empty one if the step didn't ask for it.
+         */
+        RowId getInsertRowId(int step) const;
+
+    private:
+        void rollback();
+
+        Db* db = nullptr;
+        QList<Step> steps;
+        QVector<RowId> insertRowIds;
+        int failedStep = -1;
+        int failedStatement = -1;
+        QString errorText;
+        bool interrupted = false;
+        QMutex interruptMutex;
+
+        /**
+         * @brief Minimum interval between progress updates (in milliseconds).
+         */
+        static const int progressInterval = 100;
+
+        /**
+         * @brief Maximum number of prepared queries kept for reuse by following steps.
+         */
+        static const int maxPreparedQueries = 50;
+
+    signals:
+        /**
+         * @brief Reports progress of the commit.
+         * @param rows Number of rows committed so far.
+         *
+         * It's emitted from the thread executing run(), periodically, not after each step.
+         */
+        void rowsCommitted(int rows);
+};
+
+#endif // SQLQUERYMODELCOMMITWORKER_H
@@ -0,0 +1,158 @@
+#include "sqlquerymodelrowsorter.h"
+#include <QVector>
+#include <algorithm>
+#include <cstring>
+
+SqlResultsRowBlock SqlQueryModelRowSorter::sort(const SqlResultsRowBlock& rows, const QList<SortColumn>& sortColumns, int lengthLimit)
+{
+    // Keys are prepared once for each row, so values are not converted again for every comparison
+    int columnCount = sortColumns.size();
+    QVector<Key> keys(rows.size() * columnCount);
+    for (int row = 0; row < rows.size(); row++)
+    {
+        for (int i = 0; i < columnCount; i++)
+            keys[row * columnCount + i] = createKey(rows[row]->value(sortColumns[i].column), sortColumns[i].collation, lengthLimit);
+    }
+
+    QVector<int> order(rows.size());
+    for (int row = 0; row < rows.size(); row++)
+        order[row] = row;
+
+    bool undetermined = false;
+    std::stable_sort(order.begin(), order.end(), [&](int row1, int row2) -> bool
+    {
+        int res;
+        for (int i = 0; i < columnCount; i++)
+        {
+            res = compare(keys[row1 * columnCount + i], keys[row2 * columnCount + i], undetermined);
+            if (res != 0)
+                return sortColumns[i].descending ? (res > 0) : (res < 0);
+        }
+        return false;
+    });
+
+    if (undetermined)
+        return SqlResultsRowBlock();
+
+    SqlResultsRowBlock sortedRows;
+    sortedRows.reserve(rows.size());
+    for (int row : order)
+        sortedRows << rows[row];
+
+    return sortedRows;
+}
+
+SqlQueryModelRowSorter::Collation SqlQueryModelRowSorter::collationFromName(const QString& name, bool& ok)
+{
+    ok = true;
+    QString upperName = name.toUpper();
+    if (upperName.isEmpty() || upperName == "BINARY")
+        return Collation::BINARY;
+
+    if (upperName == "NOCASE")
+        return Collation::NOCASE;
+
+    if (upperName == "RTRIM")
+        return Collation::RTRIM;
+
+    ok = false;
+    return Collation::BINARY;
+}
+
+SqlQueryModelRowSorter::Key SqlQueryModelRowSorter::createKey(const QVariant& value, Collation collation, int lengthLimit)
+{
+    Key key;
+    if (value.isNull())
+        return key;
+
+    switch (value.type())
+    {
+        case QVariant::Int:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+        case QVariant::ULongLong:
+        case QVariant::Bool:
+            key.storageClass = 1;
+            key.isInteger = true;
+            key.integer = value.toLongLong();
+            key.real = value.toDouble();
+            return key;
+        case QVariant::Double:
+            key.storageClass = 1;
+            key.real = value.toDouble();
+            return key;
+        case QVariant::ByteArray:
+            key.storageClass = 3;
+            key.bytes = value.toByteArray();
+            key.limited = lengthLimit >= 0 && key.bytes.size() >= lengthLimit;
+            return key;
+        default:
+            break;
+    }
+
+    // Text is compared by its UTF-8 bytes, just like SQLite does
+    key.storageClass = 2;
+    key.bytes = value.toString().toUtf8();
+    key.limited = lengthLimit >= 0 && key.bytes.size() >= lengthLimit;
+    switch (collation)
+    {
+        case Collation::BINARY:
+            break;
+        case Collation::NOCASE:
+        {
+            // NOCASE folds only ASCII characters
+            for (char& c : key.bytes)
+            {
+                if (c >= 'A' && c <= 'Z')
+                    c = c - 'A' + 'a';
+            }
+            break;
+        }
+        case Collation::RTRIM:
+        {
+            // Spaces at the end of the limited value are followed by the rest of the value
+            if (key.limited)
+                break;
+
+            int size = key.bytes.size();
+            while (size > 0 && key.bytes[size - 1] == ' ')
+                size--;
+
+            key.bytes.truncate(size);
+            break;
+        }
+    }
+    return key;
+}
+
+int SqlQueryModelRowSorter::compare(const Key& key1, const Key& key2, bool& undetermined)
+{
+    if (key1.storageClass != key2.storageClass)
+        return key1.storageClass - key2.storageClass;
+
+    switch (key1.storageClass)
+    {
+        case 0:
+            return 0;
+        case 1:
+        {
+            if (key1.isInteger && key2.isInteger)
+                return (key1.integer < key2.integer) ? -1 : (key1.integer > key2.integer ? 1 : 0);
+
+            return (key1.real < key2.real) ? -1 : (key1.real > key2.real ? 1 : 0);
+        }
+        default:
+            break;
+    }
+
+    int minSize = qMin(key1.bytes.size(), key2.bytes.size());
+    int res = std::memcmp(key1.bytes.constData(), key2.bytes.constData(), minSize);
+    if (res == 0)
+    {
+        // One value is a prefix of the other. If the shorter one was limited, its full value continues past the loaded part.
+        res = key1.bytes.size() - key2.bytes.size();
+        if ((res <= 0 && key1.limited) || (res >= 0 && key2.limited))
+            undetermined = true;
+    }
+    return res;
+}
@@ -0,0 +1,69 @@
+#ifndef SQLQUERYMODELROWSORTER_H
+#define SQLQUERYMODELROWSORTER_H
+
+#include "db/sqlresultsrow.h"
+#include <QList>
+#include <QByteArray>
+
+/**
+ * @brief Sorts rows loaded into SqlQueryModel the way SQLite would sort them with ORDER BY.
+ *
+ * Values are ordered by their storage class first (NULL, then numbers, then text, then blobs).
+ * Numbers are compared by their value, text is compared with the collation of the column and blobs are compared byte by byte.
+ * Only built-in collations (BINARY, NOCASE and RTRIM) are supported.
+ *
+ * Values loaded into the model may be limited to the cell data length limit. If two limited values cannot be told apart
+ * by the part that was loaded, the order cannot be determined and sorting fails, so the database has to be asked for it.
+ */
+class SqlQueryModelRowSorter
+{
+    public:
+        enum class Collation
+        {
+            BINARY,
+            NOCASE,
+            RTRIM
+        };
+
+        struct SortColumn
+        {
+            int column = 0;
+            bool descending = false;
+            Collation collation = Collation::BINARY;
+        };
+
+        /**
+         * @brief Sorts rows by given columns.
+         * @param rows Rows to sort.
+         * @param sortColumns Columns to sort by, in order of importance.
+         * @param lengthLimit Cell data length limit, that values were loaded with. Negative value means there was no limit.
+         * @return Sorted rows, or empty block if the order could not be determined due to limited values.
+         *
+         * This method doesn't touch the model, so it's safe to call it from any thread.
+         */
+        static SqlResultsRowBlock sort(const SqlResultsRowBlock& rows, const QList<SortColumn>& sortColumns, int lengthLimit);
+
+        /**
+         * @brief Resolves collation by its name.
+         * @param name Name of the collation. Empty name stands for the default collation.
+         * @param ok Set to false if the collation is not one of built-in collations.
+         * @return Resolved collation.
+         */
+        static Collation collationFromName(const QString& name, bool& ok);
+
+    private:
+        struct Key
+        {
+            int storageClass = 0;
+            bool isInteger = false;
+            qint64 integer = 0;
+            double real = 0.0;
+            QByteArray bytes;
+            bool limited = false;
+        };
+
+        static Key createKey(const QVariant& value, Collation collation, int lengthLimit);
+        static int compare(const Key& key1, const Key& key2, bool& undetermined);
+};
+
+#endif // SQLQUERYMODELROWSORTER_H
@@ -0,0 +1,114 @@
+#include "sqlquerymodelsearchindex.h"
+#include "datagrid/sqlqueryitem.h"
+#include <algorithm>
+#include <iterator>
+
+QSharedPointer<SqlQueryModelSearchIndex> SqlQueryModelSearchIndex::build(const QVector<SqlResultsRowPtr>& rows, int columnCount)
+{
+    QSharedPointer<SqlQueryModelSearchIndex> index = QSharedPointer<SqlQueryModelSearchIndex>::create();
+    index->rowCount = rows.size();
+    index->columnCount = columnCount;
+    index->valuesByColumn.resize(columnCount);
+
+    QVariant value;
+    QString text;
+    int cellId;
+    for (int row = 0; row < rows.size(); row++)
+    {
+        const SqlResultsRowPtr& resultsRow = rows[row];
+        if (!resultsRow)
+            continue;
+
+        for (int col = 0; col < columnCount; col++)
+        {
+            value = resultsRow->value(col);
+            index->valuesByColumn[col][getValueKey(SqlQueryItem::adjustVariantType(value))] << row;
+
+            text = value.toString();
+            cellId = row * columnCount + col;
+            for (int pos = 0; pos + trigramLength <= text.length(); pos++)
+            {
+                // Postings are filled cell by cell, so checking the last one is enough to skip trigrams repeated in the cell
+                QVector<int>& cells = index->trigrams[getTrigram(text, pos)];
+                if (cells.isEmpty() || cells.last() != cellId)
+                    cells << cellId;
+            }
+        }
+    }
+
+    return index;
+}
+
+QVector<int> SqlQueryModelSearchIndex::findRows(int column, const QVariant& value) const
+{
+    if (column < 0 || column >= columnCount)
+        return QVector<int>();
+
+    return valuesByColumn[column].value(getValueKey(value));
+}
+
+QVector<int> SqlQueryModelSearchIndex::findCells(const QString& text) const
+{
+    if (text.length() < trigramLength)
+        return QVector<int>();
+
+    // Postings of all trigrams from the text are intersected, starting from the shortest one
+    QList<const QVector<int>*> postings;
+    for (int pos = 0; pos + trigramLength <= text.length(); pos++)
+    {
+        auto it = trigrams.constFind(getTrigram(text, pos));
+        if (it == trigrams.constEnd())
+            return QVector<int>();
+
+        postings << &(it.value());
+    }
+
+    std::sort(postings.begin(), postings.end(), [](const QVector<int>* a, const QVector<int>* b)
+    {
+        return a->size() < b->size();
+    });
+
+    QVector<int> results = *postings.first();
+    QVector<int> intersection;
+    for (int i = 1; i < postings.size() && !results.isEmpty(); i++)
+    {
+        intersection.clear();
+        std::set_intersection(results.constBegin(), results.constEnd(), postings[i]->constBegin(), postings[i]->constEnd(),
+                              std::back_inserter(intersection));
+        results.swap(intersection);
+    }
+
+    return results;
+}
+
+int SqlQueryModelSearchIndex::getRowCount() const
+{
+    return rowCount;
+}
+
+int SqlQueryModelSearchIndex::getColumnCount() const
+{
+    return columnCount;
+}
+
+QString SqlQueryModelSearchIndex::getValueKey(const QVariant& value)
+{
+    // Values equal for QVariant can differ in type (like 5 and "5.0"), so numbers are keyed by their numeric value.
+    // The key may put different values together, but candidates are verified by the model anyway.
+    if (value.isNull())
+        return QStringLiteral("N");
+
+    bool ok;
+    double number = value.toDouble(&ok);
+    if (ok)
+        return QStringLiteral("D") + QString::number(number, 'g', 17);
+
+    return QStringLiteral("V") + value.toString();
+}
+
+quint64 SqlQueryModelSearchIndex::getTrigram(const QString& str, int pos)
+{
+    return (quint64(str[pos].toLower().unicode()) << 32) |
+           (quint64(str[pos + 1].toLower().unicode()) << 16) |
+            quint64(str[pos + 2].toLower().unicode());
+}
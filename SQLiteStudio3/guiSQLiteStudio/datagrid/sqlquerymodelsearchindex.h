@@ -0,0 +1,72 @@
+#ifndef SQLQUERYMODELSEARCHINDEX_H
+#define SQLQUERYMODELSEARCHINDEX_H
+
+#include "db/sqlresultsrow.h"
+#include <QHash>
+#include <QVector>
+#include <QSharedPointer>
+
+/**
+ * @brief Index of values loaded into SqlQueryModel, for fast searching of cells.
+ *
+ * The index is built from rows loaded into the model (by build(), which is meant to be called in a background thread)
+ * and it contains a hash of values for each column (for exact lookups) and a trigram index of all cells (for substring lookups).
+ *
+ * Lookups provide candidates only. The index reflects values as they were loaded from database, so the caller
+ * needs to verify candidates against current cell values and check cells edited since the index was built on its own.
+ * Cells are identified by their "cell id", which is row * getColumnCount() + column.
+ */
+class SqlQueryModelSearchIndex
+{
+    public:
+        /**
+         * @brief Builds index for given rows.
+         * @param rows Rows loaded into the model.
+         * @param columnCount Number of columns in each row.
+         * @return Index ready for lookups.
+         *
+         * This method doesn't touch the model, so it's safe to call it from any thread.
+         */
+        static QSharedPointer<SqlQueryModelSearchIndex> build(const QVector<SqlResultsRowPtr>& rows, int columnCount);
+
+        /**
+         * @brief Finds rows that may have given value in given column.
+         * @param column Column index.
+         * @param value Value to look for.
+         * @return Candidate rows, in ascending order.
+         */
+        QVector<int> findRows(int column, const QVariant& value) const;
+
+        /**
+         * @brief Finds cells that may contain given text.
+         * @param text Text to look for. It has to be at least 3 characters long.
+         * @return Candidate cell ids, in ascending order. Case of characters is not respected by the index.
+         */
+        QVector<int> findCells(const QString& text) const;
+
+        int getRowCount() const;
+        int getColumnCount() const;
+
+        static const int trigramLength = 3;
+
+    private:
+        static QString getValueKey(const QVariant& value);
+        static quint64 getTrigram(const QString& str, int pos);
+
+        /**
+         * @brief Hash of values for each column, where values are mapped to rows having them.
+         */
+        QVector<QHash<QString,QVector<int>>> valuesByColumn;
+
+        /**
+         * @brief Trigrams (3 lower-case characters packed into a single number) mapped to cell ids containing them.
+         */
+        QHash<quint64,QVector<int>> trigrams;
+
+        int rowCount = 0;
+        int columnCount = 0;
+};
+
+typedef QSharedPointer<SqlQueryModelSearchIndex> SqlQueryModelSearchIndexPtr;
+
+#endif // SQLQUERYMODELSEARCHINDEX_H
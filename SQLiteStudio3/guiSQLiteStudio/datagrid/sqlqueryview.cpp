@@ -29,6 +29,7 @@
 #include <QMenu>
 #include <QMimeData>
 #include <QCryptographicHash>
+#include <QScrollBar>
 
 CFG_KEYS_DEFINE(SqlQueryView)
 
@@ -58,6 +59,7 @@ void SqlQueryView::init()
     connect(this, &QWidget::customContextMenuRequested, this, &SqlQueryView::customContextMenuRequested);
     connect(CFG_UI.Fonts.DataView, SIGNAL(changed(QVariant)), this, SLOT(updateFont()));
     connect(this, SIGNAL(activated(QModelIndex)), this, SLOT(itemActivated(QModelIndex)));
+    connect(verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(verticalScrollValueChanged(int)));
 
     horizontalHeader()->setSortIndicatorShown(false);
     horizontalHeader()->setSectionsClickable(true);
@@ -186,18 +188,24 @@ void SqlQueryView::setupHeaderMenu()
     headerContextMenu->addAction(actionMap[RESET_SORTING]);
 }
 
-QList<SqlQueryItem*> SqlQueryView::getSelectedItems()
+QModelIndexList SqlQueryView::getSelectedIndexes()
 {
-    QList<SqlQueryItem*> items;
     QModelIndexList idxList = selectionModel()->selectedIndexes();
     QModelIndex currIdx = getCurrentIndex();
     if (!idxList.contains(currIdx) && currIdx.isValid())
         idxList << currIdx;
 
+    qSort(idxList);
+    return idxList;
+}
+
+QList<SqlQueryItem*> SqlQueryView::getSelectedItems()
+{
+    QList<SqlQueryItem*> items;
+    QModelIndexList idxList = getSelectedIndexes();
     if (idxList.size() == 0)
         return items;
 
-    qSort(idxList);
     const SqlQueryModel* model = dynamic_cast<const SqlQueryModel*>(idxList.first().model());
     foreach (const QModelIndex& idx, idxList)
         items << model->itemFromIndex(idx);
@@ -324,7 +332,7 @@ void SqlQueryView::paste(const QList<QList<QVariant> >& data)
 
     SqlQueryItem* item = nullptr;
 
-    foreach (const QList<QVariant>& cells, data)
+    for (const QList<QVariant>& cells : data)
     {
         // Check if we're out of rows range
         if (rowIdx >= rowCount)
@@ -493,6 +501,29 @@ void SqlQueryView::executionEnded()
     widgetCover->hide();
 }
 
+void SqlQueryView::shiftVerticalScroll(int rows)
+{
+    // Scroll bar range is updated lazily, so it needs to be up to date before moving it
+    updateGeometries();
+
+    int delta = rows;
+    if (verticalScrollMode() == QAbstractItemView::ScrollPerPixel)
+        delta *= verticalHeader()->defaultSectionSize();
+
+    verticalScrollBar()->setValue(verticalScrollBar()->value() + delta);
+}
+
+void SqlQueryView::verticalScrollValueChanged(int value)
+{
+    // Scrolling to the bottom is handled by QAbstractItemView with SqlQueryModel::fetchMore()
+    SqlQueryModel* m = getModel();
+    if (!m || value > verticalScrollBar()->minimum())
+        return;
+
+    if (m->canFetchPreviousRows())
+        m->fetchPreviousRows();
+}
+
 void SqlQueryView::setCurrentRow(int row)
 {
     setCurrentIndex(model()->index(row, 0));
@@ -503,48 +534,69 @@ void SqlQueryView::copy()
     if (simpleBrowserMode)
         return;
 
-    QList<SqlQueryItem*> selectedItems = getSelectedItems();
-    QList<QList<SqlQueryItem*> > groupedItems = SqlQueryModel::groupItemsByRows(selectedItems);
+    // Values are read from the model by indexes, so no items are created for cells that don't have them yet.
+    // Only cells with limited values need items, to have their full values loaded (all at once).
+    QModelIndexList idxList = getSelectedIndexes();
+    SqlQueryModel* model = getModel();
+    QList<SqlQueryItem*> limitedItems;
+    for (const QModelIndex& idx : idxList)
+    {
+        if (idx.data(SqlQueryItem::DataRole::LIMITED_VALUE).toBool())
+            limitedItems << model->itemFromIndex(idx);
+    }
+    QHash<SqlQueryItem*,QVariant> fullValues = model->loadFullValues(limitedItems);
+
+    // Both, the text and the native format are serialized row by row, instead of collecting all the values first.
+    // The native format is QPair<QString,QList<QList<QVariant>>> (md5 of text and rows), but md5 is known at the end,
+    // so rows are serialized separately and the pair is put together at the end.
+    QString tsv;
+    QByteArray serializedRows;
+    QDataStream rowsStream(&serializedRows, QIODevice::WriteOnly);
+    QString rowSeparator = TsvSerializer::getRowSeparator();
+    quint32 rowCount = 0;
 
     QVariant itemValue;
     QStringList cells;
-    QList<QStringList> rows;
-
-    QPair<QString,QList<QList<QVariant>>> theDataPair;
-    QList<QList<QVariant>> theData;
     QList<QVariant> theDataRow;
-
-    foreach (const QList<SqlQueryItem*>& itemsInRows, groupedItems)
+    for (int i = 0, total = idxList.size(); i < total; i++)
     {
-        foreach (SqlQueryItem* item, itemsInRows)
-        {
-            itemValue = item->getFullValue();
-            if (itemValue.userType() == QVariant::Double)
-                cells << doubleToString(itemValue);
-            else
-                cells << itemValue.toString();
+        const QModelIndex& idx = idxList[i];
+        if (idx.data(SqlQueryItem::DataRole::LIMITED_VALUE).toBool())
+            itemValue = fullValues[model->itemFromIndex(idx)];
+        else
+            itemValue = idx.data(SqlQueryItem::DataRole::VALUE);
 
-            theDataRow << itemValue;
-        }
+        if (itemValue.userType() == QVariant::Double)
+            cells << doubleToString(itemValue);
+        else
+            cells << itemValue.toString();
+
+        theDataRow << itemValue;
+
+        // Row is complete if it's the last index, or the next one is in another row
+        if (i + 1 < total && idxList[i + 1].row() == idx.row())
+            continue;
+
+        if (rowCount > 0)
+            tsv += rowSeparator;
 
-        rows << cells;
+        tsv += TsvSerializer::serialize(cells);
         cells.clear();
 
-        theData << theDataRow;
+        rowsStream << theDataRow;
         theDataRow.clear();
+        rowCount++;
     }
 
     QMimeData* mimeData = new QMimeData();
-    QString tsv = TsvSerializer::serialize(rows);
     mimeData->setText(tsv);
 
     QString md5 = QCryptographicHash::hash(tsv.toUtf8(), QCryptographicHash::Md5);
-    theDataPair.first = md5;
-    theDataPair.second = theData;
 
     QByteArray serializedData;
     QDataStream stream(&serializedData, QIODevice::WriteOnly);
-    stream << theDataPair;
+    stream << md5 << rowCount;
+    stream.writeRawData(serializedRows.constData(), serializedRows.size());
     mimeData->setData(mimeDataId, serializedData);
 
     qApp->clipboard()->setMimeData(mimeData);
@@ -561,14 +613,17 @@ void SqlQueryView::paste()
         QString tsv = mimeData->text();
         QString md5 = QCryptographicHash::hash(tsv.toUtf8(), QCryptographicHash::Md5);
 
-        QPair<QString,QList<QList<QVariant>>> theDataPair;
+        // Data is QPair<QString,QList<QList<QVariant>>>, but rows are deserialized only if the md5 matches
+        QString dataMd5;
         QByteArray serializedData = mimeData->data(mimeDataId);
         QDataStream stream(&serializedData, QIODevice::ReadOnly);
-        stream >> theDataPair;
+        stream >> dataMd5;
 
-        if (md5 == theDataPair.first)
+        if (md5 == dataMd5)
         {
-            paste(theDataPair.second);
+            QList<QList<QVariant>> theData;
+            stream >> theData;
+            paste(theData);
             return;
         }
     }
@@ -577,9 +632,10 @@ void SqlQueryView::paste()
 
     QList<QVariant> dataRow;
     QList<QList<QVariant>> dataToPaste;
-    for (const QStringList& cells : deserializedRows)
+    dataToPaste.reserve(deserializedRows.size());
+    while (!deserializedRows.isEmpty())
     {
-        for (const QString& cell : cells)
+        for (const QString& cell : deserializedRows.takeFirst())
             dataRow << cell;
 
         dataToPaste << dataRow;
@@ -78,6 +78,14 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         bool getSimpleBrowserMode() const;
         void setSimpleBrowserMode(bool value);
 
+        /**
+         * @brief Scrolls the view vertically by given number of rows.
+         * @param rows Number of rows to scroll by. Negative values scroll up.
+         *
+         * Used by the model to keep the same rows visible after rows were inserted or removed above them.
+         */
+        void shiftVerticalScroll(int rows);
+
     private:
         void init();
         void setupWidgetCover();
@@ -87,6 +95,7 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         void setupActionsForMenu(SqlQueryItem* currentItem, const QList<SqlQueryItem*>& selectedItems);
         void setupHeaderMenu();
         bool editInEditorIfNecessary(SqlQueryItem* item);
+        QModelIndexList getSelectedIndexes();
         void paste(const QList<QList<QVariant>>& data);
         void addFkActionsToContextMenu(SqlQueryItem* currentItem);
         void goToReferencedRow(const QString& table, const QString& column, const QVariant& value);
@@ -116,6 +125,7 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         void generateInsert();
         void generateUpdate();
         void generateDelete();
+        void verticalScrollValueChanged(int value);
 
     public slots:
         void executionStarted();
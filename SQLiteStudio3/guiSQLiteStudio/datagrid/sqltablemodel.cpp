@@ -3,8 +3,10 @@
 #include "sqlqueryitem.h"
 #include "services/notifymanager.h"
 #include "uiconfig.h"
+#include "services/config.h"
 #include <QDebug>
 #include <QApplication>
+#include <QMessageBox>
 #include <schemaresolver.h>
 #include <querygenerator.h>
 
@@ -27,6 +29,7 @@ void SqlTableModel::setDatabaseAndTable(const QString& database, const QString&
 {
     this->database = database;
     this->table = table;
+    fullTextIndexDeclined = false;
     setQuery("SELECT * FROM "+getDataSource());
 
     QString dbName = database;
@@ -45,19 +48,19 @@ SqlQueryModel::Features SqlTableModel::features() const
     return INSERT_ROW|DELETE_ROW|FILTERING;
 }
 
-bool SqlTableModel::commitAddedRow(const QList<SqlQueryItem*>& itemsInRow)
+bool SqlTableModel::prepareAddedRowCommit(const QList<SqlQueryItem*>& itemsInRow, CommitStep& step)
 {
     QList<SqlQueryModelColumnPtr> modelColumns = getTableColumnModels(table);
     if (modelColumns.size() != itemsInRow.size())
     {
-        qCritical() << "Tried to SqlTableModel::commitAddedRow() with number of columns in argument different than model resolved for the table.";
+        qCritical() << "Tried to SqlTableModel::prepareAddedRowCommit() with number of columns in argument different than model resolved for the table.";
         return false;
     }
 
     // Check that just in case:
     if (modelColumns.size() == 0)
     {
-        qCritical() << "Tried to SqlTableModel::commitAddedRow() with number of resolved columns in the table equal to 0!";
+        qCritical() << "Tried to SqlTableModel::prepareAddedRowCommit() with number of resolved columns in the table equal to 0!";
         return false;
     }
 
@@ -68,20 +71,20 @@ bool SqlTableModel::commitAddedRow(const QList<SqlQueryItem*>& itemsInRow)
     updateColumnsAndValues(itemsInRow, modelColumns, colNameList, sqlValues, args);
 
     // Prepare SQL query
-    QString sql = getInsertSql(modelColumns, colNameList, sqlValues, args);
-
-    // Execute query
-    SqlQueryPtr result = db->exec(sql, args);
-
-    // Handle error
-    if (result->isError())
-    {
-        foreach (SqlQueryItem* item, itemsInRow)
-            item->setCommittingError(true);
+    SqlQueryModelCommitWorker::Statement statement;
+    statement.query = getInsertSql(modelColumns, colNameList, sqlValues, args);
+    statement.args = args;
+
+    step.queries.statements << statement;
+    step.queries.readInsertRowId = !isWithOutRowIdTable;
+    step.errorItems << itemsInRow;
+    step.errorMessage = tr("Error while committing new row: %1");
+    return true;
+}
 
-        notifyError(tr("Error while committing new row: %1").arg(result->getErrorText()));
-        return false;
-    }
+void SqlTableModel::finishAddedRowCommit(const QList<SqlQueryItem*>& itemsInRow, const RowId& insertRowId)
+{
+    QList<SqlQueryModelColumnPtr> modelColumns = getTableColumnModels(table);
 
     // Reloading row with actual values (because of DEFAULT, AUTOINCR)
     RowId rowId;
@@ -97,20 +100,59 @@ bool SqlTableModel::commitAddedRow(const QList<SqlQueryItem*>& itemsInRow)
         }
     }
     else
-        rowId = result->getInsertRowId();
+        rowId = insertRowId;
 
     updateRowAfterInsert(itemsInRow, modelColumns, rowId);
-    return true;
 }
 
-bool SqlTableModel::commitDeletedRow(const QList<SqlQueryItem*>& itemsInRow)
+bool SqlTableModel::prepareDeletedRowsCommit(const QList<QList<SqlQueryItem*>>& rows, QList<CommitStep>& steps)
 {
-    if (itemsInRow.size() == 0)
+    // Rows identified by a single value (ROWID, or single column PRIMARY KEY of WITHOUT ROWID table) are deleted in batches
+    CommitStep step;
+    QList<QList<SqlQueryItem*>> batch;
+    for (const QList<SqlQueryItem*>& itemsInRow : rows)
     {
-        qCritical() << "Tried to SqlTableModel::commitDeletedRow() with number of items equal to 0!";
-        return false;
+        if (itemsInRow.size() == 0)
+        {
+            qCritical() << "Tried to SqlTableModel::prepareDeletedRowsCommit() with number of items in a row equal to 0!";
+            return false;
+        }
+
+        if (itemsInRow[0]->getRowId().size() != 1)
+        {
+            step = CommitStep();
+            if (!prepareDeletedRowCommit(itemsInRow, step))
+                return false;
+
+            steps << step;
+            continue;
+        }
+
+        batch << itemsInRow;
+        if (batch.size() < deleteBatchSize)
+            continue;
+
+        step = CommitStep();
+        if (!prepareDeletedRowsBatchCommit(batch, step))
+            return false;
+
+        steps << step;
+        batch.clear();
+    }
+
+    if (batch.size() > 0)
+    {
+        step = CommitStep();
+        if (!prepareDeletedRowsBatchCommit(batch, step))
+            return false;
+
+        steps << step;
     }
+    return true;
+}
 
+bool SqlTableModel::prepareDeletedRowCommit(const QList<SqlQueryItem*>& itemsInRow, CommitStep& step)
+{
     // This should not happen anymore (since WITHOUT ROWID tables should be handled properly now,
     // but we will keep this here for a while, just in case.
 //    if (itemsInRow[0]->isJustInsertedWithOutRowId())
@@ -131,19 +173,45 @@ bool SqlTableModel::commitDeletedRow(const QList<SqlQueryItem*>& itemsInRow)
     queryBuilder.setTable(wrapObjIfNeeded(table, dialect));
     queryBuilder.setRowId(rowId);
 
-    QString sql = queryBuilder.build();
-    QHash<QString, QVariant> args = queryBuilder.getQueryArgs();
+    SqlQueryModelCommitWorker::Statement statement;
+    statement.query = queryBuilder.build();
+    statement.namedArgs = queryBuilder.getQueryArgs();
 
-    SqlQueryPtr result = db->exec(sql, args);
-    if (result->isError())
+    step.type = CommitStep::Type::DELETED_ROWS;
+    step.rows << itemsInRow;
+    step.queries.statements << statement;
+    step.errorMessage = tr("Error while deleting row from table %1: %2").arg(table);
+    return true;
+}
+
+bool SqlTableModel::prepareDeletedRowsBatchCommit(const QList<QList<SqlQueryItem*>>& rows, CommitStep& step)
+{
+    static_qstring(sqlTpl, "DELETE FROM %1 WHERE %2 IN (%3);");
+
+    QString keyColumn = rows.first()[0]->getRowId().keys().first();
+    QStringList argList;
+    SqlQueryModelCommitWorker::Statement statement;
+    for (const QList<SqlQueryItem*>& itemsInRow : rows)
     {
-        notifyError(tr("Error while deleting row from table %1: %2").arg(table).arg(result->getErrorText()));
-        return false;
+        RowId rowId = itemsInRow[0]->getRowId();
+        if (!rowId.contains(keyColumn))
+        {
+            qCritical() << "Inconsistent ROWID columns in rows passed to SqlTableModel::prepareDeletedRowsBatchCommit().";
+            return false;
+        }
+
+        argList << "?";
+        statement.args << rowId[keyColumn];
     }
 
-    if (!SqlQueryModel::commitDeletedRow(itemsInRow))
-        qCritical() << "Could not delete row from SqlQueryView while committing row deletion.";
+    // Batches of the same size use the same query, so its prepared statement is reused
+    statement.query = sqlTpl.arg(wrapObjIfNeeded(table, db->getDialect()), keyColumn, argList.join(", "));
 
+    step.type = CommitStep::Type::DELETED_ROWS;
+    step.rows = rows;
+    step.queries.statements << statement;
+    step.queries.rows = rows.size();
+    step.errorMessage = tr("Error while deleting row from table %1: %2").arg(table);
     return true;
 }
 
@@ -198,6 +266,30 @@ void SqlTableModel::applyRegExpFilter(const QString& value)
     executeQuery();
 }
 
+void SqlTableModel::applyFullTextFilter(const QString& value)
+{
+    if (value.isEmpty())
+    {
+        resetFilter();
+        return;
+    }
+
+    // Tables without ROWID cannot be indexed, as the index refers to rows by ROWID
+    if (value.length() < fullTextMinLength || isWithOutRowIdTable || db->getDialect() != Dialect::Sqlite3 || !ensureFullTextIndex())
+    {
+        applyStringFilter(value);
+        return;
+    }
+
+    static_qstring(sqlTpl, "SELECT * FROM %1 WHERE rowid IN (SELECT rowid FROM %2%3 WHERE %3 MATCH '%4')");
+
+    // Value is matched as a single phrase, so any FTS5 query syntax in it is treated as a plain text
+    QString phrase = "\"" + QString(value).replace("\"", "\"\"") + "\"";
+    QString ftsTable = wrapObjIfNeeded(getFullTextIndexName(), db->getDialect());
+    setQuery(sqlTpl.arg(getDataSource(), getDatabasePrefix(), ftsTable, escapeString(phrase)));
+    executeQuery();
+}
+
 void SqlTableModel::resetFilter()
 {
     setQuery("SELECT * FROM "+getDataSource());
@@ -324,10 +416,10 @@ void SqlTableModel::updateRowAfterInsert(const QList<SqlQueryItem*>& itemsInRow,
         {
             // Reading a row
             SqlResultsRowPtr row = defColValues->next();
-            if (row->valueList().size() != columnKeys.size())
+            if (row->valueVector().size() != columnKeys.size())
             {
                 qCritical() << "Could not load inserted values for DEFAULT expression in the table, so filling them with NULL. Number of columns from results was invalid:"
-                            << row->valueList().size() << ", while expected:" << columnKeys.size();
+                            << row->valueVector().size() << ", while expected:" << columnKeys.size();
 
                 for (const SqlQueryModelColumnPtr& modelColumn : columnKeys)
                     values[columnsToReadFromDb[modelColumn]] = QVariant();
@@ -367,6 +459,193 @@ QString SqlTableModel::getDataSource()
     return getDatabasePrefix() + wrapObjIfNeeded(table, db->getDialect());
 }
 
+QString SqlTableModel::getFullTextIndexName() const
+{
+    return table + "_sqlitestudio_fts";
+}
+
+bool SqlTableModel::ensureFullTextIndex()
+{
+    switch (getFullTextIndexState())
+    {
+        case FullTextIndexState::VALID:
+            return true;
+        case FullTextIndexState::UNKNOWN:
+            return false;
+        case FullTextIndexState::OUTDATED:
+        {
+            // User already agreed to have the index, it just doesn't match the table anymore
+            notifyInfo(tr("Full-text index of table %1 doesn't match columns of the table anymore. It will be created again.").arg(table));
+            return createFullTextIndex(true);
+        }
+        case FullTextIndexState::MISSING:
+            break;
+    }
+
+    if (fullTextIndexDeclined)
+        return false;
+
+    QMessageBox::StandardButton resp = QMessageBox::question(nullptr, tr("Full-text index"),
+            tr("Filtering with a full-text index requires the index to be created for the table '%1'. "
+               "The index is a virtual table '%2', kept up to date by triggers on the table '%1'. "
+               "It takes additional space in the database and makes modifications of the table slower.\n\n"
+               "Do you want to create the index? Otherwise the data will be filtered the regular way.")
+                    .arg(table, getFullTextIndexName()));
+
+    if (resp != QMessageBox::Yes)
+    {
+        fullTextIndexDeclined = true;
+        return false;
+    }
+
+    return createFullTextIndex(false);
+}
+
+SqlTableModel::FullTextIndexState SqlTableModel::getFullTextIndexState()
+{
+    static_qstring(objectsSqlTpl, "SELECT lower(name) FROM %1sqlite_master WHERE lower(name) IN (lower(?), lower(?), lower(?), lower(?))");
+    static_qstring(columnsSqlTpl, "PRAGMA %1table_info(%2)");
+
+    QStringList objectNames = QStringList({getFullTextIndexName()}) + getFullTextIndexTriggerNames();
+    SqlQueryPtr result = db->exec(objectsSqlTpl.arg(getDatabasePrefix()), {objectNames[0], objectNames[1], objectNames[2], objectNames[3]});
+    if (result->isError())
+    {
+        qWarning() << "Could not check if full-text index exists for table" << table << ":" << result->getErrorText();
+        return FullTextIndexState::UNKNOWN;
+    }
+
+    QStringList existingObjects = result->columnAsList<QString>(0);
+    if (existingObjects.isEmpty())
+        return FullTextIndexState::MISSING;
+
+    // Triggers are dropped together with the table when it's recreated by the table editor
+    if (existingObjects.size() < objectNames.size())
+        return FullTextIndexState::OUTDATED;
+
+    // Triggers and the index list columns of the table at the moment they were created, so any later change
+    // of table columns leaves some of them out of the index.
+    result = db->exec(columnsSqlTpl.arg(getDatabasePrefix(), wrapObjIfNeeded(getFullTextIndexName(), db->getDialect())));
+    if (result->isError())
+    {
+        qWarning() << "Could not read columns of full-text index for table" << table << ":" << result->getErrorText();
+        return FullTextIndexState::UNKNOWN;
+    }
+
+    QStringList indexColumns = result->columnAsList<QString>("name");
+    SchemaResolver resolver(db);
+    QStringList tableColumns = resolver.getTableColumns(database, table);
+    if (indexColumns.size() != tableColumns.size())
+        return FullTextIndexState::OUTDATED;
+
+    for (int i = 0; i < indexColumns.size(); i++)
+    {
+        if (indexColumns[i].compare(tableColumns[i], Qt::CaseInsensitive) != 0)
+            return FullTextIndexState::OUTDATED;
+    }
+
+    return FullTextIndexState::VALID;
+}
+
+bool SqlTableModel::createFullTextIndex(bool replaceExisting)
+{
+    static_qstring(dropTableSqlTpl, "DROP TABLE IF EXISTS %1%2;");
+    static_qstring(dropTrigSqlTpl, "DROP TRIGGER IF EXISTS %1%2;");
+    static_qstring(createSqlTpl, "CREATE VIRTUAL TABLE %1%2 USING fts5(%3, content='', tokenize='trigram');");
+    static_qstring(fillSqlTpl, "INSERT INTO %1%2 (rowid, %3) SELECT rowid, %3 FROM %4;");
+    static_qstring(insertTrigSqlTpl, "CREATE TRIGGER %1%2 AFTER INSERT ON %3 BEGIN "
+                                     "INSERT INTO %4 (rowid, %5) VALUES (new.rowid, %6); END;");
+    static_qstring(deleteTrigSqlTpl, "CREATE TRIGGER %1%2 AFTER DELETE ON %3 BEGIN "
+                                     "INSERT INTO %4 (%4, rowid, %5) VALUES ('delete', old.rowid, %6); END;");
+    static_qstring(updateTrigSqlTpl, "CREATE TRIGGER %1%2 AFTER UPDATE ON %3 BEGIN "
+                                     "INSERT INTO %4 (%4, rowid, %5) VALUES ('delete', old.rowid, %6); "
+                                     "INSERT INTO %4 (rowid, %5) VALUES (new.rowid, %7); END;");
+
+    Dialect dialect = db->getDialect();
+    SchemaResolver resolver(db);
+    QStringList columnNames = resolver.getTableColumns(database, table);
+    if (columnNames.isEmpty())
+    {
+        notifyError(tr("Could not create full-text index for table %1, because its columns could not be resolved.").arg(table));
+        return false;
+    }
+
+    QStringList wrappedColumns;
+    QStringList newValues;
+    QStringList oldValues;
+    for (const QString& colName : columnNames)
+    {
+        wrappedColumns << wrapObjIfNeeded(colName, dialect);
+        newValues << "new." + wrappedColumns.last();
+        oldValues << "old." + wrappedColumns.last();
+    }
+
+    // Contentless index keeps only the index itself, not a copy of the data. Triggers cannot refer to other databases,
+    // so the index and triggers are created in the database of the table and they refer to objects without the prefix.
+    QString prefix = getDatabasePrefix();
+    QString fts = wrapObjIfNeeded(getFullTextIndexName(), dialect);
+    QString wrappedTable = wrapObjIfNeeded(table, dialect);
+    QString cols = wrappedColumns.join(", ");
+    QStringList triggers;
+    for (const QString& trigName : getFullTextIndexTriggerNames())
+        triggers << wrapObjIfNeeded(trigName, dialect);
+
+    // Outdated index is replaced as a whole, as it's contentless and cannot be updated by columns
+    QStringList queries;
+    if (replaceExisting)
+    {
+        for (const QString& trig : triggers)
+            queries << dropTrigSqlTpl.arg(prefix, trig);
+
+        queries << dropTableSqlTpl.arg(prefix, fts);
+    }
+
+    queries << createSqlTpl.arg(prefix, fts, cols)
+            << fillSqlTpl.arg(prefix, fts, cols, getDataSource())
+            << insertTrigSqlTpl.arg(prefix, triggers[0], wrappedTable, fts, cols, newValues.join(", "))
+            << deleteTrigSqlTpl.arg(prefix, triggers[1], wrappedTable, fts, cols, oldValues.join(", "))
+            << updateTrigSqlTpl.arg(prefix, triggers[2], wrappedTable, fts, cols, oldValues.join(", "), newValues.join(", "));
+
+    if (!db->begin())
+    {
+        notifyError(tr("Cannot start transaction. Details: %1").arg(db->getErrorText()));
+        return false;
+    }
+
+    SqlQueryPtr result;
+    for (const QString& query : queries)
+    {
+        result = db->exec(query);
+        if (result->isError())
+        {
+            notifyError(tr("Could not create full-text index for table %1 (it requires SQLite with FTS5 and its trigram tokenizer): %2")
+                        .arg(table, result->getErrorText()));
+            db->rollback();
+            return false;
+        }
+    }
+
+    if (!db->commit())
+    {
+        notifyError(tr("Could not create full-text index for table %1: %2").arg(table, db->getErrorText()));
+        db->rollback();
+        return false;
+    }
+
+    CFG->addDdlHistory(queries.join("\n"), db->getName(), db->getPath());
+    if (replaceExisting)
+        NotifyManager::getInstance()->modified(db, database, getFullTextIndexName());
+    else
+        NotifyManager::getInstance()->createded(db, database, getFullTextIndexName());
+
+    return true;
+}
+
+QStringList SqlTableModel::getFullTextIndexTriggerNames() const
+{
+    QString name = getFullTextIndexName();
+    return {name + "_insert", name + "_delete", name + "_update"};
+}
+
 QString SqlTableModel::getInsertSql(const QList<SqlQueryModelColumnPtr>& modelColumns, QStringList& colNameList,
                                     QStringList& sqlValues, QList<QVariant>& args)
 {
@@ -18,6 +18,7 @@ class GUI_API_EXPORT SqlTableModel : public SqlQueryModel
         void applySqlFilter(const QString& value);
         void applyStringFilter(const QString& value);
         void applyRegExpFilter(const QString& value);
+        void applyFullTextFilter(const QString& value);
         void resetFilter();
         QString generateSelectQueryForItems(const QList<SqlQueryItem*>& items);
         QString generateInsertQueryForItems(const QList<SqlQueryItem*>& items);
@@ -26,10 +27,19 @@ class GUI_API_EXPORT SqlTableModel : public SqlQueryModel
         bool supportsModifyingQueriesInMenu() const;
 
     protected:
-        bool commitAddedRow(const QList<SqlQueryItem*>& itemsInRow);
-        bool commitDeletedRow(const QList<SqlQueryItem*>& itemsInRow);
+        bool prepareAddedRowCommit(const QList<SqlQueryItem*>& itemsInRow, CommitStep& step);
+        void finishAddedRowCommit(const QList<SqlQueryItem*>& itemsInRow, const RowId& insertRowId);
+        bool prepareDeletedRowsCommit(const QList<QList<SqlQueryItem*>>& rows, QList<CommitStep>& steps);
 
     private:
+        enum class FullTextIndexState
+        {
+            VALID,
+            MISSING,
+            OUTDATED, /**< Some of index objects are missing, or the index doesn't cover current columns of the table. */
+            UNKNOWN /**< State could not be checked. */
+        };
+
         class CommitDeleteQueryBuilder : public CommitUpdateQueryBuilder
         {
             public:
@@ -51,12 +61,38 @@ class GUI_API_EXPORT SqlTableModel : public SqlQueryModel
         QString getInsertSql(const QList<SqlQueryModelColumnPtr>& modelColumns, QStringList& colNameList, QStringList& sqlValues,
                              QList<QVariant>& args);
         void updateRowAfterInsert(const QList<SqlQueryItem*>& itemsInRow, const QList<SqlQueryModelColumnPtr>& modelColumns, RowId rowId);
+        bool prepareDeletedRowCommit(const QList<SqlQueryItem*>& itemsInRow, CommitStep& step);
+        bool prepareDeletedRowsBatchCommit(const QList<QList<SqlQueryItem*>>& rows, CommitStep& step);
         QString getDatabasePrefix();
         QString getDataSource();
+        QString getFullTextIndexName() const;
+        QStringList getFullTextIndexTriggerNames() const;
+        bool ensureFullTextIndex();
+        FullTextIndexState getFullTextIndexState();
+        bool createFullTextIndex(bool replaceExisting);
 
         QString table;
         QString database;
         bool isWithOutRowIdTable = false;
+
+        /**
+         * @brief Set when user refused to create full-text index for the table, so it's not asked again.
+         */
+        bool fullTextIndexDeclined = false;
+
+        /**
+         * @brief Minimum length of text matched by the full-text index.
+         *
+         * The index uses the trigram tokenizer, which cannot match shorter text.
+         */
+        static const int fullTextMinLength = 3;
+
+        /**
+         * @brief Maximum number of rows deleted with a single query.
+         *
+         * Each row takes one query argument and older SQLite versions allow up to 999 arguments.
+         */
+        static const int deleteBatchSize = 500;
 };
 
 #endif // SQLTABLEMODEL_H
@@ -73,6 +73,10 @@ void DataView::initSlots()
     connect(model, SIGNAL(executionStarted()), gridView, SLOT(executionStarted()));
     connect(model, SIGNAL(loadingEnded(bool)), gridView, SLOT(executionEnded()));
     connect(model, SIGNAL(totalRowsAndPagesAvailable()), this, SLOT(totalRowsAndPagesAvailable()));
+    connect(model, &SqlQueryModel::rowsFetchedWhileScrolling, [this]() {
+        updatePageEdit();
+        updateNavigationState();
+    });
     connect(gridView->horizontalHeader(), SIGNAL(sectionClicked(int)), this, SLOT(columnsHeaderClicked(int)));
     connect(this, SIGNAL(currentChanged(int)), this, SLOT(tabChanged(int)));
     connect(model, SIGNAL(itemEditionEnded(SqlQueryItem*)), this, SLOT(adjustColumnWidth(SqlQueryItem*)));
@@ -151,10 +155,11 @@ void DataView::initPageEdit()
 void DataView::initWidgetCover()
 {
     widgetCover = new WidgetCover(this);
-    widgetCover->initWithProgressBarOnly("%v / %m");
+    widgetCover->initWithInterruptContainer(tr("Cancel"));
+    connect(widgetCover, SIGNAL(cancelClicked()), model, SLOT(interrupt()));
     connect(model, SIGNAL(aboutToCommit(int)), this, SLOT(coverForGridCommit(int)));
     connect(model, SIGNAL(committingStepFinished(int)), this, SLOT(updateGridCommitCover(int)));
-    connect(model, SIGNAL(commitFinished()), this, SLOT(hideGridCommitCover()));
+    connect(model, SIGNAL(commitFinished()), this, SLOT(gridCommitFinished()));
 }
 
 void DataView::createActions()
@@ -193,12 +198,14 @@ void DataView::createActions()
         attachActionInMenu(FILTER, staticActions[FILTER_STRING], gridToolBar);
         attachActionInMenu(FILTER, staticActions[FILTER_REGEXP], gridToolBar);
         attachActionInMenu(FILTER, staticActions[FILTER_SQL], gridToolBar);
+        attachActionInMenu(FILTER, staticActions[FILTER_FULL_TEXT], gridToolBar);
         gridToolBar->addSeparator();
         updateFilterIcon();
 
         connect(staticActions[FILTER_STRING], SIGNAL(triggered()), this, SLOT(filterModeSelected()));
         connect(staticActions[FILTER_REGEXP], SIGNAL(triggered()), this, SLOT(filterModeSelected()));
         connect(staticActions[FILTER_SQL], SIGNAL(triggered()), this, SLOT(filterModeSelected()));
+        connect(staticActions[FILTER_FULL_TEXT], SIGNAL(triggered()), this, SLOT(filterModeSelected()));
     }
     actionMap[GRID_TOTAL_ROWS] = gridToolBar->addWidget(rowCountLabel);
 
@@ -284,11 +291,13 @@ void DataView::createStaticActions()
     staticActions[FILTER_STRING] = new ExtAction(ICONS.APPLY_FILTER_TXT, tr("Filter by text", "data view"), MainWindow::getInstance());
     staticActions[FILTER_REGEXP] = new ExtAction(ICONS.APPLY_FILTER_RE, tr("Filter by the Regular Expression", "data view"), MainWindow::getInstance());
     staticActions[FILTER_SQL] = new ExtAction(ICONS.APPLY_FILTER_SQL, tr("Filter by SQL expression", "data view"), MainWindow::getInstance());
+    staticActions[FILTER_FULL_TEXT] = new ExtAction(ICONS.INDEX, tr("Filter by text, using full-text index", "data view"), MainWindow::getInstance());
 
     staticActionGroups[ActionGroup::FILTER_MODE] = new QActionGroup(MainWindow::getInstance());
     staticActionGroups[ActionGroup::FILTER_MODE]->addAction(staticActions[FILTER_STRING]);
     staticActionGroups[ActionGroup::FILTER_MODE]->addAction(staticActions[FILTER_SQL]);
     staticActionGroups[ActionGroup::FILTER_MODE]->addAction(staticActions[FILTER_REGEXP]);
+    staticActionGroups[ActionGroup::FILTER_MODE]->addAction(staticActions[FILTER_FULL_TEXT]);
 
     connect(staticActions[FILTER_STRING], &QAction::triggered, [=]()
     {
@@ -302,14 +311,21 @@ void DataView::createStaticActions()
     {
         filterMode = FilterMode::REGEXP;
     });
+    connect(staticActions[FILTER_FULL_TEXT], &QAction::triggered, [=]()
+    {
+        filterMode = FilterMode::FULL_TEXT;
+    });
 
     staticActions[FILTER_STRING]->setCheckable(true);
     staticActions[FILTER_REGEXP]->setCheckable(true);
     staticActions[FILTER_SQL]->setCheckable(true);
+    staticActions[FILTER_FULL_TEXT]->setCheckable(true);
     if (filterMode == FilterMode::STRING)
         staticActions[FILTER_STRING]->setChecked(true);
     else if (filterMode == FilterMode::REGEXP)
         staticActions[FILTER_REGEXP]->setChecked(true);
+    else if (filterMode == FilterMode::FULL_TEXT)
+        staticActions[FILTER_FULL_TEXT]->setChecked(true);
     else
         staticActions[FILTER_SQL]->setChecked(true);
 
@@ -504,12 +520,15 @@ void DataView::filterModeSelected()
 
 void DataView::coverForGridCommit(int total)
 {
+    // Items stay in the model until the commit is finished, so they cannot be edited in the meantime
+    gridWidget->setEnabled(false);
+    formWidget->setEnabled(false);
+
     if (total <= 3)
         return;
 
-    widgetCover->displayProgress(total);
+    widgetCover->displayProgress(total, "%v / %m");
     widgetCover->show();
-    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
 }
 
 void DataView::updateGridCommitCover(int value)
@@ -518,16 +537,21 @@ void DataView::updateGridCommitCover(int value)
         return;
 
     widgetCover->setProgress(value);
-    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
 }
 
-void DataView::hideGridCommitCover()
+void DataView::gridCommitFinished()
 {
-    if (!widgetCover->isVisible())
-        return;
+    gridWidget->setEnabled(true);
+    formWidget->setEnabled(true);
+
+    if (widgetCover->isVisible())
+        widgetCover->hide();
 
-    widgetCover->hide();
-    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+    if (currentWidget() == formWidget)
+    {
+        formView->updateFromGrid();
+        updateCurrentFormViewRow();
+    }
 }
 
 void DataView::adjustColumnWidth(SqlQueryItem* item)
@@ -593,15 +617,32 @@ void DataView::updatePageEdit()
     updateCurrentFormViewRow();
 }
 
-void DataView::updateResultsCount(int resultsCount)
+void DataView::updateResultsCount(int resultsCount, QueryExecutor::RowCountAccuracy accuracy)
 {
     if (resultsCount >= 0)
     {
-        QString msg = QObject::tr("Total rows loaded: %1").arg(resultsCount);
+        QString msg;
+        QString toolTip;
+        switch (accuracy)
+        {
+            case QueryExecutor::RowCountAccuracy::EXACT:
+                msg = QObject::tr("Total rows loaded: %1").arg(resultsCount);
+                break;
+            case QueryExecutor::RowCountAccuracy::ESTIMATE:
+                msg = QObject::tr("Total rows loaded: ~%1").arg(resultsCount);
+                break;
+            case QueryExecutor::RowCountAccuracy::LOWER_BOUND:
+                msg = QObject::tr("Total rows loaded: at least %1").arg(resultsCount);
+                break;
+        }
+
+        if (accuracy != QueryExecutor::RowCountAccuracy::EXACT)
+            toolTip = tr("Total number of rows was not counted exactly.\nGoing to the last page will count all rows.");
+
         rowCountLabel->setText(msg);
         formViewRowCountLabel->setText(msg);
-        rowCountLabel->setToolTip(QString::null);
-        formViewRowCountLabel->setToolTip(QString::null);
+        rowCountLabel->setToolTip(toolTip);
+        formViewRowCountLabel->setToolTip(toolTip);
     }
     else
     {
@@ -640,7 +681,7 @@ void DataView::readData()
 
 void DataView::updateFilterIcon()
 {
-    for (Action act : {FILTER_STRING, FILTER_SQL, FILTER_REGEXP})
+    for (Action act : {FILTER_STRING, FILTER_SQL, FILTER_REGEXP, FILTER_FULL_TEXT})
     {
         if (staticActions[act]->isChecked())
         {
@@ -673,7 +714,7 @@ void DataView::executionSuccessful()
 
 void DataView::totalRowsAndPagesAvailable()
 {
-    updateResultsCount(model->getTotalRowsReturned());
+    updateResultsCount(model->getTotalRowsReturned(), model->getTotalRowsAccuracy());
     totalPagesAvailable = true;
     updatePageEdit();
     updateNavigationState();
@@ -790,6 +831,9 @@ void DataView::applyFilter()
         case DataView::FilterMode::REGEXP:
             model->applyRegExpFilter(value);
             break;
+        case DataView::FilterMode::FULL_TEXT:
+            model->applyFullTextFilter(value);
+            break;
     }
 }
 
@@ -3,6 +3,7 @@
 
 #include "common/extactioncontainer.h"
 #include "guiSQLiteStudio_global.h"
+#include "db/queryexecutor.h"
 #include <QTabWidget>
 #include <QMutex>
 
@@ -46,6 +47,7 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
             FILTER_STRING,
             FILTER_SQL,
             FILTER_REGEXP,
+            FILTER_FULL_TEXT,
             GRID_TOTAL_ROWS,
             SELECTIVE_COMMIT,
             SELECTIVE_ROLLBACK,
@@ -110,7 +112,8 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
         {
             STRING,
             SQL,
-            REGEXP
+            REGEXP,
+            FULL_TEXT
         };
 
         static void createStaticActions();
@@ -129,7 +132,7 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
         void updateGridNavigationState();
         void goToPage(const QString& pageStr);
         void updatePageEdit();
-        void updateResultsCount(int resultsCount);
+        void updateResultsCount(int resultsCount, QueryExecutor::RowCountAccuracy accuracy = QueryExecutor::RowCountAccuracy::EXACT);
         void updateCurrentFormViewRow();
         void setFormViewEnabled(bool enabled);
         void readData();
@@ -203,7 +206,7 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
         void filterModeSelected();
         void coverForGridCommit(int total);
         void updateGridCommitCover(int value);
-        void hideGridCommitCover();
+        void gridCommitFinished();
         void adjustColumnWidth(SqlQueryItem* item);
 };
 
@@ -497,6 +497,7 @@ void DbTreeModel::refreshSchema(Db* db, QStandardItem *item)
     // Now prepare to create new branch
     SchemaResolver resolver(db);
     resolver.setIgnoreSystemObjects(!CFG_UI.General.ShowSystemObjects.get());
+    resolver.setUseReader(true);
 
     // Collect all db objects and build the db branch
     bool sort = CFG_UI.General.SortObjects.get();
@@ -78,6 +78,8 @@ void ImportDialog::init()
     connect(IMPORT_MANAGER, SIGNAL(stateUpdateRequestFromPlugin(CfgEntry*,bool,bool)), this, SLOT(stateUpdateRequestFromPlugin(CfgEntry*,bool,bool)));
     connect(IMPORT_MANAGER, SIGNAL(importSuccessful()), this, SLOT(success()));
     connect(IMPORT_MANAGER, SIGNAL(importFinished()), this, SLOT(hideCoverWidget()));
+    connect(IMPORT_MANAGER, SIGNAL(importProgress(qint64,qint64)), this, SLOT(updateProgress(qint64,qint64)));
+    connect(IMPORT_MANAGER, SIGNAL(importThroughput(double,double)), this, SLOT(updateThroughput(double,double)));
 }
 
 void ImportDialog::initTablePage()
@@ -334,6 +336,64 @@ void ImportDialog::hideCoverWidget()
     widgetCover->hide();
 }
 
+void ImportDialog::updateProgress(qint64 bytesRead, qint64 totalBytes)
+{
+    progressBytesRead = bytesRead;
+    progressTotalBytes = totalBytes;
+    refreshProgress();
+}
+
+void ImportDialog::updateThroughput(double bytesPerSecond, double rowsPerSecond)
+{
+    // Progress is reported only when it changes by a whole permille, so the throughput cannot wait for it
+    readingThroughput = bytesPerSecond;
+    insertingThroughput = rowsPerSecond;
+    refreshProgress();
+}
+
+void ImportDialog::refreshProgress()
+{
+    QString format;
+    int permille = 0;
+    if (progressTotalBytes > 0)
+    {
+        permille = static_cast<int>(qMin(progressBytesRead, progressTotalBytes) * 1000 / progressTotalBytes);
+
+        // Estimation made at the very beginning would be far from the truth
+        qint64 elapsed = importTimer.elapsed();
+        format = "%p%";
+        if (progressBytesRead > 0 && elapsed >= 2000)
+        {
+            qint64 remainingSecs = qMax(qint64(1), elapsed * (progressTotalBytes - progressBytesRead) / progressBytesRead / 1000);
+            int remainingMsecs = static_cast<int>(qMin(remainingSecs, qint64(INT_MAX / 1000))) * 1000;
+            format = tr("%p% (about %1 left)", "import progress").arg(formatTimePeriod(remainingMsecs));
+        }
+    }
+
+    if (insertingThroughput >= 0.0)
+    {
+        if (!format.isEmpty())
+            format += " - ";
+
+        if (readingThroughput >= 0.0)
+        {
+            format += tr("reading: %1 MB/s, inserting: %2 rows/s", "import progress")
+                    .arg(QString::number(readingThroughput / 1024.0 / 1024.0, 'f', 1), QString::number(qRound64(insertingThroughput)));
+        }
+        else
+        {
+            format += tr("inserting: %1 rows/s", "import progress").arg(QString::number(qRound64(insertingThroughput)));
+        }
+    }
+
+    if (format.isEmpty())
+        return;
+
+    // Without known input size the bar stays busy, just with the throughput on it
+    widgetCover->displayProgress(progressTotalBytes > 0 ? 1000 : 0, format);
+    widgetCover->setProgress(permille);
+}
+
 void ImportDialog::accept()
 {
     if (!currentPlugin)
@@ -350,6 +410,8 @@ void ImportDialog::accept()
         stdConfig.codec = ui->codecCombo->currentText();
 
     stdConfig.ignoreErrors = ui->ignoreErrorsCheck->isChecked();
+    stdConfig.fastImport = ui->fastImportCheck->isChecked();
+    stdConfig.deferIndexes = ui->deferIndexesCheck->isChecked();
 
     Db* db = DBLIST->getByName(ui->dbNameCombo->currentText());;
     if (!db)
@@ -360,7 +422,13 @@ void ImportDialog::accept()
 
     QString table = ui->tableNameCombo->currentText();
 
+    widgetCover->noDisplayProgress();
     widgetCover->show();
+    importTimer.start();
+    readingThroughput = -1.0;
+    insertingThroughput = -1.0;
+    progressBytesRead = -1;
+    progressTotalBytes = -1;
     IMPORT_MANAGER->configure(currentPlugin->getDataSourceTypeName(), stdConfig);
     IMPORT_MANAGER->importToTable(db, table);
 }
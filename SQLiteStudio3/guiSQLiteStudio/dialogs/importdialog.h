@@ -3,6 +3,7 @@
 
 #include "guiSQLiteStudio_global.h"
 #include <QWizard>
+#include <QElapsedTimer>
 
 namespace Ui {
     class ImportDialog;
@@ -39,6 +40,7 @@ class GUI_API_EXPORT ImportDialog : public QWizard
         void updateStandardOptions();
         void updatePluginOptions(int& rows);
         bool isPluginConfigValid() const;
+        void refreshProgress();
 
         Ui::ImportDialog *ui = nullptr;
         DbListModel* dbListModel = nullptr;
@@ -48,6 +50,11 @@ class GUI_API_EXPORT ImportDialog : public QWizard
         ImportPlugin* currentPlugin = nullptr;
         QHash<CfgEntry*,bool> pluginConfigOk;
         WidgetCover* widgetCover = nullptr;
+        QElapsedTimer importTimer;
+        double readingThroughput = -1.0;
+        double insertingThroughput = -1.0;
+        qint64 progressBytesRead = -1;
+        qint64 progressTotalBytes = -1;
 
     private slots:
         void handleValidationResultFromPlugin(bool valid, CfgEntry* key, const QString& errorMsg);
@@ -59,6 +66,8 @@ class GUI_API_EXPORT ImportDialog : public QWizard
         void browseForInputFile();
         void success();
         void hideCoverWidget();
+        void updateProgress(qint64 bytesRead, qint64 totalBytes);
+        void updateThroughput(double bytesPerSecond, double rowsPerSecond);
 
     public slots:
         void accept();
@@ -137,6 +137,9 @@ SOURCES +=\
     windows/ddlhistorywindow.cpp \
     common/userinputfilter.cpp \
     datagrid/sqlqueryrownummodel.cpp \
+    datagrid/sqlquerymodelsearchindex.cpp \
+    datagrid/sqlquerymodelrowsorter.cpp \
+    datagrid/sqlquerymodelcommitworker.cpp \
     windows/functionseditor.cpp \
     windows/functionseditormodel.cpp \
     sqlitesyntaxhighlighter.cpp \
@@ -285,6 +288,9 @@ HEADERS  += mainwindow.h \
     windows/ddlhistorywindow.h \
     common/userinputfilter.h \
     datagrid/sqlqueryrownummodel.h \
+    datagrid/sqlquerymodelsearchindex.h \
+    datagrid/sqlquerymodelrowsorter.h \
+    datagrid/sqlquerymodelcommitworker.h \
     windows/functionseditor.h \
     windows/functionseditormodel.h \
     syntaxhighlighterplugin.h \
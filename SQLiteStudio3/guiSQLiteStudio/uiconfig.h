@@ -21,6 +21,12 @@ namespace Cfg
         AFTER_CURRENT,
         AT_THE_END
     };
+    enum ResultsCountingMode
+    {
+        COUNT_EXACT,
+        COUNT_ESTIMATED,
+        COUNT_LAZY
+    };
 }
 
 CFG_CATEGORIES(Ui,
@@ -103,6 +109,8 @@ CFG_CATEGORIES(Ui,
         CFG_ENTRY(bool,                  ShowDataViewTooltips,       true)
         CFG_ENTRY(bool,                  KeepNullWhenEmptyValue,     true)
         CFG_ENTRY(bool,                  UseDefaultValueForNull,     false)
+        CFG_ENTRY(int,                   ResultsCountingMode,        Cfg::COUNT_EXACT)
+        CFG_ENTRY(bool,                  ContinuousScrolling,        false)
     )
 )
 
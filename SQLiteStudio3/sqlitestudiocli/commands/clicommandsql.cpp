@@ -56,6 +56,9 @@ void CliCommandSql::execute()
                 printResultsClassic(executor, results);
                 break;
         }
+
+        if (results->isError())
+            executionFailed(results->getErrorCode(), results->getErrorText());
     });
 }
 
@@ -97,24 +100,30 @@ void CliCommandSql::printResultsClassic(QueryExecutor* executor, SqlQueryPtr res
     qOut << "\n";
 
     // Data
-    SqlResultsRowPtr row;
     QList<QVariant> values;
     int i;
     while (results->hasNext())
     {
-        row = results->next();
-        i = 0;
-        values = row->valueList().mid(0, resultColumnCount);
-        foreach (QVariant value, values)
+        // Block is empty only if reading rows failed. The error is reported by the caller.
+        const SqlResultsRowBlock& rows = results->nextBatch(rowBlockSize);
+        if (rows.isEmpty())
+            break;
+
+        for (const SqlResultsRowPtr& row : rows)
         {
-            qOut << getValueString(value);
-            if ((i + 1) < resultColumnCount)
-                qOut << "|";
+            i = 0;
+            values = row->valueList().mid(0, resultColumnCount);
+            foreach (QVariant value, values)
+            {
+                qOut << getValueString(value);
+                if ((i + 1) < resultColumnCount)
+                    qOut << "|";
 
-            i++;
-        }
+                i++;
+            }
 
-        qOut << "\n";
+            qOut << "\n";
+        }
     }
     qOut.flush();
 }
@@ -155,7 +164,15 @@ void CliCommandSql::printResultsFixed(QueryExecutor* executor, SqlQueryPtr resul
 
     // Data
     while (results->hasNext())
-        printColumnDataRow(widths, results->next(), resultColumnsCount);
+    {
+        // Block is empty only if reading rows failed. The error is reported by the caller.
+        const SqlResultsRowBlock& rows = results->nextBatch(rowBlockSize);
+        if (rows.isEmpty())
+            break;
+
+        for (const SqlResultsRowPtr& row : rows)
+            printColumnDataRow(widths, row, resultColumnsCount);
+    }
 
     qOut.flush();
 }
@@ -255,19 +272,25 @@ void CliCommandSql::printResultsRowByRow(QueryExecutor* executor, SqlQueryPtr re
     QString rowCntString;
     int i;
     int rowCnt = 1;
-    SqlResultsRowPtr row;
     while (results->hasNext())
     {
-        row = results->next();
-        i = 0;
-        rowCntString = " " + rowCntTemplate.arg(rowCnt) + " ";
-        qOut << center(rowCntString, termWidth - 1, '-') << "\n";
-        foreach (QVariant value, row->valueList().mid(0, resultColumnCount))
+        // Block is empty only if reading rows failed. The error is reported by the caller.
+        const SqlResultsRowBlock& rows = results->nextBatch(rowBlockSize);
+        if (rows.isEmpty())
+            break;
+
+        for (const SqlResultsRowPtr& row : rows)
         {
-            qOut << columns[i] + ": " + getValueString(value) << "\n";
-            i++;
+            i = 0;
+            rowCntString = " " + rowCntTemplate.arg(rowCnt) + " ";
+            qOut << center(rowCntString, termWidth - 1, '-') << "\n";
+            foreach (QVariant value, row->valueVector().mid(0, resultColumnCount))
+            {
+                qOut << columns[i] + ": " + getValueString(value) << "\n";
+                i++;
+            }
+            rowCnt++;
         }
-        rowCnt++;
     }
     qOut.flush();
 }
@@ -380,7 +403,7 @@ void CliCommandSql::printColumnDataRow(const QList<int>& widths, const SqlResult
 {
     int i = 0;
     QStringList line;
-    foreach (const QVariant& value, row->valueList().mid(0, resultColumnCount))
+    foreach (const QVariant& value, row->valueVector().mid(0, resultColumnCount))
     {
         line << pad(getValueString(value).left(widths[i]), widths[i], ' ');
         i++;
@@ -59,6 +59,11 @@ class CliCommandSql : public CliCommand
 
         QString getValueString(const QVariant& value);
 
+        /**
+         * @brief Number of result rows read at once while printing.
+         */
+        static const int rowBlockSize = 1000;
+
     private slots:
         void executionFailed(int code, const QString& msg);
 };